@@ -0,0 +1,403 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <chrono>
+#include <vector>
+#include <random>
+
+#include "SimplexNoise.hpp"
+
+using namespace std;
+
+
+
+// Microbenchmarks of the noise entry points; the results are written to stdout as csv:
+//   build,cpu,float,benchmark,dimensions,pattern,samples,passes,ns_per_sample,samples_per_second
+// Each benchmark is run in passes over the same samples until the time limit is reached, and the fastest pass is reported.
+enum class Function {
+	Noise1,
+	Noise1Derivative,
+	Noise1Octaves,
+	Noise1OctavesDerivative,
+	Noise1Batch,
+	Noise2,
+	Noise2Derivative,
+	Noise2Octaves,
+	Noise2OctavesDerivative,
+	Noise2Batch,
+	Noise2GradientBatch,
+	FillGrid2,
+	Noise2PeriodicBatch,
+	Noise2ChunkBatch,
+	Noise3,
+	Noise3Derivative,
+	Noise3Octaves,
+	Noise3OctavesDerivative,
+	Noise3Batch,
+	Noise3GradientBatch,
+	Curl3,
+	Curl3Batch,
+	FillGrid3,
+	Noise3PeriodicBatch,
+	Noise3ChunkBatch,
+	Noise4,
+	Noise4Derivative,
+	Noise4Octaves,
+	Noise4OctavesDerivative,
+	Noise4Batch,
+	Noise4GradientBatch,
+	FillGrid4,
+	Noise4ChunkBatch,
+	NoiseN,
+};
+
+struct Benchmark {
+	const char* name;
+	Function function;
+	int dimensions;
+	bool coherentOnly; // The grid functions only have a coherent access pattern
+};
+
+static const Benchmark benchmarks[] = {
+	{ "noise1", Function::Noise1, 1, false },
+	{ "noise1_derivative", Function::Noise1Derivative, 1, false },
+	{ "noise1_octaves", Function::Noise1Octaves, 1, false },
+	{ "noise1_octaves_derivative", Function::Noise1OctavesDerivative, 1, false },
+	{ "noise1_batch", Function::Noise1Batch, 1, false },
+	{ "noise2", Function::Noise2, 2, false },
+	{ "noise2_derivative", Function::Noise2Derivative, 2, false },
+	{ "noise2_octaves", Function::Noise2Octaves, 2, false },
+	{ "noise2_octaves_derivative", Function::Noise2OctavesDerivative, 2, false },
+	{ "noise2_batch", Function::Noise2Batch, 2, false },
+	{ "noise2_gradient_batch", Function::Noise2GradientBatch, 2, false },
+	{ "fill_grid2", Function::FillGrid2, 2, true },
+	{ "noise2_periodic_batch", Function::Noise2PeriodicBatch, 2, false },
+	{ "noise2_chunk_batch", Function::Noise2ChunkBatch, 2, false },
+	{ "noise3", Function::Noise3, 3, false },
+	{ "noise3_derivative", Function::Noise3Derivative, 3, false },
+	{ "noise3_octaves", Function::Noise3Octaves, 3, false },
+	{ "noise3_octaves_derivative", Function::Noise3OctavesDerivative, 3, false },
+	{ "noise3_batch", Function::Noise3Batch, 3, false },
+	{ "noise3_gradient_batch", Function::Noise3GradientBatch, 3, false },
+	{ "curl3", Function::Curl3, 3, false },
+	{ "curl3_batch", Function::Curl3Batch, 3, false },
+	{ "fill_grid3", Function::FillGrid3, 3, true },
+	{ "noise3_periodic_batch", Function::Noise3PeriodicBatch, 3, false },
+	{ "noise3_chunk_batch", Function::Noise3ChunkBatch, 3, false },
+	{ "noise4", Function::Noise4, 4, false },
+	{ "noise4_derivative", Function::Noise4Derivative, 4, false },
+	{ "noise4_octaves", Function::Noise4Octaves, 4, false },
+	{ "noise4_octaves_derivative", Function::Noise4OctavesDerivative, 4, false },
+	{ "noise4_batch", Function::Noise4Batch, 4, false },
+	{ "noise4_gradient_batch", Function::Noise4GradientBatch, 4, false },
+	{ "fill_grid4", Function::FillGrid4, 4, true },
+	{ "noise4_chunk_batch", Function::Noise4ChunkBatch, 4, false },
+	{ "noise_n", Function::NoiseN, 2, false },
+	{ "noise_n", Function::NoiseN, 3, false },
+	{ "noise_n", Function::NoiseN, 4, false },
+	{ "noise_n", Function::NoiseN, 5, false },
+	{ "noise_n", Function::NoiseN, 6, false },
+	{ "noise_n", Function::NoiseN, 7, false },
+	{ "noise_n", Function::NoiseN, 8, false },
+};
+
+static const size_t sampleCount = 16384;
+static const size_t gridWidth = 128;
+static const unsigned int octaves = 4;
+static const int maxDimensions = 8;
+static const double randomRange = 256.0;
+static const double coherentStep = 1.0 / 32.0;
+static const double maxRadius = 0.6;
+static const double power = 4.0;
+static const int32_t period = 64;
+static const int64_t chunkOrigin = (INT64_C(1) << 40) + 12345;
+
+#if defined(NDEBUG) && defined(SIMPLEX_NOISE_FAST_MATH)
+static const char* const buildName = "fast_math";
+#elif defined(NDEBUG)
+static const char* const buildName = "default";
+#else
+static const char* const buildName = "debug";
+#endif
+
+// Results are accumulated here so that the calls can't be optimized away
+static volatile double sink = 0.0;
+
+
+
+// Samples and output buffers for one float type and access pattern
+template <typename Float>
+struct BenchmarkData {
+	vector<Float> coordinates[maxDimensions]; // Per dimension
+	vector<Float> positions; // Interleaved, for noise_n
+	vector<Float> out;
+	Float x0, y0, z, w; // Grid origin
+};
+
+template <typename Float>
+static void
+generateSamples(
+	BenchmarkData<Float>& data,
+	bool coherent,
+	uint64_t seed
+) {
+	mt19937_64 random(seed);
+	uniform_real_distribution<double> distribution(-randomRange, randomRange);
+	size_t i;
+	int k;
+
+	data.positions.resize(sampleCount * maxDimensions);
+	data.out.resize(sampleCount * 5);
+
+	for (k = 0; k < maxDimensions; ++k) {
+		data.coordinates[k].resize(sampleCount);
+		for (i = 0; i < sampleCount; ++i) {
+			if (coherent) {
+				// Rows of a grid, with the remaining coordinates changing slowly
+				if (k == 0) data.coordinates[k][i] = static_cast<Float>((i % gridWidth) * coherentStep);
+				else if (k == 1) data.coordinates[k][i] = static_cast<Float>((i / gridWidth) * coherentStep);
+				else data.coordinates[k][i] = static_cast<Float>((i / gridWidth) * coherentStep * 0.25 + k);
+			}
+			else {
+				data.coordinates[k][i] = static_cast<Float>(distribution(random));
+			}
+			data.positions[i * maxDimensions + k] = data.coordinates[k][i];
+		}
+	}
+
+	data.x0 = data.coordinates[0][0];
+	data.y0 = data.coordinates[1][0];
+	data.z = data.coordinates[2][0];
+	data.w = data.coordinates[3][0];
+}
+
+// One pass over all samples
+template <typename Float>
+static void
+runPass(
+	SimplexNoise<Float>& generator,
+	const SimplexNoisePower<Float>& noisePower,
+	const Benchmark& benchmark,
+	BenchmarkData<Float>& data
+) {
+	const Float* x = data.coordinates[0].data();
+	const Float* y = data.coordinates[1].data();
+	const Float* z = data.coordinates[2].data();
+	const Float* w = data.coordinates[3].data();
+	Float* out = data.out.data();
+	const Float step = static_cast<Float>(coherentStep);
+	const Float radius = static_cast<Float>(maxRadius);
+	Float sum = 0;
+	Float d[4];
+	size_t i;
+
+	switch (benchmark.function) {
+		case Function::Noise1:
+			for (i = 0; i < sampleCount; ++i) sum += generator.noise1(x[i]);
+		break;
+		case Function::Noise1Derivative:
+			for (i = 0; i < sampleCount; ++i) sum += generator.noise1(x[i], &d[0]) + d[0];
+		break;
+		case Function::Noise1Octaves:
+			for (i = 0; i < sampleCount; ++i) sum += generator.noise1_octaves(octaves, x[i]);
+		break;
+		case Function::Noise1OctavesDerivative:
+			for (i = 0; i < sampleCount; ++i) sum += generator.noise1_octaves(octaves, x[i], &d[0]) + d[0];
+		break;
+		case Function::Noise1Batch:
+			generator.noise1_batch(sampleCount, x, out);
+		break;
+		case Function::Noise2:
+			for (i = 0; i < sampleCount; ++i) sum += generator.noise2(x[i], y[i]);
+		break;
+		case Function::Noise2Derivative:
+			for (i = 0; i < sampleCount; ++i) sum += generator.noise2(x[i], y[i], &d[0], &d[1]) + d[0] + d[1];
+		break;
+		case Function::Noise2Octaves:
+			for (i = 0; i < sampleCount; ++i) sum += generator.noise2_octaves(octaves, x[i], y[i]);
+		break;
+		case Function::Noise2OctavesDerivative:
+			for (i = 0; i < sampleCount; ++i) sum += generator.noise2_octaves(octaves, x[i], y[i], &d[0], &d[1]) + d[0] + d[1];
+		break;
+		case Function::Noise2Batch:
+			generator.noise2_batch(sampleCount, x, y, out);
+		break;
+		case Function::Noise2GradientBatch:
+			generator.noise2_gradient_batch(sampleCount, x, y, out, 3, 1);
+		break;
+		case Function::FillGrid2:
+			generator.fill_grid2(data.x0, data.y0, step, step, gridWidth, sampleCount / gridWidth, out, gridWidth);
+		break;
+		case Function::Noise2PeriodicBatch:
+			generator.noise2_periodic_batch(sampleCount, x, y, period, period, out);
+		break;
+		case Function::Noise2ChunkBatch:
+			generator.noise2_chunk_batch(chunkOrigin, -chunkOrigin, sampleCount, x, y, out);
+		break;
+		case Function::Noise3:
+			for (i = 0; i < sampleCount; ++i) sum += generator.noise3(x[i], y[i], z[i]);
+		break;
+		case Function::Noise3Derivative:
+			for (i = 0; i < sampleCount; ++i) sum += generator.noise3(x[i], y[i], z[i], &d[0], &d[1], &d[2]) + d[0] + d[1] + d[2];
+		break;
+		case Function::Noise3Octaves:
+			for (i = 0; i < sampleCount; ++i) sum += generator.noise3_octaves(octaves, x[i], y[i], z[i]);
+		break;
+		case Function::Noise3OctavesDerivative:
+			for (i = 0; i < sampleCount; ++i) sum += generator.noise3_octaves(octaves, x[i], y[i], z[i], &d[0], &d[1], &d[2]) + d[0] + d[1] + d[2];
+		break;
+		case Function::Noise3Batch:
+			generator.noise3_batch(sampleCount, x, y, z, out);
+		break;
+		case Function::Noise3GradientBatch:
+			generator.noise3_gradient_batch(sampleCount, x, y, z, out, 4, 1);
+		break;
+		case Function::Curl3:
+			for (i = 0; i < sampleCount; ++i) {
+				generator.curl3(x[i], y[i], z[i], &d[0], &d[1], &d[2]);
+				sum += d[0] + d[1] + d[2];
+			}
+		break;
+		case Function::Curl3Batch:
+			generator.curl3_batch(sampleCount, x, y, z, out, 3, 1);
+		break;
+		case Function::FillGrid3:
+			generator.fill_grid3(data.x0, data.y0, data.z, step, step, gridWidth, sampleCount / gridWidth, out, gridWidth);
+		break;
+		case Function::Noise3PeriodicBatch:
+			generator.noise3_periodic_batch(sampleCount, x, y, z, period, period, period, out);
+		break;
+		case Function::Noise3ChunkBatch:
+			generator.noise3_chunk_batch(chunkOrigin, -chunkOrigin, chunkOrigin, sampleCount, x, y, z, out);
+		break;
+		case Function::Noise4:
+			for (i = 0; i < sampleCount; ++i) sum += generator.noise4(x[i], y[i], z[i], w[i]);
+		break;
+		case Function::Noise4Derivative:
+			for (i = 0; i < sampleCount; ++i) sum += generator.noise4(x[i], y[i], z[i], w[i], &d[0], &d[1], &d[2], &d[3]) + d[0] + d[1] + d[2] + d[3];
+		break;
+		case Function::Noise4Octaves:
+			for (i = 0; i < sampleCount; ++i) sum += generator.noise4_octaves(octaves, x[i], y[i], z[i], w[i]);
+		break;
+		case Function::Noise4OctavesDerivative:
+			for (i = 0; i < sampleCount; ++i) sum += generator.noise4_octaves(octaves, x[i], y[i], z[i], w[i], &d[0], &d[1], &d[2], &d[3]) + d[0] + d[1] + d[2] + d[3];
+		break;
+		case Function::Noise4Batch:
+			generator.noise4_batch(sampleCount, x, y, z, w, out);
+		break;
+		case Function::Noise4GradientBatch:
+			generator.noise4_gradient_batch(sampleCount, x, y, z, w, out, 5, 1);
+		break;
+		case Function::FillGrid4:
+			generator.fill_grid4(data.x0, data.y0, data.z, data.w, step, step, gridWidth, sampleCount / gridWidth, out, gridWidth);
+		break;
+		case Function::Noise4ChunkBatch:
+			generator.noise4_chunk_batch(chunkOrigin, -chunkOrigin, chunkOrigin, -chunkOrigin, sampleCount, x, y, z, w, out);
+		break;
+		case Function::NoiseN:
+			for (i = 0; i < sampleCount; ++i) {
+				sum += generator.noise_n(radius, noisePower, benchmark.dimensions, &data.positions[i * maxDimensions]);
+			}
+		break;
+	}
+
+	sink = sink + sum + out[0];
+}
+
+template <typename Float>
+static void
+runBenchmarks(
+	const char* floatName,
+	const char* cpuName,
+	double minimumSeconds,
+	const char* filter
+) {
+	typedef chrono::steady_clock Clock;
+
+	SimplexNoise<Float> generator;
+	SimplexNoisePower<Float> noisePower(static_cast<Float>(power));
+	BenchmarkData<Float> data[2];
+	const char* patternNames[2] = { "random", "coherent" };
+	Clock::time_point start, passStart, now;
+	double best, elapsed;
+	size_t passes;
+	int pattern;
+
+	generateSamples<Float>(data[0], false, 0);
+	generateSamples<Float>(data[1], true, 0);
+
+	for (const Benchmark& benchmark : benchmarks) {
+		if (filter != nullptr && strstr(benchmark.name, filter) == nullptr) continue;
+
+		for (pattern = (benchmark.coherentOnly ? 1 : 0); pattern < 2; ++pattern) {
+			// Warm up
+			runPass<Float>(generator, noisePower, benchmark, data[pattern]);
+
+			// Timed passes
+			best = 0.0;
+			passes = 0;
+			start = Clock::now();
+			do {
+				passStart = Clock::now();
+				runPass<Float>(generator, noisePower, benchmark, data[pattern]);
+				now = Clock::now();
+
+				elapsed = chrono::duration<double>(now - passStart).count();
+				if (passes == 0 || elapsed < best) best = elapsed;
+				++passes;
+			}
+			while (chrono::duration<double>(now - start).count() < minimumSeconds);
+
+			printf(
+				"%s,%s,%s,%s,%d,%s,%lu,%lu,%.4f,%.0f\n",
+				buildName,
+				cpuName,
+				floatName,
+				benchmark.name,
+				benchmark.dimensions,
+				patternNames[pattern],
+				static_cast<unsigned long>(sampleCount),
+				static_cast<unsigned long>(passes),
+				best * 1e9 / sampleCount,
+				sampleCount / best
+			);
+			fflush(stdout);
+		}
+	}
+}
+
+
+
+int main(int argc, char** argv) {
+	// Usage
+	if (argc > 1 && (argv[1][0] < '0' || argv[1][0] > '9') && argv[1][0] != '.') {
+		cout << "Usage:" << endl;
+		cout << "  " << argv[0] << " [seconds [filter]]" << endl;
+		cout << "    seconds = the minimum time spent on each benchmark; defaults to 0.25" << endl;
+		cout << "    filter = only run the benchmarks whose name contains this" << endl;
+		return -1;
+	}
+
+
+	// Arguments
+	double minimumSeconds = (argc > 1) ? atof(argv[1]) : 0.25;
+	const char* filter = (argc > 2) ? argv[2] : nullptr;
+	if (minimumSeconds < 0.0) minimumSeconds = 0.0;
+
+	// The vectorized kernels which are used
+	const char* cpuName = "scalar";
+	if (SimplexNoiseSimd::hasAvx512f()) cpuName = "avx512f";
+	else if (SimplexNoiseSimd::hasAvx2()) cpuName = "avx2";
+
+
+	// Run
+	printf("build,cpu,float,benchmark,dimensions,pattern,samples,passes,ns_per_sample,samples_per_second\n");
+	runBenchmarks<float>("float", cpuName, minimumSeconds, filter);
+	runBenchmarks<double>("double", cpuName, minimumSeconds, filter);
+
+
+	// Done
+	return 0;
+}
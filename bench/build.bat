@@ -0,0 +1,72 @@
+@echo off
+:: Usage:
+:: build [mode] [test]
+::   mode = "r" | ...
+::     "r" = release; builds both the default and the SIMPLEX_NOISE_FAST_MATH variants
+::     ... = debug
+::   test = "test" | ...
+::     "test" = perform the default test
+::     ...    = do nothing
+
+
+:: Include paths
+pushd "..\src"
+set INCLUDE_PATH=%CD%
+popd
+
+
+:: Build mode
+if a"%1"==a"r" (
+	echo Building release
+	call :build_release bench || goto :eof
+	call :build_release_fast_math bench-fast-math || goto :eof
+) else (
+	echo Building debug
+	call :build_debug bench-debug || goto :eof
+)
+
+
+:: Test
+if a"%2"==a"test" (
+	echo Testing
+	if a"%1"==a"r" (
+		call :test bench bench.csv
+		call :test bench-fast-math bench-fast-math.csv
+	) else (
+		call :test bench-debug bench-debug.csv
+	)
+)
+
+
+goto :eof
+
+
+:: Debug building
+:build_debug
+set EXE=%1
+g++ -Wall -O0 -g -std=c++11 -I"%INCLUDE_PATH%" -o %EXE% bench.cpp "%INCLUDE_PATH%\SimplexNoise.cpp" "%INCLUDE_PATH%\SimplexNoiseSimd.cpp" || exit /b 1
+
+goto :eof
+
+
+:: Release building
+:build_release
+set EXE=%1
+g++ -Wall -O3 -DNDEBUG=1 -std=c++11 -I"%INCLUDE_PATH%" -o %EXE% bench.cpp "%INCLUDE_PATH%\SimplexNoise.cpp" "%INCLUDE_PATH%\SimplexNoiseSimd.cpp" || exit /b 1
+
+goto :eof
+
+
+:: Release building with fast math
+:build_release_fast_math
+set EXE=%1
+g++ -Wall -O3 -DNDEBUG=1 -DSIMPLEX_NOISE_FAST_MATH=1 -std=c++11 -I"%INCLUDE_PATH%" -o %EXE% bench.cpp "%INCLUDE_PATH%\SimplexNoise.cpp" "%INCLUDE_PATH%\SimplexNoiseSimd.cpp" || exit /b 1
+
+goto :eof
+
+
+:: Benchmark results
+:test
+%1 > %2
+
+goto :eof
@@ -18,3 +18,15 @@ pushd solver
 call build d
 call build r
 popd
+
+echo Building validate...
+pushd validate
+call build d
+call build r
+popd
+
+echo Building bench...
+pushd bench
+call build d
+call build r
+popd
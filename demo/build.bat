@@ -38,7 +38,7 @@ goto :eof
 :: Debug building
 :build_debug
 set EXE=%1
-g++ -Wall -O0 -g -std=gnu++11 -I"%INCLUDE_PATH%" -o %EXE% demo.cpp "%INCLUDE_PATH%\SimplexNoise.cpp" || exit /b 1
+g++ -Wall -O0 -g -std=gnu++11 -I"%INCLUDE_PATH%" -o %EXE% demo.cpp "%INCLUDE_PATH%\SimplexNoise.cpp" "%INCLUDE_PATH%\SimplexNoiseSimd.cpp" "%INCLUDE_PATH%\SimplexNoiseThreadPool.cpp" "%INCLUDE_PATH%\SimplexNoiseImageWriter.cpp" || exit /b 1
 
 goto :eof
 
@@ -46,7 +46,7 @@ goto :eof
 :: Release building
 :build_release
 set EXE=%1
-g++ -Wall -O3 -DNDEBUG=1 -DSIMPLEX_NOISE_FAST_MATH=1 -std=gnu++11 -I"%INCLUDE_PATH%" -o %EXE% demo.cpp "%INCLUDE_PATH%\SimplexNoise.cpp" || exit /b 1
+g++ -Wall -O3 -DNDEBUG=1 -DSIMPLEX_NOISE_FAST_MATH=1 -std=gnu++11 -I"%INCLUDE_PATH%" -o %EXE% demo.cpp "%INCLUDE_PATH%\SimplexNoise.cpp" "%INCLUDE_PATH%\SimplexNoiseSimd.cpp" "%INCLUDE_PATH%\SimplexNoiseThreadPool.cpp" "%INCLUDE_PATH%\SimplexNoiseImageWriter.cpp" || exit /b 1
 
 goto :eof
 
@@ -1,14 +1,10 @@
 #include <iostream>
-#include <fstream>
 #include <cstdlib>
 #include <cstring>
 
-#ifdef _WIN32
-#include <io.h>
-#include <fcntl.h>
-#endif
-
 #include "SimplexNoise.hpp"
+#include "SimplexNoiseImage.hpp"
+#include "SimplexNoiseImageWriter.hpp"
 
 using namespace std;
 
@@ -25,7 +21,7 @@ int main(int argc, char** argv) {
 	if (argc <= 11) {
 		cerr << "Invalid arguments" << endl;
 		cerr << "  demo filename mode norm_mode width height scale max_radius power dimensions octaves [x y z w ...]" << endl;
-		// mode=binary|ascii
+		// mode=binary|binary16|ascii|float
 		// norm_mode=centered|full
 		return -1;
 	}
@@ -34,7 +30,11 @@ int main(int argc, char** argv) {
 	// Arguments
 	int argid = 1;
 	const char* filename = argv[argid++];
-	bool outputBinary = (stricmp(argv[argid++], "ascii") != 0);
+	const char* mode = argv[argid++];
+	SimplexNoiseImageWriter::Format format = SimplexNoiseImageWriter::Format::Gray8;
+	if (stricmp(mode, "ascii") == 0) format = SimplexNoiseImageWriter::Format::Gray8Ascii;
+	else if (stricmp(mode, "binary16") == 0) format = SimplexNoiseImageWriter::Format::Gray16;
+	else if (stricmp(mode, "float") == 0) format = SimplexNoiseImageWriter::Format::Float32;
 	bool normalizeCentered = (stricmp(argv[argid++], "centered") == 0);
 	int width = atoi(argv[argid++]);
 	int height = atoi(argv[argid++]);
@@ -52,52 +52,35 @@ int main(int argc, char** argv) {
 
 	// Setup
 	ostream* infoStream = &cerr;
-	ostream* f = nullptr;
-	fstream* ff = nullptr;
-	if (strcmp(filename, "-") == 0) {
-		f = &cout;
-		infoStream = &cerr;
-#ifdef _WIN32
-		// put into binary mode on windows
-		_setmode(_fileno(stdout), _O_BINARY);
-#endif
-	}
-	else {
-		ff = new fstream(filename, fstream::out | fstream::binary);
-		if (!ff->is_open()) {
-			cerr << "Failed to open output file" << endl;
-			delete ff;
-			return -2;
-		}
-		f = ff;
+	bool toStdout = (strcmp(filename, "-") == 0);
+	SimplexNoiseImageWriter f;
+	if (!f.open(filename, format, width, height)) {
+		cerr << "Failed to open output file" << endl;
+		return -2;
 	}
 
-	double* values = new double[width * height];
-	double* v = values;
-
-	bool first = true;
-	double min = 0.0, max = 0.0;
-
-	double* p = new double[dimensions];
 	double* pDefault = new double[dimensions];
 	for (int i = 0; i < dimensions; ++i) {
-		p[i] = 0.0;
+		pDefault[i] = 0.0;
 	}
 	for (int i = 0, j = minInt(argc - argid + i, dimensions); i < j; ++i) {
-		p[i] = atof(argv[argid++]);
-	}
-	for (int i = 0; i < dimensions; ++i) {
-		pDefault[i] = p[i];
+		pDefault[i] = atof(argv[argid++]);
 	}
 
 	SimplexNoise<double> d;
+	SimplexNoisePower<double> dPower(power);
+	SimplexNoiseImage<double> image(width, height);
+	SimplexNoiseThreadPool pool;
+
+	// Per-thread positions
+	double* pThreads = new double[pool.getThreadCount() * dimensions];
 
 
 	// Status
 	infoStream->precision(16);
 	*infoStream << "Generating noise:" << endl;
-	*infoStream << "    filename: " << filename << (ff == nullptr ? " (stdout)" : "") << endl;
-	*infoStream << "        mode: " << (outputBinary ? "binary" : "ascii") << endl;
+	*infoStream << "    filename: " << filename << (toStdout ? " (stdout)" : "") << endl;
+	*infoStream << "        mode: " << mode << endl;
 	*infoStream << "   norm_mode: " << (normalizeCentered ? "centered" : "full") << endl;
 	*infoStream << "       width: " << width << endl;
 	*infoStream << "      height: " << height << endl;
@@ -105,91 +88,73 @@ int main(int argc, char** argv) {
 	*infoStream << "  max_radius: " << maxRadius << endl;
 	*infoStream << "       power: " << power << endl;
 	*infoStream << "  dimensions: " << dimensions << endl;
-	*infoStream << "     octaves: " << octaves << endl << endl;
+	*infoStream << "     octaves: " << octaves << endl;
+	*infoStream << "     threads: " << pool.getThreadCount() << endl << endl;
 
 
 	// Generate noise
-	double n, nScale;
-	for (int y = 0; y < height; ++y) {
-		for (int x = 0; x < width; ++x) {
-			p[0] = pDefault[0] + x * scale;
-			p[1] = pDefault[1] + y * scale;
-			n = d.noise_n(maxRadius, power, dimensions, p);
-			if (octaves > 1) {
-				nScale = 0.5;
-				for (int i = 1; i < octaves; ++i) {
-					for (int j = 0; j < dimensions; ++j) p[j] *= 2.0;
-					n += d.noise_n(maxRadius, power, dimensions, p) * nScale;
-					nScale /= 2.0;
-				}
-				for (int j = 0; j < dimensions; ++j) {
-					p[j] = pDefault[j];
+	image.generate(pool, [&] (size_t x0, size_t y0, size_t w, size_t h, double* v, size_t stride, unsigned int thread) {
+		double* p = pThreads + thread * dimensions;
+		double n, nScale;
+
+		for (int j = 0; j < dimensions; ++j) {
+			p[j] = pDefault[j];
+		}
+
+		for (size_t yi = 0; yi < h; ++yi) {
+			int y = static_cast<int>(y0 + yi);
+			for (size_t xi = 0; xi < w; ++xi) {
+				int x = static_cast<int>(x0 + xi);
+				p[0] = pDefault[0] + x * scale;
+				p[1] = pDefault[1] + y * scale;
+				n = d.noise_n(maxRadius, dPower, dimensions, p);
+				if (octaves > 1) {
+					nScale = 0.5;
+					for (int i = 1; i < octaves; ++i) {
+						for (int j = 0; j < dimensions; ++j) p[j] *= 2.0;
+						n += d.noise_n(maxRadius, dPower, dimensions, p) * nScale;
+						nScale /= 2.0;
+					}
+					for (int j = 0; j < dimensions; ++j) {
+						p[j] = pDefault[j];
+					}
 				}
-			}
 
-			if (first) {
-				min = max = n;
-				first = false;
-			}
-			else {
-				if (n < min) min = n;
-				if (n > max) max = n;
+				v[yi * stride + xi] = n;
 			}
-
-			*v = n;
-			++v;
 		}
-	}
+	});
+
+	double min = image.getMinimum();
+	double max = image.getMaximum();
 
 
 	// Output min/max
 	*infoStream << "Mininum value: " << min << endl;
 	*infoStream << "Maximum value: " << max << endl;
 
-	double range = max - min;
 	if (normalizeCentered) {
-		range = (-min > max) ? -min : max;
-		min = -range;
-		range *= 2.0;
+		max = (-min > max) ? -min : max;
+		min = -max;
 	}
 
 
 	// Write file
-	*f << (outputBinary ? "P5" : "P2") << "\n";
-	*f << width << " " << height << "\n";
-	*f << "255" << "\n";
-
-	v = values;
-	for (int y = 0; y < height; ++y) {
-		for (int x = 0; x < width; ++x) {
-			double n = (*v - min);
-			if (range == 0) n = 0.5;
-			else n /= range;
-			int px = static_cast<int>(n * 255 + 0.5);
-
-			if (outputBinary) {
-				*f << static_cast<char>(px);
-			}
-			else {
-				*f << px << "\n";
-			}
-
-			++v;
-		}
+	f.setRange(min, max);
+	bool written = f.writeImage(image.getValues(), width);
+	written = f.close() && written;
+	if (!written) {
+		cerr << "Failed to write output file" << endl;
 	}
 
 
 	// Cleanup
-	if (ff != nullptr) {
-		ff->close();
-		delete ff;
-	}
-	delete [] p;
-	delete [] values;
+	delete [] pThreads;
+	delete [] pDefault;
 
 
 	// Done
-	return 0;
+	return written ? 0 : -3;
 }
 
 
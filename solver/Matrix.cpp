@@ -223,6 +223,50 @@ matrixDeterminant(
 	return determinant;
 }
 
+bool
+solveLinearSystem(
+	uint64_t dimensions,
+	double* matrix,
+	double* vector
+) {
+	// Gaussian elimination with partial pivoting; matrix is destroyed, and vector receives the solution
+	for (uint64_t x = 0; x < dimensions; ++x) {
+		uint64_t pivot = x;
+		for (uint64_t y = x + 1; y < dimensions; ++y) {
+			if (fabs(matrix[x + y * dimensions]) > fabs(matrix[x + pivot * dimensions])) pivot = y;
+		}
+		if (matrix[x + pivot * dimensions] == 0.0) return false;
+
+		if (pivot != x) {
+			for (uint64_t i = 0; i < dimensions; ++i) {
+				double v = matrix[i + x * dimensions];
+				matrix[i + x * dimensions] = matrix[i + pivot * dimensions];
+				matrix[i + pivot * dimensions] = v;
+			}
+			double v = vector[x];
+			vector[x] = vector[pivot];
+			vector[pivot] = v;
+		}
+
+		for (uint64_t y = x + 1; y < dimensions; ++y) {
+			double factor = matrix[x + y * dimensions] / matrix[x + x * dimensions];
+			for (uint64_t i = x; i < dimensions; ++i) {
+				matrix[i + y * dimensions] -= factor * matrix[i + x * dimensions];
+			}
+			vector[y] -= factor * vector[x];
+		}
+	}
+
+	for (uint64_t x = dimensions; x-- > 0; ) {
+		for (uint64_t i = x + 1; i < dimensions; ++i) {
+			vector[x] -= matrix[i + x * dimensions] * vector[i];
+		}
+		vector[x] /= matrix[x + x * dimensions];
+	}
+
+	return true;
+}
+
 void
 printMatrix(
 	uint64_t dimensions,
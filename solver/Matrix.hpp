@@ -65,6 +65,13 @@ matrixDeterminant(
 	const double* matrix
 );
 
+bool
+solveLinearSystem(
+	uint64_t dimensions,
+	double* matrix,
+	double* vector
+);
+
 void
 printMatrix(
 	uint64_t dimensions,
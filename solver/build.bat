@@ -38,7 +38,7 @@ goto :eof
 :: Debug building
 :build_debug
 set EXE=%1
-g++ -Wall -O0 -g -std=c++11 -I"%INCLUDE_PATH%" -o %EXE% solver.cpp Matrix.cpp "%INCLUDE_PATH%\SimplexNoise.cpp" || exit /b 1
+g++ -Wall -O0 -g -std=c++11 -I"%INCLUDE_PATH%" -o %EXE% solver.cpp Matrix.cpp "%INCLUDE_PATH%\SimplexNoise.cpp" "%INCLUDE_PATH%\SimplexNoiseSimd.cpp" "%INCLUDE_PATH%\SimplexNoiseThreadPool.cpp" || exit /b 1
 
 goto :eof
 
@@ -46,17 +46,17 @@ goto :eof
 :: Release building
 :build_release
 set EXE=%1
-g++ -Wall -O3 -DNDEBUG=1 -ffast-math -std=c++11 -I"%INCLUDE_PATH%" -o %EXE% solver.cpp Matrix.cpp "%INCLUDE_PATH%\SimplexNoise.cpp" || exit /b 1
+g++ -Wall -O3 -DNDEBUG=1 -ffast-math -std=c++11 -I"%INCLUDE_PATH%" -o %EXE% solver.cpp Matrix.cpp "%INCLUDE_PATH%\SimplexNoise.cpp" "%INCLUDE_PATH%\SimplexNoiseSimd.cpp" "%INCLUDE_PATH%\SimplexNoiseThreadPool.cpp" || exit /b 1
 
 goto :eof
 
 
 :: Test image
 :test
-%EXE% false 0 2 500 2000 > solve-2d.txt
-:: solver false 0 2 500 2000 > solve-2d.txt
-:: solver false 0 3 200 1000 > solve-3d.txt
-:: solver false 0 4 100 200 > solve-4d.txt
+%EXE% false 0 2 500 100 > solve-2d.txt
+:: solver false 0 2 500 100 > solve-2d.txt
+:: solver false 0 3 200 100 > solve-3d.txt
+:: solver false 0 4 100 100 > solve-4d.txt
 
 goto :eof
 
@@ -1,15 +1,20 @@
 #include <iostream>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 #include <sstream>
 #include <cstdlib>
+#include <thread>
+#ifdef _WIN32
 #define VC_EXTRALEAN
 #define WIN32_LEAN_AND_MEAN
-#define UNICODE
-#define _UNICODE
 #include <windows.h>
+#endif
 #include "hyperloop.hpp"
+#include "SimplexNoiseThreadPool.hpp"
 #include "Matrix.hpp"
 #include "solver.hpp"
 
@@ -17,76 +22,6 @@ using namespace std;
 
 
 
-// Threading
-int
-getThreadCount() {
-	SYSTEM_INFO sysinfo;
-	GetSystemInfo(&sysinfo);
-
-	int cpuCount = sysinfo.dwNumberOfProcessors;
-	if (cpuCount < 1) cpuCount = 1;
-
-	return cpuCount;
-}
-
-bool
-spawnThread(
-	LPTHREAD_START_ROUTINE function,
-	ThreadData* threadInfo
-) {
-	assert(threadInfo != nullptr);
-
-	// Attr
-	SECURITY_ATTRIBUTES threadAttr;
-	threadAttr.nLength = sizeof(SECURITY_ATTRIBUTES);
-	threadAttr.lpSecurityDescriptor = nullptr;
-	threadAttr.bInheritHandle = FALSE;
-
-	// Create thread
-	threadInfo->threadHandle = CreateThread(
-		&threadAttr, // lpThreadAttributes,
-		0, // dwStackSize,
-		function, // lpStartAddress,
-		static_cast<void*>(threadInfo), // lpParameter,
-		0, // dwCreationFlags,
-		nullptr // lpThreadId
-	);
-
-	// Return the handle
-	return (threadInfo->threadHandle != nullptr);
-}
-
-void
-joinThreads(
-	int threadCount,
-	ThreadData* threadInfos
-) {
-	if (threadCount == 0) return;
-
-	HANDLE* handles = new HANDLE[threadCount];
-	for (int i = 0; i < threadCount; ++i) {
-		handles[i] = threadInfos[i].threadHandle;
-	}
-
-	WaitForMultipleObjects(threadCount, handles, TRUE, INFINITE);
-
-	delete [] handles;
-}
-
-void
-completeThread(
-	ThreadData* threadInfo
-) {
-	assert(threadInfo != nullptr);
-
-	if (threadInfo->threadHandle != nullptr) {
-		CloseHandle(threadInfo->threadHandle);
-		threadInfo->threadHandle = nullptr;
-	}
-}
-
-
-
 // Class methods
 GlobalData :: GlobalData() :
 	lock(),
@@ -94,62 +29,76 @@ GlobalData :: GlobalData() :
 	displayEvery(true),
 	dimensions(3),
 	points(1),
-	pointsLarge(1),
+	refineIterations(1),
 	gradientCount(1),
 	iterationCount(1),
 	iterations(0),
+	chunkSize(1),
+	chunkCount(1),
+	regionLimit(0),
+	completedRanges(),
+	pendingRanges(),
+	pendingChunkOffsets(),
+	checkpointPath(nullptr),
+	checkpointInterval(),
+	checkpointTime(),
+	checkpointFailed(false),
 	T(nullptr),
 	Tinv(nullptr),
 	simplexPoints(nullptr),
+	gradientNegation(nullptr),
+	gradientReflection(nullptr),
+	cornerReflection(nullptr),
+	skipped(0),
+	pruned(0),
 	updates(0),
+	extremaValid(false),
 	minimum(0.0),
-	maximum(0.0)
+	maximum(0.0),
+	minimumCombination(nullptr),
+	maximumCombination(nullptr)
 {
-	InitializeCriticalSection(&this->lock);
 }
 
 GlobalData :: ~GlobalData() {
-	DeleteCriticalSection(&this->lock);
 }
 
 bool
 GlobalData :: updateExtrema(
 	const ThreadData* tData,
 	Double minimum,
-	Double maximum,
-	bool updateCount
+	Double maximum
 ) {
 	bool updated = false;
 
-	EnterCriticalSection(&this->lock);
+	std::lock_guard<std::mutex> lock(this->lock);
 
 	// Update
-	if (this->iterations == 0) {
+	bool updateMinimum = (!this->extremaValid || minimum < this->minimum);
+	bool updateMaximum = (!this->extremaValid || maximum > this->maximum);
+	if (updateMinimum) {
 		this->minimum = minimum;
-		this->maximum = maximum;
+		for (uint64_t i = 0; i <= this->dimensions; ++i) {
+			uint64_t index = tData->combination[i];
+			this->minimumCombination[i] = (tData->minimumNegated ? this->gradientNegation[index] : index);
+		}
 		updated = true;
 	}
-	else {
-		if (minimum < this->minimum) {
-			this->minimum = minimum;
-			updated = true;
-		}
-		if (maximum > this->maximum) {
-			this->maximum = maximum;
-			updated = true;
+	if (updateMaximum) {
+		this->maximum = maximum;
+		for (uint64_t i = 0; i <= this->dimensions; ++i) {
+			uint64_t index = tData->combination[i];
+			this->maximumCombination[i] = (tData->maximumNegated ? this->gradientNegation[index] : index);
 		}
+		updated = true;
 	}
-	if (updateCount) ++this->iterations;
+	this->extremaValid = true;
+	++this->iterations;
 
 	// Output
 	if (updated || tData->globalData->displayEvery) {
-		if (updateCount) {
-			cout << "progress=" << this->iterations << "/" << this->iterationCount;
-		}
-		else {
-			cout << "progress=retry";
-		}
-		cout << " (thread=" << (tData->threadIndex + 1) << "/" << this->threadCount << "; progress=" << (tData->iterations) << "/" << tData->iterationCount << ")" <<
+		cout << "progress=" << this->iterations << "/" << this->iterationCount;
+		cout << " (thread=" << (tData->threadIndex + 1) << "/" << this->threadCount << "; done=" << (tData->iterations) << ")" <<
 			" min=" << this->minimum << "; max=" << this->maximum << "; largest=" << (-this->minimum > this->maximum ? -this->minimum : this->maximum);
 		if (updated) {
 			cout << " [updated]";
@@ -158,26 +107,75 @@ GlobalData :: updateExtrema(
 		cout << endl;
 	}
 
+#ifdef _WIN32
 	stringstream ss;
 	ss << "solver (" << this->iterations << "/" << this->iterationCount << "; " << this->updates << ")";
 	string s = ss.str();
-	SetConsoleTitle(s.c_str());
-
-	LeaveCriticalSection(&this->lock);
+	SetConsoleTitleA(s.c_str());
+#endif
 
 	return updated;
 }
 
+void
+GlobalData :: completeRange(
+	uint64_t start,
+	uint64_t count,
+	uint64_t skippedCount,
+	uint64_t prunedCount
+) {
+	std::lock_guard<std::mutex> lock(this->lock);
+
+	this->iterations += skippedCount + prunedCount;
+	this->skipped += skippedCount;
+	this->pruned += prunedCount;
+
+	// Insert into the sorted list of completed ranges, merging with its neighbours
+	std::pair<uint64_t, uint64_t> range(start, start + count);
+	auto it = std::lower_bound(this->completedRanges.begin(), this->completedRanges.end(), range);
+	if (it != this->completedRanges.end() && it->first == range.second) {
+		it->first = range.first;
+	}
+	else {
+		it = this->completedRanges.insert(it, range);
+	}
+	if (it != this->completedRanges.begin() && (it - 1)->second == it->first) {
+		(it - 1)->second = it->second;
+		this->completedRanges.erase(it);
+	}
+
+	// Periodic checkpoint
+	if (this->checkpointPath != nullptr && !this->checkpointFailed) {
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (now - this->checkpointTime >= this->checkpointInterval) {
+			this->checkpointTime = now;
+			if (!writeCheckpoint(this)) {
+				cerr << "Failed to write checkpoint " << this->checkpointPath << endl;
+				this->checkpointFailed = true;
+			}
+		}
+	}
+}
+
+bool
+GlobalData :: getExtrema(
+	Double* minimum,
+	Double* maximum
+) {
+	std::lock_guard<std::mutex> lock(this->lock);
+
+	*minimum = this->minimum;
+	*maximum = this->maximum;
+	return this->extremaValid;
+}
+
 
 
 ThreadData :: ThreadData() :
-	threadHandle(nullptr),
 	globalData(nullptr),
 	threadIndex(0),
 	pointsDouble(0.0),
 	gradientCount(0),
-	iterationStart(0),
-	iterationCount(0),
 	iterations(0),
 	coordinates(nullptr),
 	coordinatesTransformed(nullptr),
@@ -186,37 +184,73 @@ ThreadData :: ThreadData() :
 	simplexPoints(nullptr),
 	gradients(nullptr),
 	minimum(0.0),
-	maximum(0.0)
+	maximum(0.0),
+	skipped(0),
+	pruned(0),
+	boundBackoff(0),
+	boundCountdown(0),
+	symmetryIndices(nullptr),
+	combination(nullptr),
+	minimumNegated(false),
+	maximumNegated(false),
+	regions(nullptr),
+	minimumIndices(nullptr),
+	maximumIndices(nullptr),
+	refineFree(nullptr),
+	refineBarycentric(nullptr),
+	refineCartesian(nullptr),
+	refineCorner(nullptr),
+	previousIndices(nullptr),
+	previousValid(false),
+	cornerDistances(nullptr),
+	cornerDots(nullptr),
+	stepDistances(nullptr),
+	stepDots(nullptr),
+	stepLengthSquared(0.0),
+	stepProjection(0.0)
 {
 }
 ThreadData :: ~ThreadData() {
 	delete [] this->coordinates;
+	delete [] this->gradients;
+	delete [] this->previousIndices;
+	delete [] this->cornerDistances;
+	delete [] this->symmetryIndices;
+	delete [] this->regions;
+	delete [] this->minimumIndices;
+	delete [] this->refineBarycentric;
+	delete [] this->refineCartesian;
 }
 
 
 
 // Primary looping functions
-DWORD WINAPI
-threadFunction(
-	void* data
+void
+chunkFunction(
+	uint64_t chunk,
+	ThreadData* tData
 ) {
-	ThreadData* tData = static_cast<ThreadData*>(data);
 	GlobalData* gd = tData->globalData;
 
-	// Vars
-	tData->gradients = new double[(gd->dimensions + 1) * gd->dimensions];
+	// Find the pending range containing the chunk
+	size_t range = std::upper_bound(gd->pendingChunkOffsets.begin(), gd->pendingChunkOffsets.end(), chunk) - gd->pendingChunkOffsets.begin() - 1;
+	uint64_t iterationStart = gd->pendingRanges[range].first + (chunk - gd->pendingChunkOffsets[range]) * gd->chunkSize;
+	uint64_t iterationCount = gd->pendingRanges[range].second - iterationStart;
+	if (iterationCount > gd->chunkSize) iterationCount = gd->chunkSize;
+
+	uint64_t skipped = tData->skipped;
+	uint64_t pruned = tData->pruned;
 
 	hyperloop::triangle_eq::iterate_range<uint64_t, ThreadData*, gradientLoop>(
 		gd->dimensions + 1,
 		tData->gradientCount,
-		tData->iterationStart,
-		tData->iterationCount,
+		iterationStart,
+		iterationCount,
 		tData
 	);
 
-	delete [] tData->gradients;
-
-	return 0;
+	// Combinations equivalent to an evaluated one, or which can't improve the extrema, still count towards progress
+	gd->completeRange(iterationStart, iterationCount, tData->skipped - skipped, tData->pruned - pruned);
 }
 
 void gradientLoop(
@@ -228,24 +262,43 @@ void gradientLoop(
 	// Vars
 	GlobalData* gd = tData->globalData;
 
+	// Skip combinations which are a symmetry of another one
+	bool negated;
+	if (!isCanonicalCombination(indices, tData, &negated)) {
+		++tData->skipped;
+		return;
+	}
+
 	// Set the gradient
 	dimensions = gd->dimensions;
-	double* g = tData->gradients;
 	for (uint64_t i = 0; i <= dimensions; ++i) {
-		uint64_t zeroPos = (indices[i] >> (dimensions - 1));
-		for (uint64_t j = 0, k = 0; j < dimensions; ++j) {
-			if (j == zeroPos) {
-				*(g++) = 0.0;
-			}
-			else {
-				*(g++) = ((indices[i] & (1 << (k++))) == 0 ? -1.0 : 1.0);
-			}
-		}
+		setGradient(dimensions, indices[i], &tData->gradients[i * dimensions]);
+	}
+
+	// Skip combinations whose bounds can't beat the current extrema; bounding backs off while it keeps failing,
+	// since it can cost more than sampling when most combinations come close to the extrema
+	if (tData->boundCountdown > 0) {
+		--tData->boundCountdown;
+	}
+	else if (canImprove(tData, negated)) {
+		tData->boundBackoff = tData->boundBackoff * 2 + 1;
+		if (tData->boundBackoff > boundBackoffLimit) tData->boundBackoff = boundBackoffLimit;
+		tData->boundCountdown = tData->boundBackoff;
+	}
+	else {
+		tData->boundBackoff = 0;
+		++tData->pruned;
+		return;
 	}
 
 	// Loop
 	tData->minimum = 0.0;
 	tData->maximum = 0.0;
+	for (uint64_t i = 0; i <= gd->dimensions; ++i) {
+		tData->minimumIndices[i] = (i == 0 ? gd->points : 0);
+		tData->maximumIndices[i] = (i == 0 ? gd->points : 0);
+	}
+	prepareCornerTerms(gd->dimensions, tData);
 
 	if (gd->dimensions == 2) {
 		hyperloop::triangle_sum::iterate<uint64_t, ThreadData*, iterateFunctionPow4>(
@@ -262,64 +315,663 @@ void gradientLoop(
 		);
 	}
 
+	// Refine the best samples to the exact local extrema
+	tData->minimum = refineExtremum(tData, tData->minimumIndices, -1.0);
+	tData->maximum = refineExtremum(tData, tData->maximumIndices, 1.0);
+
+	// A negated combination has negated extrema
+	tData->minimumNegated = false;
+	tData->maximumNegated = false;
+	if (negated) {
+		double minimum = tData->minimum;
+		if (-tData->maximum < minimum) {
+			tData->minimum = -tData->maximum;
+			tData->minimumNegated = true;
+		}
+		if (-minimum > tData->maximum) {
+			tData->maximum = -minimum;
+			tData->maximumNegated = true;
+		}
+	}
+
 	// Next
 	++tData->iterations;
-	bool updated = gd->updateExtrema(
+	tData->combination = indices;
+	gd->updateExtrema(
 		tData,
 		tData->minimum,
-		tData->maximum,
-		true
+		tData->maximum
 	);
+}
 
-	if (updated) {
-		// Set point count
-		tData->pointsDouble = gd->pointsLarge;
+void
+setGradient(
+	uint64_t dimensions,
+	uint64_t index,
+	double* gradient
+) {
+	uint64_t zeroPos = (index >> (dimensions - 1));
+	for (uint64_t j = 0, k = 0; j < dimensions; ++j) {
+		if (j == zeroPos) {
+			gradient[j] = 0.0;
+		}
+		else {
+			gradient[j] = ((index & (1 << (k++))) == 0 ? -1.0 : 1.0);
+		}
+	}
+}
 
-		// If update was successful, re-run using a higher point density
-		tData->minimum = 0.0;
-		tData->maximum = 0.0;
+void
+generateSymmetryTables(
+	GlobalData* gd
+) {
+	// The only isometry mapping the simplex onto itself is the reflection which swaps the corner with k ones with
+	// the corner with (dimensions - k) ones; it maps a gradient g to -reverse(g). Negating every gradient negates
+	// the noise, so together with the identity they form a group of order 4.
+	uint64_t dimensions = gd->dimensions;
+	uint64_t count = gd->gradientCount;
+	double* gradients = new double[count * dimensions];
+	double* g = new double[dimensions * 2];
+	double* gNegated = &g[0];
+	double* gReflected = &g[dimensions];
+
+	for (uint64_t i = 0; i < count; ++i) {
+		setGradient(dimensions, i, &gradients[i * dimensions]);
+	}
 
-		if (gd->dimensions == 2) {
-			hyperloop::triangle_sum::iterate<uint64_t, ThreadData*, iterateFunctionPow4>(
-				gd->dimensions,
-				gd->pointsLarge,
-				tData
-			);
+	gd->gradientNegation = new uint64_t[count];
+	gd->gradientReflection = new uint64_t[count];
+	for (uint64_t i = 0; i < count; ++i) {
+		for (uint64_t j = 0; j < dimensions; ++j) {
+			gNegated[j] = -gradients[i * dimensions + j];
+			gReflected[j] = -gradients[i * dimensions + (dimensions - 1 - j)];
 		}
-		else {
-			hyperloop::triangle_sum::iterate<uint64_t, ThreadData*, iterateFunctionPow3>(
-				gd->dimensions,
-				gd->pointsLarge,
-				tData
-			);
-		}
-
-		// Update again
-		gd->updateExtrema(
-			tData,
-			tData->minimum,
-			tData->maximum,
-			false
-		);
 
-		// Reset point count
-		tData->pointsDouble = gd->points;
+		gd->gradientNegation[i] = count;
+		gd->gradientReflection[i] = count;
+		for (uint64_t k = 0; k < count; ++k) {
+			// Compared by value, since a negated zero is -0.0
+			bool negatedEqual = true;
+			bool reflectedEqual = true;
+			for (uint64_t j = 0; j < dimensions; ++j) {
+				if (gNegated[j] != gradients[k * dimensions + j]) negatedEqual = false;
+				if (gReflected[j] != gradients[k * dimensions + j]) reflectedEqual = false;
+			}
+			if (negatedEqual) gd->gradientNegation[i] = k;
+			if (reflectedEqual) gd->gradientReflection[i] = k;
+		}
+		assert(gd->gradientNegation[i] < count);
+		assert(gd->gradientReflection[i] < count);
+	}
+
+	// Corner i < dimensions has (i + 1) ones, and corner dimensions is the origin
+	gd->cornerReflection = new uint64_t[dimensions + 1];
+	for (uint64_t i = 0; i <= dimensions; ++i) {
+		uint64_t ones = dimensions - (i < dimensions ? i + 1 : 0);
+		gd->cornerReflection[i] = (ones > 0 ? ones - 1 : dimensions);
+	}
+
+	delete [] gradients;
+	delete [] g;
+}
+
+bool
+isCanonicalCombination(
+	const uint64_t* indices,
+	ThreadData* tData,
+	bool* negated
+) {
+	// Only images which are themselves enumerated (ie. sorted) are equivalent to one of the combinations;
+	// the smallest of those is evaluated, and stands in for the others
+	GlobalData* gd = tData->globalData;
+	uint64_t dimensions = gd->dimensions;
+	uint64_t* image = tData->symmetryIndices;
+
+	*negated = false;
+	for (int symmetry = 1; symmetry < 4; ++symmetry) {
+		for (uint64_t i = 0; i <= dimensions; ++i) {
+			uint64_t v = indices[(symmetry & 2) != 0 ? gd->cornerReflection[i] : i];
+			if ((symmetry & 2) != 0) v = gd->gradientReflection[v];
+			if ((symmetry & 1) != 0) v = gd->gradientNegation[v];
+			image[i] = v;
+		}
+
+		bool sorted = true;
+		for (uint64_t i = 0; sorted && i < dimensions; ++i) {
+			sorted = (image[i] <= image[i + 1]);
+		}
+		if (!sorted) continue;
+
+		for (uint64_t i = 0; i <= dimensions; ++i) {
+			if (image[i] != indices[i]) {
+				if (image[i] < indices[i]) return false;
+				break;
+			}
+		}
+
+		if ((symmetry & 1) != 0) *negated = true;
+	}
+
+	return true;
+}
+
+double
+evaluateNoise(
+	ThreadData* tData,
+	const double* x,
+	double* gradient,
+	double* hessian
+) {
+	// For each corner, with r = x - p, f = 0.5 - |r|^2, n = 4 in 2d and 3 otherwise:
+	//   value = f^n (r . g)
+	//   gradient = f^n g - 2 n f^(n-1) (r . g) r
+	//   hessian = -2 n f^(n-1) (g r^T + r g^T + (r . g) I) + 4 n (n - 1) f^(n-2) (r . g) r r^T
+	uint64_t dimensions = tData->globalData->dimensions;
+	int n = (dimensions == 2 ? 4 : 3);
+	double* r = tData->refineCorner;
+	double value = 0.0;
+	double distSq, dot;
+
+	if (gradient != nullptr) {
+		for (uint64_t j = 0; j < dimensions; ++j) gradient[j] = 0.0;
+	}
+	if (hessian != nullptr) {
+		for (uint64_t j = 0; j < dimensions * dimensions; ++j) hessian[j] = 0.0;
+	}
+
+	for (uint64_t i = 0; i <= dimensions; ++i) {
+		const double* p = &tData->simplexPoints[i * dimensions];
+		const double* g = &tData->gradients[i * dimensions];
+
+		distSq = 0.0;
+		dot = 0.0;
+		for (uint64_t j = 0; j < dimensions; ++j) {
+			r[j] = x[j] - p[j];
+			distSq += r[j] * r[j];
+			dot += r[j] * g[j];
+		}
+
+		// Distance too large
+		if (distSq >= 0.5) continue;
+
+		double f = 0.5 - distSq;
+		double fn2 = integerPower(f, n - 2);
+		double fn1 = fn2 * f;
+		value += fn1 * f * dot;
+
+		if (gradient != nullptr) {
+			for (uint64_t j = 0; j < dimensions; ++j) {
+				gradient[j] += fn1 * f * g[j] - 2.0 * n * fn1 * dot * r[j];
+			}
+		}
+
+		if (hessian != nullptr) {
+			double a = -2.0 * n * fn1;
+			double b = 4.0 * n * (n - 1) * fn2 * dot;
+			for (uint64_t j = 0; j < dimensions; ++j) {
+				for (uint64_t k = 0; k < dimensions; ++k) {
+					hessian[k + j * dimensions] += a * (g[j] * r[k] + r[j] * g[k] + (j == k ? dot : 0.0)) + b * r[j] * r[k];
+				}
+			}
+		}
+	}
+
+	return value;
+}
+
+double
+refineExtremum(
+	ThreadData* tData,
+	const uint64_t* indices,
+	double sign
+) {
+	// Maximizes sign * value over the barycentric coordinates b, with b >= 0 and sum(b) = 1, starting at the sample
+	// indices / points. Each iteration takes a Newton step over the coordinates which aren't held at 0 by an
+	// active constraint, or a projected gradient step if that isn't an ascent direction, shortened to stay in the
+	// simplex and halved until the value improves. The point x = sum(b[k] p[k]) has p[dimensions] = 0.
+	GlobalData* gd = tData->globalData;
+	uint64_t dimensions = gd->dimensions;
+	uint64_t m = dimensions + 1;
+	double* b = tData->refineBarycentric;
+	double* bNext = &b[m];
+	double* gradientB = &b[m * 2];
+	double* delta = &b[m * 3];
+	double* hessianB = &b[m * 4];
+	double* system = &hessianB[m * m];
+	double* rhs = &system[(m + 1) * (m + 1)];
+	double* x = tData->refineCartesian;
+	double* gradientX = &x[dimensions];
+	double* hessianX = &x[dimensions * 2];
+	double* hessianP = &hessianX[dimensions * dimensions];
+	uint64_t* free = tData->refineFree;
+	const double* p = tData->simplexPoints;
+
+	for (uint64_t k = 0; k < m; ++k) {
+		b[k] = indices[k] / tData->pointsDouble;
+	}
+	barycentricToCartesian(dimensions, tData->T, b, x);
+	double value = sign * evaluateNoise(tData, x, gradientX, hessianX);
+
+	for (uint64_t iteration = 0; iteration < gd->refineIterations; ++iteration) {
+		// Derivatives with respect to b
+		for (uint64_t k = 0; k < m; ++k) {
+			gradientB[k] = 0.0;
+			for (uint64_t j = 0; j < dimensions; ++j) {
+				gradientB[k] += sign * p[k * dimensions + j] * gradientX[j];
+			}
+		}
+		for (uint64_t l = 0; l < m; ++l) {
+			for (uint64_t j = 0; j < dimensions; ++j) {
+				double h = 0.0;
+				for (uint64_t i = 0; i < dimensions; ++i) {
+					h += hessianX[i + j * dimensions] * p[l * dimensions + i];
+				}
+				hessianP[j + l * dimensions] = h;
+			}
+		}
+		for (uint64_t k = 0; k < m; ++k) {
+			for (uint64_t l = 0; l < m; ++l) {
+				double h = 0.0;
+				for (uint64_t j = 0; j < dimensions; ++j) {
+					h += p[k * dimensions + j] * hessianP[j + l * dimensions];
+				}
+				hessianB[l + k * m] = sign * h;
+			}
+		}
+
+		// Free coordinates: the positive ones, and any at 0 which would increase the value when moved inwards
+		uint64_t freeCount = 0;
+		double mean = 0.0;
+		for (uint64_t k = 0; k < m; ++k) {
+			if (b[k] > 0.0) {
+				free[freeCount++] = k;
+				mean += gradientB[k];
+			}
+		}
+		mean /= static_cast<double>(freeCount);
+		for (bool added = true; added; ) {
+			added = false;
+			for (uint64_t k = 0; k < m; ++k) {
+				if (b[k] > 0.0 || gradientB[k] <= mean) continue;
+				bool found = false;
+				for (uint64_t i = 0; i < freeCount; ++i) {
+					if (free[i] == k) found = true;
+				}
+				if (found) continue;
+
+				mean = (mean * freeCount + gradientB[k]) / static_cast<double>(freeCount + 1);
+				free[freeCount++] = k;
+				added = true;
+			}
+		}
+		// Direction; coordinates at 0 which it would move outwards are held, and the direction is recomputed
+		double step = 1.0;
+		bool held = true;
+		while (held) {
+			if (freeCount < 2) break; // At a vertex which is a local extremum
+
+			// Newton step: [H 1; 1^T 0] [delta; mu] = [-g; 0]
+			uint64_t q = freeCount + 1;
+			for (uint64_t i = 0; i < freeCount; ++i) {
+				for (uint64_t j = 0; j < freeCount; ++j) {
+					system[j + i * q] = hessianB[free[j] + free[i] * m];
+				}
+				system[freeCount + i * q] = 1.0;
+				system[i + freeCount * q] = 1.0;
+				rhs[i] = -gradientB[free[i]];
+			}
+			system[freeCount + freeCount * q] = 0.0;
+			rhs[freeCount] = 0.0;
+
+			double ascent = 0.0;
+			for (uint64_t k = 0; k < m; ++k) delta[k] = 0.0;
+			if (solveLinearSystem(q, system, rhs)) {
+				for (uint64_t i = 0; i < freeCount; ++i) {
+					delta[free[i]] = rhs[i];
+					ascent += rhs[i] * gradientB[free[i]];
+				}
+			}
+
+			step = 1.0;
+			if (!(ascent > 0.0)) {
+				// Projected gradient, limited to a fraction of the simplex
+				double largest = 0.0;
+				for (uint64_t i = 0; i < freeCount; ++i) {
+					delta[free[i]] = gradientB[free[i]] - mean;
+					if (fabs(delta[free[i]]) > largest) largest = fabs(delta[free[i]]);
+				}
+				if (!(largest > 0.0)) {
+					freeCount = 0;
+					break;
+				}
+				step = 0.125 / largest;
+			}
+
+			held = false;
+			for (uint64_t i = 0; i < freeCount; ) {
+				uint64_t k = free[i];
+				if (delta[k] < 0.0 && b[k] <= -delta[k] * step * 1e-12) {
+					mean = (mean * freeCount - gradientB[k]) / static_cast<double>(freeCount - 1);
+					free[i] = free[--freeCount];
+					held = true;
+				}
+				else {
+					++i;
+				}
+			}
+		}
+		if (freeCount < 2) break;
+
+		// Stay inside the simplex
+		uint64_t blocking = m;
+		for (uint64_t i = 0; i < freeCount; ++i) {
+			uint64_t k = free[i];
+			if (delta[k] < 0.0 && b[k] < -delta[k] * step) {
+				step = b[k] / -delta[k];
+				blocking = k;
+			}
+		}
+
+		// Halve the step until the value improves, or until it doesn't move the point anymore
+		bool improved = false;
+		for (int attempt = 0; attempt < 64 && !improved; ++attempt) {
+			bool moved = false;
+			for (uint64_t k = 0; k < m; ++k) {
+				bNext[k] = b[k] + step * delta[k];
+				if (bNext[k] < 0.0) bNext[k] = 0.0;
+				if (bNext[k] != b[k]) moved = true;
+			}
+			if (attempt == 0 && blocking < m) bNext[blocking] = 0.0;
+			if (!moved) break;
+
+			barycentricToCartesian(dimensions, tData->T, bNext, x);
+			double next = sign * evaluateNoise(tData, x, nullptr, nullptr);
+			if (next > value) {
+				value = next;
+				improved = true;
+			}
+			step *= 0.5;
+		}
+		if (!improved) break;
+
+		memcpy(b, bNext, sizeof(double) * m);
+		barycentricToCartesian(dimensions, tData->T, b, x);
+		evaluateNoise(tData, x, gradientX, hessianX);
+	}
+
+	return sign * value;
+}
+
+bool
+canImprove(
+	ThreadData* tData,
+	bool negated
+) {
+	// Branch and bound: the simplex is split along its longest edge until every sub-simplex is bounded within the
+	// current extrema, or until the region limit is reached
+	GlobalData* gd = tData->globalData;
+	uint64_t dimensions = gd->dimensions;
+	uint64_t regionSize = (dimensions + 1) * dimensions;
+	double minimum, maximum;
+
+	if (!gd->getExtrema(&minimum, &maximum)) return true;
+	minimum += boundMargin;
+	maximum -= boundMargin;
+
+	memcpy(tData->regions, tData->simplexPoints, sizeof(double) * regionSize);
+	uint64_t regionCount = 1;
+	uint64_t bounded = 0;
+	double lower, upper, bound;
+
+	while (regionCount > 0) {
+		double* region = &tData->regions[(regionCount - 1) * regionSize];
+		boundRegion(dimensions, region, tData, &lower, &upper);
+
+		// The negated combination is also accounted for by this one
+		if (negated) {
+			bound = lower;
+			if (-upper < lower) lower = -upper;
+			if (-bound > upper) upper = -bound;
+		}
+
+		if (lower >= minimum && upper <= maximum) {
+			--regionCount;
+			continue;
+		}
+		if (++bounded >= gd->regionLimit || regionCount >= regionStackSize) return true;
+
+		// Find the longest edge
+		uint64_t a = 0, b = 1;
+		double longest = -1.0;
+		for (uint64_t i = 0; i < dimensions; ++i) {
+			for (uint64_t j = i + 1; j <= dimensions; ++j) {
+				double lengthSq = 0.0;
+				for (uint64_t k = 0; k < dimensions; ++k) {
+					double d = region[i * dimensions + k] - region[j * dimensions + k];
+					lengthSq += d * d;
+				}
+				if (lengthSq > longest) {
+					longest = lengthSq;
+					a = i;
+					b = j;
+				}
+			}
+		}
+
+		// Split it; the first half replaces vertex b, and the second half replaces vertex a
+		double* second = &region[regionSize];
+		memcpy(second, region, sizeof(double) * regionSize);
+		for (uint64_t k = 0; k < dimensions; ++k) {
+			double midpoint = (region[a * dimensions + k] + region[b * dimensions + k]) * 0.5;
+			region[b * dimensions + k] = midpoint;
+			second[a * dimensions + k] = midpoint;
+		}
+		++regionCount;
+	}
+
+	return false;
+}
+
+double
+integerPower(
+	double value,
+	int exponent
+) {
+	double result = 1.0;
+	for (int i = 0; i < exponent; ++i) {
+		result *= value;
 	}
+	return result;
 }
 
 void
-iterateFunctionPow3(
+boundRegion(
+	uint64_t dimensions,
+	const double* vertices,
+	ThreadData* tData,
+	double* lower,
+	double* upper
+) {
+	// Each corner contributes w(x) ((x - p) . g), with w(x) = (0.5 - |x - p|^2)^n, n = 4 in 2d and 3 otherwise.
+	// Two bounds are computed, and the tighter one is used:
+	//   Interval: the dot product is linear, so its range is spanned by the vertices; |x - p|^2 is convex, so its
+	//     maximum is at a vertex, and its minimum is bounded using the sphere around the centroid c which contains
+	//     the vertices.
+	//   Taylor: the value and gradient at c are exact, the linear term's range is spanned by the vertices, and the
+	//     remainder is at most |H| radius^2 / 2, with |H| bounding the spectral norm of the Hessian in the sphere.
+	double* centroid = tData->coordinatesTransformed;
+	double* gradient = &tData->coordinatesTransformed[dimensions];
+	double radiusSq = 0.0;
+	double d, distSq, dot;
+	int n = (dimensions == 2 ? 4 : 3);
+
+	for (uint64_t k = 0; k < dimensions; ++k) {
+		centroid[k] = 0.0;
+		for (uint64_t v = 0; v <= dimensions; ++v) {
+			centroid[k] += vertices[v * dimensions + k];
+		}
+		centroid[k] /= static_cast<double>(dimensions + 1);
+		gradient[k] = 0.0;
+	}
+	for (uint64_t v = 0; v <= dimensions; ++v) {
+		distSq = 0.0;
+		for (uint64_t k = 0; k < dimensions; ++k) {
+			d = vertices[v * dimensions + k] - centroid[k];
+			distSq += d * d;
+		}
+		if (distSq > radiusSq) radiusSq = distSq;
+	}
+	double radius = sqrt(radiusSq);
+
+	double intervalLower = 0.0;
+	double intervalUpper = 0.0;
+	double value = 0.0;
+	double hessian = 0.0;
+	for (uint64_t i = 0; i <= dimensions; ++i) {
+		const double* p = &tData->simplexPoints[i * dimensions];
+		const double* g = &tData->gradients[i * dimensions];
+		double distSqMax = 0.0;
+		double dotMin = 0.0, dotMax = 0.0;
+		double gLengthSq = 0.0;
+
+		for (uint64_t v = 0; v <= dimensions; ++v) {
+			distSq = 0.0;
+			dot = 0.0;
+			for (uint64_t k = 0; k < dimensions; ++k) {
+				d = vertices[v * dimensions + k] - p[k];
+				distSq += d * d;
+				dot += d * g[k];
+			}
+			if (distSq > distSqMax) distSqMax = distSq;
+			if (v == 0 || dot < dotMin) dotMin = dot;
+			if (v == 0 || dot > dotMax) dotMax = dot;
+		}
+
+		distSq = 0.0;
+		dot = 0.0;
+		for (uint64_t k = 0; k < dimensions; ++k) {
+			d = centroid[k] - p[k];
+			distSq += d * d;
+			dot += d * g[k];
+			gLengthSq += g[k] * g[k];
+		}
+		d = sqrt(distSq) - radius;
+		double distSqMin = (d > 0.0 ? d * d : 0.0);
+
+		// Out of range everywhere
+		if (distSqMin >= 0.5) continue;
+
+		// Interval bound
+		double falloffMax = 0.5 - distSqMin;
+		double falloffMin = (distSqMax < 0.5 ? 0.5 - distSqMax : 0.0);
+		intervalUpper += dotMax * integerPower(dotMax > 0.0 ? falloffMax : falloffMin, n);
+		intervalLower += dotMin * integerPower(dotMin < 0.0 ? falloffMax : falloffMin, n);
+
+		// Value and gradient at the centroid:
+		//   grad = w g - 2 n (0.5 - |x - p|^2)^(n - 1) ((x - p) . g) (x - p)
+		if (distSq < 0.5) {
+			double falloff = 0.5 - distSq;
+			double w = integerPower(falloff, n);
+			double wDerivative = -2.0 * n * integerPower(falloff, n - 1) * dot;
+			value += w * dot;
+			for (uint64_t k = 0; k < dimensions; ++k) {
+				gradient[k] += w * g[k] + wDerivative * (centroid[k] - p[k]);
+			}
+		}
+
+		// Hessian norm bound, using f = 0.5 - |x - p|^2 <= falloffMax, |x - p| <= rMax and |(x - p) . g| <= |g| rMax:
+		//   H = -2 n f^(n-1) (g (x - p)^T + (x - p) g^T + dot I) + 4 n (n - 1) f^(n-2) dot (x - p) (x - p)^T
+		double rMax = sqrt(distSqMax < 0.5 ? distSqMax : 0.5);
+		double gLength = sqrt(gLengthSq);
+		hessian += gLength * rMax * (6.0 * n * integerPower(falloffMax, n - 1) + 4.0 * n * (n - 1) * integerPower(falloffMax, n - 2) * rMax * rMax);
+	}
+
+	// Range of the linear term
+	double linearMin = 0.0, linearMax = 0.0;
+	for (uint64_t v = 0; v <= dimensions; ++v) {
+		double linear = 0.0;
+		for (uint64_t k = 0; k < dimensions; ++k) {
+			linear += gradient[k] * (vertices[v * dimensions + k] - centroid[k]);
+		}
+		if (v == 0 || linear < linearMin) linearMin = linear;
+		if (v == 0 || linear > linearMax) linearMax = linear;
+	}
+	double remainder = hessian * radiusSq * 0.5;
+
+	*lower = value + linearMin - remainder;
+	*upper = value + linearMax + remainder;
+	if (intervalLower > *lower) *lower = intervalLower;
+	if (intervalUpper < *upper) *upper = intervalUpper;
+}
+
+void
+prepareCornerTerms(
+	uint64_t dimensions,
+	ThreadData* tData
+) {
+	// The innermost hyperloop step moves the point by -step, where step is the last used column of T divided by the point count
+	const double* column = &tData->T[(dimensions - 1) * dimensions];
+	const double* g = tData->gradients;
+	double s, dist, dot;
+
+	tData->stepLengthSquared = 0.0;
+	for (uint64_t j = 0; j < dimensions; ++j) {
+		s = column[j] / tData->pointsDouble;
+		tData->stepLengthSquared += s * s;
+	}
+
+	for (uint64_t i = 0; i <= dimensions; ++i) {
+		dist = 0.0;
+		dot = 0.0;
+		for (uint64_t j = 0; j < dimensions; ++j) {
+			s = column[j] / tData->pointsDouble;
+			dist += tData->simplexPoints[i * dimensions + j] * s;
+			dot += (*(g++)) * s;
+		}
+		tData->stepDistances[i] = dist;
+		tData->stepDots[i] = dot;
+	}
+
+	// The first sample is always computed in full
+	tData->previousValid = false;
+}
+
+void
+updateCornerTerms(
 	uint64_t dimensions,
 	uint64_t sum,
 	const uint64_t* indices,
 	ThreadData* tData
 ) {
+	// Innermost hyperloop step: indices[dimensions - 1] is decremented and indices[dimensions] is incremented,
+	// which has no column in T, so x moves by -step and the corner terms can be updated in O(dimensions):
+	//   |x - step - p|^2 = |x - p|^2 - 2 (x . step) + 2 (p . step) + step . step
+	//   (x - step - p) . g = (x - p) . g - g . step
+	bool step = tData->previousValid && (indices[dimensions - 1] + 1 == tData->previousIndices[dimensions - 1]);
+	for (uint64_t i = 0; step && i < dimensions - 1; ++i) {
+		step = (indices[i] == tData->previousIndices[i]);
+	}
+
+	if (step) {
+		double projection2 = tData->stepProjection * 2.0;
+		for (uint64_t i = 0; i <= dimensions; ++i) {
+			tData->cornerDistances[i] += tData->stepDistances[i] * 2.0 - projection2 + tData->stepLengthSquared;
+			tData->cornerDots[i] -= tData->stepDots[i];
+		}
+		tData->stepProjection -= tData->stepLengthSquared;
+		tData->previousIndices[dimensions - 1] = indices[dimensions - 1];
+		return;
+	}
+
+	// Anything else is computed in full, which also stops rounding errors from accumulating across the outer loops
 	uint64_t testSum = 0;
 	for (uint64_t i = 0; i <= dimensions; ++i) {
 		tData->coordinates[i] = indices[i] / tData->pointsDouble;
+		tData->previousIndices[i] = indices[i];
 		testSum += indices[i];
 	}
 	assert(testSum == sum);
+	tData->previousValid = true;
 
 	barycentricToCartesian(
 		dimensions,
@@ -328,34 +980,64 @@ iterateFunctionPow3(
 		tData->coordinatesTransformed
 	);
 
-	// Check that it's within range of all endpoints
-	//uint64_t dimensionsPlus1 = dimensions + 1;
-	double distSq;
-	double d, dot;
-	double value = 0.0;
-	double* g = tData->gradients;
+	const double* x = tData->coordinatesTransformed;
+	const double* column = &tData->T[(dimensions - 1) * dimensions];
+	const double* g = tData->gradients;
+	double d, distSq, dot, projection;
+
+	projection = 0.0;
+	for (uint64_t j = 0; j < dimensions; ++j) {
+		projection += x[j] * (column[j] / tData->pointsDouble);
+	}
+	tData->stepProjection = projection;
+
 	for (uint64_t i = 0; i <= dimensions; ++i) {
 		distSq = 0.0;
 		dot = 0.0;
 		for (uint64_t j = 0; j < dimensions; ++j) {
-			d = (tData->coordinatesTransformed[j] - tData->simplexPoints[i * dimensions + j]);
+			d = (x[j] - tData->simplexPoints[i * dimensions + j]);
 			distSq += d * d;
 			dot += d * (*(g++));
 		}
+		tData->cornerDistances[i] = distSq;
+		tData->cornerDots[i] = dot;
+	}
+}
+
+void
+iterateFunctionPow3(
+	uint64_t dimensions,
+	uint64_t sum,
+	const uint64_t* indices,
+	ThreadData* tData
+) {
+	updateCornerTerms(dimensions, sum, indices, tData);
+
+	// Check that it's within range of all endpoints
+	double distSq;
+	double value = 0.0;
+	for (uint64_t i = 0; i <= dimensions; ++i) {
+		distSq = tData->cornerDistances[i];
 
 		// Distance too large
 		if (distSq >= 0.5) continue;
 
 		distSq = 0.5 - distSq;
 		distSq = distSq * distSq * distSq;
-		distSq *= dot;
+		distSq *= tData->cornerDots[i];
 
 		value += distSq;
 	}
 
-	// Update min/max values
-	if (value < tData->minimum) tData->minimum = value;
-	else if (value > tData->maximum) tData->maximum = value;
+	// Update min/max values, and where they are
+	if (value < tData->minimum) {
+		tData->minimum = value;
+		memcpy(tData->minimumIndices, indices, sizeof(uint64_t) * (dimensions + 1));
+	}
+	else if (value > tData->maximum) {
+		tData->maximum = value;
+		memcpy(tData->maximumIndices, indices, sizeof(uint64_t) * (dimensions + 1));
+	}
 }
 
 void
@@ -365,34 +1047,13 @@ iterateFunctionPow4(
 	const uint64_t* indices,
 	ThreadData* tData
 ) {
-	uint64_t testSum = 0;
-	for (uint64_t i = 0; i <= dimensions; ++i) {
-		tData->coordinates[i] = indices[i] / tData->pointsDouble;
-		testSum += indices[i];
-	}
-	assert(testSum == sum);
-
-	barycentricToCartesian(
-		dimensions,
-		tData->T,
-		tData->coordinates,
-		tData->coordinatesTransformed
-	);
+	updateCornerTerms(dimensions, sum, indices, tData);
 
 	// Check that it's within range of all endpoints
-	//uint64_t dimensionsPlus1 = dimensions + 1;
 	double distSq;
-	double d, dot;
 	double value = 0.0;
-	double* g = tData->gradients;
 	for (uint64_t i = 0; i <= dimensions; ++i) {
-		distSq = 0.0;
-		dot = 0.0;
-		for (uint64_t j = 0; j < dimensions; ++j) {
-			d = (tData->coordinatesTransformed[j] - tData->simplexPoints[i * dimensions + j]);
-			distSq += d * d;
-			dot += d * (*(g++));
-		}
+		distSq = tData->cornerDistances[i];
 
 		// Distance too large
 		if (distSq >= 0.5) continue;
@@ -400,14 +1061,178 @@ iterateFunctionPow4(
 		distSq = 0.5 - distSq;
 		distSq *= distSq;
 		distSq *= distSq;
-		distSq *= dot;
+		distSq *= tData->cornerDots[i];
 
 		value += distSq;
 	}
 
-	// Update min/max values
-	if (value < tData->minimum) tData->minimum = value;
-	else if (value > tData->maximum) tData->maximum = value;
+	// Update min/max values, and where they are
+	if (value < tData->minimum) {
+		tData->minimum = value;
+		memcpy(tData->minimumIndices, indices, sizeof(uint64_t) * (dimensions + 1));
+	}
+	else if (value > tData->maximum) {
+		tData->maximum = value;
+		memcpy(tData->maximumIndices, indices, sizeof(uint64_t) * (dimensions + 1));
+	}
+}
+
+
+
+// Checkpoints
+bool
+writeCheckpoint(
+	GlobalData* gd
+) {
+	// Layout, in native byte order:
+	//   uint32 magic, version
+	//   uint64 dimensions, points, refineIterations, gradientCount, iterationCount, skipped, pruned, updates, extremaValid, rangeCount
+	//   double minimum, maximum
+	//   uint64 minimumCombination[dimensions + 1], maximumCombination[dimensions + 1]
+	//   uint64 rangeCount * (start, end)
+	string path = gd->checkpointPath;
+	string pathTemp = path + ".tmp";
+
+	FILE* file = fopen(pathTemp.c_str(), "wb");
+	if (file == nullptr) return false;
+
+	uint32_t header[2] = { checkpointMagic, checkpointVersion };
+	uint64_t counts[10] = {
+		gd->dimensions,
+		gd->points,
+		gd->refineIterations,
+		gd->gradientCount,
+		gd->iterationCount,
+		gd->skipped,
+		gd->pruned,
+		static_cast<uint64_t>(gd->updates),
+		gd->extremaValid ? 1U : 0U,
+		gd->completedRanges.size()
+	};
+	double extrema[2] = { gd->minimum, gd->maximum };
+
+	bool success = (
+		fwrite(header, sizeof(header), 1, file) == 1 &&
+		fwrite(counts, sizeof(counts), 1, file) == 1 &&
+		fwrite(extrema, sizeof(extrema), 1, file) == 1 &&
+		fwrite(gd->minimumCombination, sizeof(uint64_t) * (gd->dimensions + 1) * 2, 1, file) == 1
+	);
+	for (size_t i = 0; success && i < gd->completedRanges.size(); ++i) {
+		uint64_t range[2] = { gd->completedRanges[i].first, gd->completedRanges[i].second };
+		success = (fwrite(range, sizeof(range), 1, file) == 1);
+	}
+	if (fclose(file) != 0) success = false;
+
+	// Replace the previous checkpoint only once the new one is complete
+	if (success) {
+#ifdef _WIN32
+		remove(path.c_str());
+#endif
+		success = (rename(pathTemp.c_str(), path.c_str()) == 0);
+	}
+	if (!success) remove(pathTemp.c_str());
+
+	return success;
+}
+
+bool
+readCheckpoint(
+	GlobalData* gd
+) {
+	// A missing checkpoint is a fresh start; returns false if the checkpoint is unreadable or from a different run
+	FILE* file = fopen(gd->checkpointPath, "rb");
+	if (file == nullptr) return true;
+
+	uint32_t header[2];
+	uint64_t counts[10];
+	double extrema[2];
+	uint64_t* combinations = new uint64_t[(gd->dimensions + 1) * 2];
+	vector<pair<uint64_t, uint64_t>> ranges;
+
+	bool success = (
+		fread(header, sizeof(header), 1, file) == 1 &&
+		header[0] == checkpointMagic &&
+		header[1] == checkpointVersion &&
+		fread(counts, sizeof(counts), 1, file) == 1 &&
+		counts[0] == gd->dimensions &&
+		counts[1] == gd->points &&
+		counts[2] == gd->refineIterations &&
+		counts[3] == gd->gradientCount &&
+		counts[4] == gd->iterationCount &&
+		counts[9] <= gd->iterationCount &&
+		fread(extrema, sizeof(extrema), 1, file) == 1 &&
+		fread(combinations, sizeof(uint64_t) * (gd->dimensions + 1) * 2, 1, file) == 1
+	);
+	for (uint64_t i = 0; success && i < (gd->dimensions + 1) * 2; ++i) {
+		success = (combinations[i] < gd->gradientCount);
+	}
+
+	// Ranges must be sorted, disjoint, and within the iteration count
+	uint64_t previousEnd = 0;
+	uint64_t completed = 0;
+	for (uint64_t i = 0; success && i < counts[9]; ++i) {
+		uint64_t range[2];
+		success = (
+			fread(range, sizeof(range), 1, file) == 1 &&
+			range[0] >= previousEnd &&
+			range[0] < range[1] &&
+			range[1] <= gd->iterationCount
+		);
+		if (success) {
+			ranges.push_back(pair<uint64_t, uint64_t>(range[0], range[1]));
+			previousEnd = range[1];
+			completed += range[1] - range[0];
+		}
+	}
+	success = (success && counts[5] + counts[6] <= completed);
+	fclose(file);
+
+	if (success) {
+		gd->skipped = counts[5];
+		gd->pruned = counts[6];
+		gd->updates = static_cast<int>(counts[7]);
+		gd->extremaValid = (counts[8] != 0);
+		gd->minimum = extrema[0];
+		gd->maximum = extrema[1];
+		memcpy(gd->minimumCombination, combinations, sizeof(uint64_t) * (gd->dimensions + 1) * 2);
+		gd->completedRanges.swap(ranges);
+	}
+
+	delete [] combinations;
+
+	return success;
+}
+
+void
+partitionPendingRanges(
+	GlobalData* gd
+) {
+	// The iterations not covered by completed ranges
+	uint64_t start = 0;
+	uint64_t remaining = 0;
+	gd->pendingRanges.clear();
+	for (size_t i = 0; i <= gd->completedRanges.size(); ++i) {
+		uint64_t end = (i < gd->completedRanges.size() ? gd->completedRanges[i].first : gd->iterationCount);
+		if (end > start) {
+			gd->pendingRanges.push_back(pair<uint64_t, uint64_t>(start, end));
+			remaining += end - start;
+		}
+		if (i < gd->completedRanges.size()) start = gd->completedRanges[i].second;
+	}
+
+	// Small chunks, since the cost of each gradient combination varies a lot; idle threads steal them from busy ones
+	gd->chunkSize = remaining / (static_cast<uint64_t>(gd->threadCount) * 64);
+	if (gd->chunkSize > chunkSizeLimit) gd->chunkSize = chunkSizeLimit;
+	if (gd->chunkSize < 1) gd->chunkSize = 1;
+
+	gd->chunkCount = 0;
+	gd->pendingChunkOffsets.clear();
+	for (size_t i = 0; i < gd->pendingRanges.size(); ++i) {
+		gd->pendingChunkOffsets.push_back(gd->chunkCount);
+		gd->chunkCount += (gd->pendingRanges[i].second - gd->pendingRanges[i].first + gd->chunkSize - 1) / gd->chunkSize;
+	}
+
+	gd->iterations = gd->iterationCount - remaining;
 }
 
 
@@ -422,13 +1247,15 @@ main(
 
 	if (argc <= 5) {
 		cerr << "Usage:" << endl;
-		cerr << "  " << argv[0] << " show_every threads dimensions sample_points sample_points_large" << endl;
+		cerr << "  " << argv[0] << " show_every threads dimensions sample_points refine_iterations [checkpoint [checkpoint_seconds]]" << endl;
 		cerr << endl;
 		cerr << "  show_every: true | false" << endl;
 		cerr << "  threads: number of threads (0 for auto)" << endl;
 		cerr << "  dimensions: number of dimensions (2 or greater)" << endl;
 		cerr << "  sample_points: scale of points to sample" << endl;
-		cerr << "  sample_points_large: scale of points to sample (high density)" << endl;
+		cerr << "  refine_iterations: maximum number of Newton iterations used to refine the extrema of every evaluated combination" << endl;
+		cerr << "  checkpoint: file to periodically save progress to; an existing one is resumed from" << endl;
+		cerr << "  checkpoint_seconds: time between checkpoints (default 300)" << endl;
 
 		return -1;
 	}
@@ -440,7 +1267,8 @@ main(
 	gd.displayEvery = (strcmp(argv[1], "true") == 0);
 
 	gd.threadCount = atoi(argv[2]);
-	if (gd.threadCount <= 0) gd.threadCount = getThreadCount();
+	if (gd.threadCount <= 0) gd.threadCount = static_cast<int>(std::thread::hardware_concurrency());
+	if (gd.threadCount <= 0) gd.threadCount = 1;
 
 	gd.dimensions = atoi(argv[3]);
 	if (gd.dimensions < 2) gd.dimensions = 2;
@@ -448,8 +1276,8 @@ main(
 	gd.points = atoi(argv[4]);
 	if (gd.points < 1) gd.points = 1;
 
-	gd.pointsLarge = atoi(argv[5]);
-	if (gd.pointsLarge < 1) gd.pointsLarge = 1;
+	gd.refineIterations = atoi(argv[5]);
+	if (gd.refineIterations < 1) gd.refineIterations = 1;
 
 
 	gd.gradientCount = (1 << (gd.dimensions - 1)) * gd.dimensions;
@@ -460,47 +1288,94 @@ main(
 	gd.iterationCount = hyperloop::triangle_eq::iterations<uint64_t>(gd.dimensions + 1, gd.gradientCount);
 	gd.iterations = 0;
 
+	gd.minimumCombination = new uint64_t[(gd.dimensions + 1) * 2];
+	gd.maximumCombination = &gd.minimumCombination[gd.dimensions + 1];
+	memset(gd.minimumCombination, 0, sizeof(uint64_t) * (gd.dimensions + 1) * 2);
+
+	// Branch and bound effort, relative to the cost of sampling a combination
+	gd.regionLimit = hyperloop::triangle_sum::iterations<uint64_t>(gd.dimensions, gd.points) / regionCostFactor;
+
 	gd.T = generateTMatrix(gd.dimensions);
 	gd.Tinv = matrixInverse(gd.dimensions, gd.T); // Not really needed
 	gd.simplexPoints = generateSimplexPointArray(gd.dimensions);
+	generateSymmetryTables(&gd);
+
+	// Resume, splitting the remaining work for the current thread count
+	if (argc > 6) {
+		gd.checkpointPath = argv[6];
+
+		int seconds = (argc > 7 ? atoi(argv[7]) : 300);
+		if (seconds < 0) seconds = 0;
+		gd.checkpointInterval = std::chrono::seconds(seconds);
+		gd.checkpointTime = std::chrono::steady_clock::now();
+
+		if (!readCheckpoint(&gd)) {
+			cerr << "Checkpoint " << gd.checkpointPath << " is invalid or from a run with other dimensions, sample_points or refine_iterations" << endl;
+			return -1;
+		}
+	}
+	partitionPendingRanges(&gd);
+	if (gd.iterations > 0) {
+		cout << "resumed=" << gd.iterations << "/" << gd.iterationCount << "; ranges=" << gd.completedRanges.size() <<
+			"; min=" << gd.minimum << "; max=" << gd.maximum << endl;
+	}
 
 
 
 	// Setup thread datas
+	SimplexNoiseThreadPool pool(gd.threadCount);
+
 	ThreadData* threadDatas = new ThreadData[gd.threadCount];
 	for (int i = 0; i < gd.threadCount; ++i) {
 		threadDatas[i].globalData = &gd;
 		threadDatas[i].threadIndex = i;
 		threadDatas[i].pointsDouble = gd.points;
 		threadDatas[i].gradientCount = gd.gradientCount;
-		threadDatas[i].iterationStart = (gd.iterationCount * i) / gd.threadCount;
-		threadDatas[i].iterationCount = (gd.iterationCount * (i + 1)) / gd.threadCount - threadDatas[i].iterationStart;
-		threadDatas[i].coordinates = new ThreadData::Double[(gd.dimensions + 1) * 2];
+		threadDatas[i].coordinates = new ThreadData::Double[(gd.dimensions + 1) * 3];
 		threadDatas[i].coordinatesTransformed = &threadDatas[i].coordinates[gd.dimensions + 1];
 		threadDatas[i].T = gd.T;
 		threadDatas[i].Tinv = gd.Tinv;
 		threadDatas[i].simplexPoints = gd.simplexPoints;
+		threadDatas[i].gradients = new ThreadData::Double[(gd.dimensions + 1) * gd.dimensions];
+		threadDatas[i].previousIndices = new uint64_t[gd.dimensions + 1];
+		threadDatas[i].cornerDistances = new ThreadData::Double[(gd.dimensions + 1) * 4];
+		threadDatas[i].cornerDots = &threadDatas[i].cornerDistances[(gd.dimensions + 1)];
+		threadDatas[i].stepDistances = &threadDatas[i].cornerDistances[(gd.dimensions + 1) * 2];
+		threadDatas[i].stepDots = &threadDatas[i].cornerDistances[(gd.dimensions + 1) * 3];
+		threadDatas[i].symmetryIndices = new uint64_t[gd.dimensions + 1];
+		threadDatas[i].regions = new ThreadData::Double[regionStackSize * (gd.dimensions + 1) * gd.dimensions];
+		threadDatas[i].minimumIndices = new uint64_t[(gd.dimensions + 1) * 3];
+		threadDatas[i].maximumIndices = &threadDatas[i].minimumIndices[gd.dimensions + 1];
+		threadDatas[i].refineFree = &threadDatas[i].minimumIndices[(gd.dimensions + 1) * 2];
+		threadDatas[i].refineBarycentric = new ThreadData::Double[(gd.dimensions + 1) * (gd.dimensions + 5) + (gd.dimensions + 2) * (gd.dimensions + 3)];
+		threadDatas[i].refineCartesian = new ThreadData::Double[gd.dimensions * (gd.dimensions * 2 + 4)];
+		threadDatas[i].refineCorner = &threadDatas[i].refineCartesian[gd.dimensions * (gd.dimensions * 2 + 3)];
 	}
 
 
 
-	// Spawn threads
-	int threadCount = gd.threadCount - 1;
+	// Run
+	pool.run(gd.chunkCount, [&threadDatas] (SimplexNoiseThreadPool::CountInt chunk, unsigned int thread) {
+		chunkFunction(chunk, &threadDatas[thread]);
+	});
 
-	bool okay = true;
-	for (int i = 0; i < threadCount; ++i) {
-		okay = spawnThread(threadFunction, &threadDatas[i]) && okay;
-	}
 
-	// Last thread
-	threadFunction(static_cast<void*>(&threadDatas[threadCount]));
 
-	// Join
-	joinThreads(threadCount, threadDatas);
+	// Summary
+	cout << "combinations=" << gd.iterationCount << "; evaluated=" << (gd.iterationCount - gd.skipped - gd.pruned) <<
+		"; pruned=" << gd.pruned <<
+		"; symmetry_reduction=" << (static_cast<double>(gd.iterationCount) / (gd.iterationCount - gd.skipped)) << endl;
+	if (gd.extremaValid) {
+		cout << "min_gradients=";
+		for (uint64_t i = 0; i <= gd.dimensions; ++i) cout << (i > 0 ? "," : "") << gd.minimumCombination[i];
+		cout << "; max_gradients=";
+		for (uint64_t i = 0; i <= gd.dimensions; ++i) cout << (i > 0 ? "," : "") << gd.maximumCombination[i];
+		cout << endl;
+	}
 
-	// Clean
-	for (int i = 0; i < threadCount; ++i) {
-		completeThread(&threadDatas[i]);
+	// Final checkpoint, so a finished run isn't repeated
+	if (gd.checkpointPath != nullptr && !writeCheckpoint(&gd)) {
+		cerr << "Failed to write checkpoint " << gd.checkpointPath << endl;
 	}
 
 
@@ -510,11 +1385,15 @@ main(
 	delete [] gd.Tinv;
 	delete [] gd.T;
 	delete [] gd.simplexPoints;
+	delete [] gd.gradientNegation;
+	delete [] gd.gradientReflection;
+	delete [] gd.cornerReflection;
+	delete [] gd.minimumCombination;
 
 
 
 	// Done
-	return okay ? 0 : -2;
+	return 0;
 }
 
 
@@ -1,7 +1,11 @@
 #ifndef ___H_SOLVER
 #define ___H_SOLVER
 
+#include <chrono>
 #include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 
 
@@ -9,11 +13,22 @@
 class GlobalData;
 class ThreadData;
 
+
+
+// Constants
+constexpr uint64_t regionCostFactor = 64; // canImprove bounds at most (samples per combination / regionCostFactor) sub-simplices
+constexpr uint64_t regionStackSize = 128; // Maximum number of sub-simplices pending in canImprove
+constexpr uint64_t boundBackoffLimit = 63; // Maximum number of combinations sampled without bounding after canImprove fails
+constexpr double boundMargin = 1e-12; // Slack for rounding differences between bounds and samples
+constexpr uint64_t chunkSizeLimit = 4096; // Maximum number of combinations per chunk, so checkpoints don't lag far behind the work done
+constexpr uint32_t checkpointMagic = 0x4b435353; // "SSCK" in little endian
+constexpr uint32_t checkpointVersion = 1;
+
 class GlobalData {
 public:
 	typedef double Double;
 
-	CRITICAL_SECTION lock;
+	std::mutex lock;
 
 	int threadCount;
 
@@ -21,19 +36,42 @@ public:
 
 	uint64_t dimensions;
 	uint64_t points;
-	uint64_t pointsLarge;
+	uint64_t refineIterations;
 
 	uint64_t gradientCount;
 	uint64_t iterationCount;
 	uint64_t iterations;
+	uint64_t chunkSize;
+	uint64_t chunkCount;
+	uint64_t regionLimit;
+
+	// Iteration ranges [first, second); pendingChunkOffsets[i] is the index of the first chunk of pendingRanges[i]
+	std::vector<std::pair<uint64_t, uint64_t>> completedRanges;
+	std::vector<std::pair<uint64_t, uint64_t>> pendingRanges;
+	std::vector<uint64_t> pendingChunkOffsets;
+
+	const char* checkpointPath;
+	std::chrono::steady_clock::duration checkpointInterval;
+	std::chrono::steady_clock::time_point checkpointTime;
+	bool checkpointFailed;
 
 	Double* T;
 	Double* Tinv;
 	Double* simplexPoints;
 
+	// Symmetries of the simplex; see generateSymmetryTables
+	uint64_t* gradientNegation;
+	uint64_t* gradientReflection;
+	uint64_t* cornerReflection;
+	uint64_t skipped;
+	uint64_t pruned;
+
 	int updates;
+	bool extremaValid;
 	Double minimum;
 	Double maximum;
+	uint64_t* minimumCombination; // Gradient indices of the combinations with the minimum and maximum
+	uint64_t* maximumCombination;
 
 	GlobalData();
 	~GlobalData();
@@ -42,8 +80,21 @@ public:
 	updateExtrema(
 		const ThreadData* tData,
 		Double minimum,
-		Double maximum,
-		bool updateCount
+		Double maximum
+	);
+
+	void
+	completeRange(
+		uint64_t start,
+		uint64_t count,
+		uint64_t skippedCount,
+		uint64_t prunedCount
+	);
+
+	bool
+	getExtrema(
+		Double* minimum,
+		Double* maximum
 	);
 
 };
@@ -52,13 +103,10 @@ class ThreadData {
 public:
 	typedef double Double;
 
-	HANDLE threadHandle;
 	GlobalData* globalData;
 	int threadIndex;
 	Double pointsDouble;
 	uint64_t gradientCount;
-	uint64_t iterationStart;
-	uint64_t iterationCount;
 	uint64_t iterations;
 	Double* coordinates;
 	Double* coordinatesTransformed;
@@ -68,6 +116,31 @@ public:
 	Double* gradients;
 	Double minimum;
 	Double maximum;
+	uint64_t skipped;
+	uint64_t pruned;
+	uint64_t boundBackoff;
+	uint64_t boundCountdown;
+	uint64_t* symmetryIndices;
+	const uint64_t* combination; // The gradient indices being evaluated; negated if the extremum came from the negated combination
+	bool minimumNegated;
+	bool maximumNegated;
+	Double* regions; // Stack of sub-simplices for canImprove; regionStackSize * (dimensions + 1) * dimensions values
+	uint64_t* minimumIndices; // Sample indices of the minimum and maximum, refined by refineExtremum
+	uint64_t* maximumIndices;
+	uint64_t* refineFree;
+	Double* refineBarycentric;
+	Double* refineCartesian;
+	Double* refineCorner;
+
+	// Per-corner terms of the current sample, updated incrementally; see updateCornerTerms
+	uint64_t* previousIndices;
+	bool previousValid;
+	Double* cornerDistances; // |x - simplexPoints[i]|^2
+	Double* cornerDots; // (x - simplexPoints[i]) . gradients[i]
+	Double* stepDistances; // simplexPoints[i] . step
+	Double* stepDots; // gradients[i] . step
+	Double stepLengthSquared; // step . step
+	Double stepProjection; // x . step
 
 	ThreadData();
 	~ThreadData();
@@ -76,36 +149,83 @@ public:
 
 
 
-// Threading
-int
-getThreadCount();
+// Primary looping functions
+void
+chunkFunction(
+	uint64_t chunk,
+	ThreadData* tData
+);
 
-bool
-spawnThread(
-	LPTHREAD_START_ROUTINE function,
-	ThreadData* threadInfo
+void gradientLoop(
+	uint64_t dimensions,
+	uint64_t sum,
+	const uint64_t* indices,
+	ThreadData* tData
 );
 
 void
-joinThreads(
-	int threadCount,
-	ThreadData* threadInfos
+setGradient(
+	uint64_t dimensions,
+	uint64_t index,
+	double* gradient
 );
 
 void
-completeThread(
-	ThreadData* threadInfo
+generateSymmetryTables(
+	GlobalData* gd
 );
 
+bool
+isCanonicalCombination(
+	const uint64_t* indices,
+	ThreadData* tData,
+	bool* negated
+);
 
+double
+evaluateNoise(
+	ThreadData* tData,
+	const double* x,
+	double* gradient,
+	double* hessian
+);
 
-// Primary looping functions
-DWORD WINAPI
-threadFunction(
-	void* data
+double
+refineExtremum(
+	ThreadData* tData,
+	const uint64_t* indices,
+	double sign
 );
 
-void gradientLoop(
+bool
+canImprove(
+	ThreadData* tData,
+	bool negated
+);
+
+double
+integerPower(
+	double value,
+	int exponent
+);
+
+void
+boundRegion(
+	uint64_t dimensions,
+	const double* vertices,
+	ThreadData* tData,
+	double* lower,
+	double* upper
+);
+
+void
+prepareCornerTerms(
+	uint64_t dimensions,
+	ThreadData* tData
+);
+
+void
+updateCornerTerms(
 	uint64_t dimensions,
 	uint64_t sum,
 	const uint64_t* indices,
@@ -130,6 +250,24 @@ iterateFunctionPow4(
 
 
 
+// Checkpoints
+bool
+writeCheckpoint(
+	GlobalData* gd
+);
+
+bool
+readCheckpoint(
+	GlobalData* gd
+);
+
+void
+partitionPendingRanges(
+	GlobalData* gd
+);
+
+
+
 // Main
 int
 main(
@@ -2,6 +2,9 @@
 	Templated SimplexNoise
 */
 #include "SimplexNoise.hpp"
+#include <list>
+#include <mutex>
+#include <unordered_map>
 
 
 
@@ -130,3 +133,228 @@ const unsigned char SimplexNoiseBase :: perm[512] = {
 	222, 114, 67 , 29 , 24 , 72 , 243, 141, 128, 195, 78 , 66 , 215, 61 , 156, 180,*/
 };
 
+
+
+// Seeded permutations
+struct SimplexNoisePermutationCacheEntry {
+	unsigned char perm[512];
+	std::size_t references;
+};
+
+struct SimplexNoisePermutationCache {
+	// Unreferenced tables are kept for a while, so a seed which is repeatedly created and destroyed isn't reshuffled every time
+	static constexpr std::size_t releasedLimit = 8;
+
+	std::mutex mutex;
+	std::unordered_map<SimplexNoiseBase::SeedInt, SimplexNoisePermutationCacheEntry*> entries;
+	std::list<SimplexNoiseBase::SeedInt> released; // Seeds of the unreferenced entries, most recently released first
+
+	~SimplexNoisePermutationCache() {
+		for (auto& entry : this->entries) delete entry.second;
+	}
+};
+
+static SimplexNoisePermutationCache&
+getPermutationCache() {
+	// Function local so that it's constructed before any static SimplexNoise instances use it
+	static SimplexNoisePermutationCache cache;
+	return cache;
+}
+
+static uint64_t
+splitMix64(
+	uint64_t& state
+) {
+	uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+bool
+SimplexNoiseBase :: validatePermutation(
+	const unsigned char* permutationArray
+) {
+	assert(permutationArray != nullptr);
+
+	// Same as validate and validate2 of the python script above
+	bool minOk = false;
+	bool maxOk = false;
+	bool minOk2 = false;
+	bool maxOk2 = false;
+	unsigned int n1, n2;
+
+	for (unsigned int i = 0; i < 256; ++i) {
+		n1 = permutationArray[i] & 0xF;
+		n2 = permutationArray[(i + 1) & 0xFF] & 0xF;
+		minOk = minOk || (n1 == 0xF && n2 == 0x7);
+		maxOk = maxOk || (n1 == 0x7 && n2 == 0xF);
+		minOk2 = minOk2 || (n1 == 0xF && n2 == 0xF);
+		maxOk2 = maxOk2 || (n1 == 0x7 && n2 == 0x7);
+	}
+
+	return minOk && maxOk && minOk2 && maxOk2;
+}
+
+void
+SimplexNoiseBase :: generatePermutation(
+	SeedInt seed,
+	unsigned char* permutationArray
+) {
+	assert(permutationArray != nullptr);
+
+	uint64_t state = seed;
+	uint64_t r;
+	unsigned int i, j;
+	unsigned char t;
+
+	for (i = 0; i < 256; ++i) {
+		permutationArray[i] = static_cast<unsigned char>(i);
+	}
+
+	// Fisher-Yates shuffle until valid; this takes a few attempts on average
+	do {
+		for (i = 255; i > 0; --i) {
+			// Unbiased random in [0,i]
+			do {
+				r = splitMix64(state);
+			}
+			while (r < (0 - static_cast<uint64_t>(i + 1)) % (i + 1));
+			j = static_cast<unsigned int>(r % (i + 1));
+
+			t = permutationArray[i];
+			permutationArray[i] = permutationArray[j];
+			permutationArray[j] = t;
+		}
+	}
+	while (!SimplexNoiseBase::validatePermutation(permutationArray));
+
+	// Duplicate
+	for (i = 0; i < 256; ++i) {
+		permutationArray[i + 256] = permutationArray[i];
+	}
+}
+
+const unsigned char*
+SimplexNoiseBase :: acquirePermutation(
+	SeedInt seed
+) {
+	SimplexNoisePermutationCache& cache = getPermutationCache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	SimplexNoisePermutationCacheEntry*& entry = cache.entries[seed];
+	if (entry == nullptr) {
+		entry = new SimplexNoisePermutationCacheEntry();
+		entry->references = 0;
+		SimplexNoiseBase::generatePermutation(seed, entry->perm);
+	}
+	else if (entry->references == 0) {
+		cache.released.remove(seed);
+	}
+
+	++entry->references;
+	return entry->perm;
+}
+
+void
+SimplexNoiseBase :: releasePermutation(
+	SeedInt seed
+) {
+	SimplexNoisePermutationCache& cache = getPermutationCache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	auto it = cache.entries.find(seed);
+	assert(it != cache.entries.end());
+	assert(it->second->references > 0);
+
+	if (--it->second->references > 0) return;
+
+	// Keep the table, evicting the least recently released one if there are too many
+	cache.released.push_front(seed);
+	if (cache.released.size() > SimplexNoisePermutationCache::releasedLimit) {
+		it = cache.entries.find(cache.released.back());
+		assert(it != cache.entries.end());
+		assert(it->second->references == 0);
+
+		delete it->second;
+		cache.entries.erase(it);
+		cache.released.pop_back();
+	}
+}
+
+
+
+// Chunk origins
+// The skew factors of 2d, 3d and 4d noise as 128-bit fixed point fractions: { high 64 bits, low 64 bits }
+static const uint64_t chunkSkewFactors[3][2] = {
+	{ 0x5DB3D742C265539DULL, 0x92BA16B83C5C1DC4ULL }, // (sqrt(3) - 1) / 2
+	{ 0x5555555555555555ULL, 0x5555555555555555ULL }, // 1 / 3
+	{ 0x4F1BBCDCBFA53E0AULL, 0xF9CE60302E76E41AULL }, // (sqrt(5) - 1) / 4
+};
+
+// The full 128-bit product of a * b
+static void
+multiply128(
+	uint64_t a,
+	uint64_t b,
+	uint64_t& high,
+	uint64_t& low
+) {
+	uint64_t a0 = a & 0xFFFFFFFFULL;
+	uint64_t a1 = a >> 32;
+	uint64_t b0 = b & 0xFFFFFFFFULL;
+	uint64_t b1 = b >> 32;
+	uint64_t p00 = a0 * b0;
+	uint64_t p01 = a0 * b1;
+	uint64_t p10 = a1 * b0;
+	uint64_t p11 = a1 * b1;
+	uint64_t middle = (p00 >> 32) + (p01 & 0xFFFFFFFFULL) + (p10 & 0xFFFFFFFFULL);
+
+	low = (middle << 32) | (p00 & 0xFFFFFFFFULL);
+	high = p11 + (p01 >> 32) + (p10 >> 32) + (middle >> 32);
+}
+
+double
+SimplexNoiseBase :: skewChunkOrigin(
+	int dimensions,
+	const LatticeInt* origin,
+	int32_t* latticeOffset
+) {
+	assert(dimensions >= 2 && dimensions <= 4);
+	assert(origin != nullptr);
+	assert(latticeOffset != nullptr);
+
+	const uint64_t* factor = chunkSkewFactors[dimensions - 2];
+	uint64_t sum = 0;
+	uint64_t magnitude, high, low, high2, low2;
+	uint64_t whole, fraction;
+	int k;
+
+	for (k = 0; k < dimensions; ++k) {
+		sum += static_cast<uint64_t>(origin[k]);
+	}
+	bool negative = (static_cast<LatticeInt>(sum) < 0);
+	magnitude = negative ? (0 - sum) : sum;
+
+	// |sum| * factor = whole + fraction / 2^64; the dropped low bits are below 2^-64
+	multiply128(magnitude, factor[0], high, low);
+	multiply128(magnitude, factor[1], high2, low2);
+	fraction = low + high2;
+	whole = high + (fraction < low ? 1 : 0);
+
+	// Negate; the fraction must stay in [0,1)
+	if (negative) {
+		whole = 0 - whole;
+		if (fraction != 0) {
+			whole -= 1;
+			fraction = 0 - fraction;
+		}
+	}
+
+	// Only the lowest 8 bits of the lattice indices are used
+	for (k = 0; k < dimensions; ++k) {
+		latticeOffset[k] = static_cast<int32_t>((static_cast<uint64_t>(origin[k]) + whole) & 0xFF);
+	}
+
+	return static_cast<double>(fraction) * 5.421010862427522170037264e-20; // 2^-64
+}
@@ -7,6 +7,7 @@
 
 
 #include <cstdint>
+#include <cstddef>
 #include <cassert>
 
 
@@ -48,25 +49,76 @@ class SimplexNoise;
 template <typename Float, int Dimensions>
 class SimplexNoiseHelper;
 
+template <typename Float>
+class SimplexNoisePower;
+
+class SimplexNoiseSimd;
+
 
 
 // Base class
 class SimplexNoiseBase {
-protected:
+public: // Public types
+	typedef uint64_t SeedInt;
+	typedef int64_t LatticeInt;
+
+public: // Public static methods
+	// Fills permutationArray[0:512] with a permutation generated from seed; the result is always valid
+	static void generatePermutation(
+		SeedInt seed,
+		unsigned char* permutationArray
+	);
+
+	// Checks that permutationArray[0:256] allows the 1D noise to reach the full [-1,1] range
+	static bool validatePermutation(
+		const unsigned char* permutationArray
+	);
+
+protected: // Protected static members
 	static const unsigned char perm[];
 
+protected: // Protected static methods
+	// Shared, reference counted permutations; each acquire must be paired with a release.
+	// The last few released permutations stay cached, so re-acquiring them doesn't regenerate them.
+	static const unsigned char* acquirePermutation(
+		SeedInt seed
+	);
+
+	static void releasePermutation(
+		SeedInt seed
+	);
+
+	// Splits the skewed coordinate sum of a 2d to 4d chunk origin, which is computed exactly in 128-bit fixed point,
+	// into a whole part which is added to each axis' lattice offset (truncated to [0,255]), and the returned fraction in [0,1]
+	static double skewChunkOrigin(
+		int dimensions,
+		const LatticeInt* origin,
+		int32_t* latticeOffset
+	);
+
 };
 
 
 
 // Primary class
+// With Float = float, the results differ from SimplexNoise<double> at the same coordinates by less than about
+// 9 * (1 + |coordinate|) * FLT_EPSILON for values and 40 * (1 + |coordinate|) * FLT_EPSILON for derivatives;
+// the largest differences measured by validate/validate.cpp over 1M samples per set were 8.4 and 38 of these units.
+// The chunk variants bound |coordinate| by the local offset instead.
 template <typename Float>
 class SimplexNoise : public SimplexNoiseBase {
 public: // Public types
 	typedef int32_t HashInt;
 	typedef uint32_t OctavesInt;
+	typedef std::size_t CountInt;
 
 public: // Public static methods
+	// Noise using a permutation generated from seed; instances with the same seed share the permutation.
+	// This is a factory rather than a constructor, since SimplexNoise(0) would be ambiguous with SimplexNoise(const unsigned char*).
+	static SimplexNoise<Float> fromSeed(
+		SeedInt seed
+	);
+
 	template <typename Integer>
 	static Integer fast_floor(
 		Float x
@@ -77,38 +129,146 @@ public: // Public static methods
 		Float x
 	);
 
+private: // Private static members
+	static constexpr unsigned int batchSize = 64;
+	static constexpr int maxStackDimensions = 64;
+
 private: // Private instance members
 	const unsigned char* perm;
+	SeedInt seed;
+	bool seeded;
 
 public: // Public instance methods
 	SimplexNoise();
 	SimplexNoise(
 		const unsigned char* perm
 	);
+	SimplexNoise(
+		const SimplexNoise<Float>& other
+	);
 	~SimplexNoise();
 
+	SimplexNoise<Float>& operator = (
+		const SimplexNoise<Float>& other
+	);
+
 	// Noise functions
 	FAST_MATH(Float noise1(Float x));
 	FAST_MATH(Float noise1(Float x, Float* dx));
 	FAST_MATH(Float noise1_octaves(OctavesInt octaves, Float x));
 	FAST_MATH(Float noise1_octaves(OctavesInt octaves, Float x, Float* dx));
+	FAST_MATH(void noise1_batch(CountInt count, const Float* xs, Float* out));
 
 	FAST_MATH(Float noise2(Float x, Float y));
 	FAST_MATH(Float noise2(Float x, Float y, Float* dx, Float* dy));
 	FAST_MATH(Float noise2_octaves(OctavesInt octaves, Float x, Float y));
 	FAST_MATH(Float noise2_octaves(OctavesInt octaves, Float x, Float y, Float* dx, Float* dy));
+	FAST_MATH(void noise2_batch(CountInt count, const Float* xs, const Float* ys, Float* out));
+	FAST_MATH(void noise2_gradient_batch(CountInt count, const Float* xs, const Float* ys, Float* out, CountInt stride, CountInt componentStride));
+	FAST_MATH(void fill_grid2(Float x0, Float y0, Float dx, Float dy, CountInt width, CountInt height, Float* out, CountInt stride));
+	// Tileable variants on an axis aligned lattice; they repeat every period units along each axis, with 0 meaning no period.
+	// The lattice of the 2d variant only repeats every 2 units along y, so periodY must be even
+	FAST_MATH(Float noise2_periodic(Float x, Float y, HashInt periodX, HashInt periodY));
+	FAST_MATH(Float noise2_periodic_octaves(OctavesInt octaves, Float x, Float y, HashInt periodX, HashInt periodY));
+	FAST_MATH(void noise2_periodic_batch(CountInt count, const Float* xs, const Float* ys, HashInt periodX, HashInt periodY, Float* out));
+	// Variants for very large worlds; the position is a chunk origin plus a local offset, and since the lattice position of the origin is
+	// found using 64-bit integers, the precision only depends on the size of the local offset. The origin's coordinates must sum to within 64 bits
+	FAST_MATH(Float noise2_chunk(LatticeInt chunkX, LatticeInt chunkY, Float x, Float y));
+	FAST_MATH(void noise2_chunk_batch(LatticeInt chunkX, LatticeInt chunkY, CountInt count, const Float* xs, const Float* ys, Float* out));
 
 	FAST_MATH(Float noise3(Float x, Float y, Float z));
 	FAST_MATH(Float noise3(Float x, Float y, Float z, Float* dx, Float* dy, Float* dz));
 	FAST_MATH(Float noise3_octaves(OctavesInt octaves, Float x, Float y, Float z));
 	FAST_MATH(Float noise3_octaves(OctavesInt octaves, Float x, Float y, Float z, Float* dx, Float* dy, Float* dz));
+	FAST_MATH(void noise3_batch(CountInt count, const Float* xs, const Float* ys, const Float* zs, Float* out));
+	FAST_MATH(void noise3_gradient_batch(CountInt count, const Float* xs, const Float* ys, const Float* zs, Float* out, CountInt stride, CountInt componentStride));
+	FAST_MATH(void curl3(Float x, Float y, Float z, Float* cx, Float* cy, Float* cz));
+	FAST_MATH(void curl3_batch(CountInt count, const Float* xs, const Float* ys, const Float* zs, Float* out, CountInt stride, CountInt componentStride));
+	FAST_MATH(void fill_grid3(Float x0, Float y0, Float z, Float dx, Float dy, CountInt width, CountInt height, Float* out, CountInt stride));
+	FAST_MATH(Float noise3_periodic(Float x, Float y, Float z, HashInt periodX, HashInt periodY, HashInt periodZ));
+	FAST_MATH(Float noise3_periodic_octaves(OctavesInt octaves, Float x, Float y, Float z, HashInt periodX, HashInt periodY, HashInt periodZ));
+	FAST_MATH(void noise3_periodic_batch(CountInt count, const Float* xs, const Float* ys, const Float* zs, HashInt periodX, HashInt periodY, HashInt periodZ, Float* out));
+	FAST_MATH(Float noise3_chunk(LatticeInt chunkX, LatticeInt chunkY, LatticeInt chunkZ, Float x, Float y, Float z));
+	FAST_MATH(void noise3_chunk_batch(LatticeInt chunkX, LatticeInt chunkY, LatticeInt chunkZ, CountInt count, const Float* xs, const Float* ys, const Float* zs, Float* out));
 
 	FAST_MATH(Float noise4(Float x, Float y, Float z, Float w));
 	FAST_MATH(Float noise4(Float x, Float y, Float z, Float w, Float* dx, Float* dy, Float* dz, Float* dw));
 	FAST_MATH(Float noise4_octaves(OctavesInt octaves, Float x, Float y, Float z, Float w));
 	FAST_MATH(Float noise4_octaves(OctavesInt octaves, Float x, Float y, Float z, Float w, Float* dx, Float* dy, Float* dz, Float* dw));
+	FAST_MATH(void noise4_batch(CountInt count, const Float* xs, const Float* ys, const Float* zs, const Float* ws, Float* out));
+	FAST_MATH(void noise4_gradient_batch(CountInt count, const Float* xs, const Float* ys, const Float* zs, const Float* ws, Float* out, CountInt stride, CountInt componentStride));
+	FAST_MATH(void fill_grid4(Float x0, Float y0, Float z, Float w, Float dx, Float dy, CountInt width, CountInt height, Float* out, CountInt stride));
+	FAST_MATH(Float noise4_chunk(LatticeInt chunkX, LatticeInt chunkY, LatticeInt chunkZ, LatticeInt chunkW, Float x, Float y, Float z, Float w));
+	FAST_MATH(void noise4_chunk_batch(LatticeInt chunkX, LatticeInt chunkY, LatticeInt chunkZ, LatticeInt chunkW, CountInt count, const Float* xs, const Float* ys, const Float* zs, const Float* ws, Float* out));
 
 	FAST_MATH(Float noise_n(Float maxRadius, Float power, int dimensions, const Float* position));
+	FAST_MATH(Float noise_n(Float maxRadius, const SimplexNoisePower<Float>& power, int dimensions, const Float* position));
+	template <int Dimensions>
+	FAST_MATH(Float noise(Float maxRadius, Float power, const Float* position));
+	template <int Dimensions>
+	FAST_MATH(Float noise(Float maxRadius, const SimplexNoisePower<Float>& power, const Float* position));
+
+private: // Private static methods
+	// Wraps a lattice coordinate into [0,period); a period of 0 leaves it as is
+	static HashInt wrap_period(
+		HashInt value,
+		HashInt period
+	);
+
+	// Moves a position into [0,period), up to rounding; a period of 0 leaves it as is
+	static Float wrap_position(
+		Float value,
+		HashInt period
+	);
+
+private: // Private instance methods
+	// The batch functions, with latticeOffset (one value per dimension, or nullptr) added to the lattice indices before they're truncated to [0,255]
+	FAST_MATH(void noise2_batch_offset(CountInt count, const Float* xs, const Float* ys, const HashInt* latticeOffset, Float* out));
+	FAST_MATH(void noise3_batch_offset(CountInt count, const Float* xs, const Float* ys, const Float* zs, const HashInt* latticeOffset, Float* out));
+	FAST_MATH(void noise4_batch_offset(CountInt count, const Float* xs, const Float* ys, const Float* zs, const Float* ws, const HashInt* latticeOffset, Float* out));
+
+	template <int Dimensions>
+	FAST_MATH(Float noise_n_scratch(Float maxRadius, const SimplexNoisePower<Float>& power, int dimensions, const Float* position, Float* point0, Float* point1, Float* gradient, HashInt* pointFloor, HashInt* pointRank, HashInt* simplexOrder));
+
+};
+
+
+
+// Falloff power for noise_n; integer and half-integer powers are detected once on construction
+// and evaluated using multiplications (and a square root) instead of pow.
+// The results can differ from pow in the last few bits, so the noise_n overloads taking a plain
+// Float power always use pow, and only the overloads taking a SimplexNoisePower use the fast path.
+template <typename Float>
+class SimplexNoisePower final {
+private: // Private types
+	enum class Mode {
+		Integer,
+		HalfInteger,
+		General,
+	};
+
+private: // Private static members
+	static constexpr unsigned int maxExponent = 64;
+
+private: // Private instance members
+	Float power;
+	Mode mode;
+	unsigned int exponent;
+
+public: // Public instance methods
+	// If fast is false, pow is always used
+	explicit SimplexNoisePower(
+		Float power,
+		bool fast = true
+	);
+
+	Float
+	getPower() const;
+
+	Float
+	apply(
+		Float value
+	) const;
 
 };
 
@@ -130,6 +290,8 @@ public:
 		int dimensions
 	);
 
+	// A non-zero Dimensions must equal dimensions, and makes the loop bounds below compile time constants
+	template <int Dimensions = 0>
 	static void
 	skewPoint(
 		int dimensions,
@@ -137,6 +299,7 @@ public:
 		Float* position
 	);
 
+	template <int Dimensions = 0>
 	static void
 	deskewPoint(
 		int dimensions,
@@ -146,6 +309,7 @@ public:
 		Float* position
 	);
 
+	template <int Dimensions = 0>
 	static Float
 	dot(
 		int dimensions,
@@ -153,6 +317,7 @@ public:
 		const Float* point2
 	);
 
+	template <int Dimensions = 0>
 	static void
 	gradient(
 		int dimensions,
@@ -164,6 +329,307 @@ public:
 
 };
 
+// Vectorized kernels; see SimplexNoiseSimd.cpp
+// Each kernel returns how many of the leading values it computed (a multiple of its vector width),
+// or 0 if the CPU doesn't support it; the caller computes the remainder using the scalar code.
+// The latticeOffset of noise2/3/4 has one value per dimension which is added to the lattice indices
+// before they are truncated to [0,255]; nullptr means no offset.
+class SimplexNoiseSimd final {
+public:
+	typedef std::size_t CountInt;
+
+	static bool
+	hasAvx2();
+
+	static bool
+	hasAvx512f();
+
+	static CountInt
+	noise2(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const float* xs,
+		const float* ys,
+		const int32_t* latticeOffset,
+		float* out
+	);
+
+	static CountInt
+	noise2(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const double* xs,
+		const double* ys,
+		const int32_t* latticeOffset,
+		double* out
+	);
+
+	template <typename Float>
+	static CountInt
+	noise2(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const Float* xs,
+		const Float* ys,
+		const int32_t* latticeOffset,
+		Float* out
+	);
+
+	static CountInt
+	noise3(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const float* xs,
+		const float* ys,
+		const float* zs,
+		const int32_t* latticeOffset,
+		float* out
+	);
+
+	static CountInt
+	noise3(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const double* xs,
+		const double* ys,
+		const double* zs,
+		const int32_t* latticeOffset,
+		double* out
+	);
+
+	template <typename Float>
+	static CountInt
+	noise3(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const Float* xs,
+		const Float* ys,
+		const Float* zs,
+		const int32_t* latticeOffset,
+		Float* out
+	);
+
+	static CountInt
+	noise4(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const float* xs,
+		const float* ys,
+		const float* zs,
+		const float* ws,
+		const int32_t* latticeOffset,
+		float* out
+	);
+
+	static CountInt
+	noise4(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const double* xs,
+		const double* ys,
+		const double* zs,
+		const double* ws,
+		const int32_t* latticeOffset,
+		double* out
+	);
+
+	template <typename Float>
+	static CountInt
+	noise4(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const Float* xs,
+		const Float* ys,
+		const Float* zs,
+		const Float* ws,
+		const int32_t* latticeOffset,
+		Float* out
+	);
+
+	static CountInt
+	noise2_gradient(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const float* xs,
+		const float* ys,
+		float* out,
+		CountInt stride,
+		CountInt componentStride
+	);
+
+	static CountInt
+	noise2_gradient(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const double* xs,
+		const double* ys,
+		double* out,
+		CountInt stride,
+		CountInt componentStride
+	);
+
+	template <typename Float>
+	static CountInt
+	noise2_gradient(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const Float* xs,
+		const Float* ys,
+		Float* out,
+		CountInt stride,
+		CountInt componentStride
+	);
+
+	static CountInt
+	noise3_gradient(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const float* xs,
+		const float* ys,
+		const float* zs,
+		float* out,
+		CountInt stride,
+		CountInt componentStride
+	);
+
+	static CountInt
+	noise3_gradient(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const double* xs,
+		const double* ys,
+		const double* zs,
+		double* out,
+		CountInt stride,
+		CountInt componentStride
+	);
+
+	template <typename Float>
+	static CountInt
+	noise3_gradient(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const Float* xs,
+		const Float* ys,
+		const Float* zs,
+		Float* out,
+		CountInt stride,
+		CountInt componentStride
+	);
+
+	static CountInt
+	curl3(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const float* xs,
+		const float* ys,
+		const float* zs,
+		float* out,
+		CountInt stride,
+		CountInt componentStride
+	);
+
+	static CountInt
+	curl3(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const double* xs,
+		const double* ys,
+		const double* zs,
+		double* out,
+		CountInt stride,
+		CountInt componentStride
+	);
+
+	template <typename Float>
+	static CountInt
+	curl3(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const Float* xs,
+		const Float* ys,
+		const Float* zs,
+		Float* out,
+		CountInt stride,
+		CountInt componentStride
+	);
+
+	static CountInt
+	noise2_periodic(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const float* xs,
+		const float* ys,
+		int32_t periodX,
+		int32_t periodY,
+		float* out
+	);
+
+	static CountInt
+	noise2_periodic(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const double* xs,
+		const double* ys,
+		int32_t periodX,
+		int32_t periodY,
+		double* out
+	);
+
+	template <typename Float>
+	static CountInt
+	noise2_periodic(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const Float* xs,
+		const Float* ys,
+		int32_t periodX,
+		int32_t periodY,
+		Float* out
+	);
+
+	static CountInt
+	noise3_periodic(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const float* xs,
+		const float* ys,
+		const float* zs,
+		int32_t periodX,
+		int32_t periodY,
+		int32_t periodZ,
+		float* out
+	);
+
+	static CountInt
+	noise3_periodic(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const double* xs,
+		const double* ys,
+		const double* zs,
+		int32_t periodX,
+		int32_t periodY,
+		int32_t periodZ,
+		double* out
+	);
+
+	template <typename Float>
+	static CountInt
+	noise3_periodic(
+		const unsigned char* permutationArray,
+		CountInt count,
+		const Float* xs,
+		const Float* ys,
+		const Float* zs,
+		int32_t periodX,
+		int32_t periodY,
+		int32_t periodZ,
+		Float* out
+	);
+
+};
+
 template <typename Float, int Dimensions>
 class SimplexNoiseHelper final {
 public:
@@ -210,6 +676,7 @@ public:
 template <typename Float>
 class SimplexNoiseHelper<Float, 2> final {
 private:
+	friend class SimplexNoiseSimd;
 	static const signed char gradientTable[][2];
 
 public:
@@ -253,6 +720,18 @@ public:
 	static constexpr Float
 	unnormalizedMaximum();
 
+	// The periodic variant uses an axis aligned lattice with vertices at (i - j / 2, j);
+	// vertices are hashed by their doubled x and their y coordinates
+	static HashInt
+	periodicGradientHash(
+		const unsigned char* permutationArray,
+		HashInt x2,
+		HashInt y
+	);
+
+	static constexpr Float
+	periodicUnnormalizedMaximum();
+
 };
 
 template <typename Float>
@@ -265,6 +744,9 @@ private:
 public:
 	typedef typename SimplexNoise<Float>::HashInt HashInt;
 
+	// Lattice offsets of the potential components used by SimplexNoise<Float>::curl3
+	static const unsigned char curlOffsets[][3];
+
 	static constexpr Float
 	skewFactor();
 
@@ -308,11 +790,25 @@ public:
 	static constexpr Float
 	unnormalizedMaximum();
 
+	// The periodic variant uses the axis aligned body centered cubic lattice, with vertices at
+	// (-i + j + k, i - j + k, i + j - k) / 2; vertices are hashed by their doubled coordinates
+	static HashInt
+	periodicGradientHash(
+		const unsigned char* permutationArray,
+		HashInt x2,
+		HashInt y2,
+		HashInt z2
+	);
+
+	static constexpr Float
+	periodicUnnormalizedMaximum();
+
 };
 
 template <typename Float>
 class SimplexNoiseHelper<Float, 4> final {
 private:
+	friend class SimplexNoiseSimd;
 	static const signed char gradientTable[][4];
 
 public:
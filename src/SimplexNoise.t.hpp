@@ -5,11 +5,60 @@
 #include <limits>
 #include <type_traits>
 #include <cmath>
+#include <array>
 #include <iostream>
 using namespace std;
 
 
 
+// SimplexNoisePower<Float>
+template <typename Float>
+SimplexNoisePower<Float> :: SimplexNoisePower(
+	Float power,
+	bool fast
+) :
+	power(power),
+	mode(Mode::General),
+	exponent(0)
+{
+	assert(power > 0);
+
+	Float twice = power * 2;
+	if (fast && twice == ::floor(twice) && twice <= static_cast<Float>(maxExponent * 2)) {
+		unsigned int t = static_cast<unsigned int>(twice);
+		this->mode = ((t & 0x1) == 0) ? Mode::Integer : Mode::HalfInteger;
+		this->exponent = t / 2;
+	}
+}
+
+template <typename Float>
+Float
+SimplexNoisePower<Float> :: getPower() const {
+	return this->power;
+}
+
+template <typename Float>
+Float
+SimplexNoisePower<Float> :: apply(
+	Float value
+) const {
+	assert(value >= 0);
+
+	if (this->mode == Mode::General) {
+		return ::pow(value, this->power);
+	}
+
+	// Exponentiation by squaring
+	Float result = (this->mode == Mode::HalfInteger) ? ::sqrt(value) : static_cast<Float>(1);
+	for (unsigned int e = this->exponent; e != 0; e >>= 1) {
+		if ((e & 0x1) != 0) result *= value;
+		value *= value;
+	}
+	return result;
+}
+
+
+
 // SimplexNoiseGenericHelper<Float>
 template <typename Float>
 Float
@@ -28,6 +77,7 @@ SimplexNoiseGenericHelper<Float> :: deskewFactor(
 }
 
 template <typename Float>
+template <int Dimensions>
 void
 SimplexNoiseGenericHelper<Float> :: skewPoint(
 	int dimensions,
@@ -35,20 +85,24 @@ SimplexNoiseGenericHelper<Float> :: skewPoint(
 	Float* position
 ) {
 	assert(dimensions > 0);
+	assert(Dimensions == 0 || Dimensions == dimensions);
 	assert(position != nullptr);
 
+	const int d = (Dimensions > 0) ? Dimensions : dimensions;
+
 	Float skew = position[0];
-	for (int i = 1; i < dimensions; ++i) {
+	for (int i = 1; i < d; ++i) {
 		skew += position[i];
 	}
 	skew *= skewFactor;
 
-	for (int i = 0; i < dimensions; ++i) {
+	for (int i = 0; i < d; ++i) {
 		position[i] += skew;
 	}
 }
 
 template <typename Float>
+template <int Dimensions>
 void
 SimplexNoiseGenericHelper<Float> :: deskewPoint(
 	int dimensions,
@@ -58,23 +112,28 @@ SimplexNoiseGenericHelper<Float> :: deskewPoint(
 	Float* position
 ) {
 	assert(dimensions > 0);
+	assert(Dimensions == 0 || Dimensions == dimensions);
 	assert(positionSkew != nullptr);
 	assert(position != nullptr);
+
+	const int d = (Dimensions > 0) ? Dimensions : dimensions;
+
 	Float positionSkewSumDebug = positionSkew[0];
-	for (int i = 1; i < dimensions; ++i) {
+	for (int i = 1; i < d; ++i) {
 		positionSkewSumDebug += positionSkew[i];
 	}
 	assert(positionSkewSumDebug == positionSkewSum);
 
 	Float skew = positionSkewSum * deskewFactor;
 
-	for (int i = 0; i < dimensions; ++i) {
+	for (int i = 0; i < d; ++i) {
 		position[i] -= positionSkew[i];
 		position[i] += skew;
 	}
 }
 
 template <typename Float>
+template <int Dimensions>
 Float
 SimplexNoiseGenericHelper<Float> :: dot(
 	int dimensions,
@@ -82,17 +141,21 @@ SimplexNoiseGenericHelper<Float> :: dot(
 	const Float* point2
 ) {
 	assert(dimensions > 0);
+	assert(Dimensions == 0 || Dimensions == dimensions);
 	assert(point1 != nullptr);
 	assert(point2 != nullptr);
 
-	Float d = point1[0] * point2[0];
-	for (int i = 1; i < dimensions; ++i) {
-		d += point1[i] * point2[i];
+	const int d = (Dimensions > 0) ? Dimensions : dimensions;
+
+	Float result = point1[0] * point2[0];
+	for (int i = 1; i < d; ++i) {
+		result += point1[i] * point2[i];
 	}
-	return d;
+	return result;
 }
 
 template <typename Float>
+template <int Dimensions>
 void
 SimplexNoiseGenericHelper<Float> :: gradient(
 	int dimensions,
@@ -102,11 +165,14 @@ SimplexNoiseGenericHelper<Float> :: gradient(
 	Float* result
 ) {
 	assert(dimensions > 0);
+	assert(Dimensions == 0 || Dimensions == dimensions);
 	assert(permutationArray != nullptr);
 	assert(position != nullptr);
 	assert(result != nullptr);
 
-	if (dimensions == 2) {
+	const int d = (Dimensions > 0) ? Dimensions : dimensions;
+
+	if (d == 2) {
 		// Special case since this method doesn't work well for 2d
 		if (offset == nullptr) {
 			SimplexNoiseHelper<Float, 2>::gradient(SimplexNoiseHelper<Float, 2>::gradientHash(permutationArray, position[0], position[1]), result[0], result[1]);
@@ -118,54 +184,169 @@ SimplexNoiseGenericHelper<Float> :: gradient(
 		return;
 	}
 
-	uint32_t bits = dimensions - 1;
-	uint32_t bytes = ((bits - 1) / (sizeof(uint32_t) * 8)) + 1;
-	uint32_t* mask = new uint32_t[bytes];
+	// Every byte of the mask is the xor of the permutation values, so a single word is enough
+	uint32_t mask = 0;
 	uint32_t zeroPos = 0;
 
 	int i, k;
-	uint32_t j, b;
+	int j;
 	HashInt h;
 
-	for (j = 0; j < bytes; ++j) {
-		mask[j] = 0;
-	}
-
 	// Form the hash for the gradient
-	for (i = 0; i < dimensions; ++i) {
+	for (i = 0; i < d; ++i) {
 		h = position[i];
 		if (offset != nullptr) h += offset[i];
 
-		for (j = 0; j < bytes; ++j) {
-			b = 0;
-			for (k = 0; k < sizeof(uint32_t) * 8; k += sizeof(unsigned char) * 8) {
-				b |= permutationArray[h] << k;
-			}
-			mask[j] ^= b;
-		}
-
-		for (k = 0; k < sizeof(uint32_t) * 8; k += sizeof(unsigned char) * 8) {
-			zeroPos |= permutationArray[h] << k;
+		for (k = 0; k < static_cast<int>(sizeof(uint32_t) * 8); k += sizeof(unsigned char) * 8) {
+			mask ^= static_cast<uint32_t>(permutationArray[h]) << k;
+			zeroPos |= static_cast<uint32_t>(permutationArray[h]) << k;
 		}
 	}
 
 	// Set the gradient
-	zeroPos %= dimensions;
-	for (j = 0; j < zeroPos; ++j) {
-		*result = (mask[j / (sizeof(uint32_t) * 8)] & (1 << (j % (sizeof(uint32_t) * 8)))) == 0 ? -1 : 1;
+	zeroPos %= d;
+	for (j = 0; j < static_cast<int>(zeroPos); ++j) {
+		*result = (mask & (1u << (j % (sizeof(uint32_t) * 8)))) == 0 ? -1 : 1;
 		++result;
 	}
 	*result = 0;
 	++result;
 	++j;
-	for (; j < dimensions; ++j) {
-		*result = (mask[j / (sizeof(uint32_t) * 8)] & (1 << (j % (sizeof(uint32_t) * 8)))) == 0 ? -1 : 1;
+	for (; j < d; ++j) {
+		*result = (mask & (1u << (j % (sizeof(uint32_t) * 8)))) == 0 ? -1 : 1;
 		++result;
 	}
 }
 
 
 
+// SimplexNoiseSimd
+template <typename Float>
+typename SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise2(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	const int32_t* latticeOffset,
+	Float* out
+) {
+	// No vectorized version for this type
+	return 0;
+}
+
+template <typename Float>
+typename SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise3(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	const Float* zs,
+	const int32_t* latticeOffset,
+	Float* out
+) {
+	// No vectorized version for this type
+	return 0;
+}
+
+template <typename Float>
+typename SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise4(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	const Float* zs,
+	const Float* ws,
+	const int32_t* latticeOffset,
+	Float* out
+) {
+	// No vectorized version for this type
+	return 0;
+}
+
+template <typename Float>
+typename SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise2_gradient(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	Float* out,
+	CountInt stride,
+	CountInt componentStride
+) {
+	// No vectorized version for this type
+	return 0;
+}
+
+template <typename Float>
+typename SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise3_gradient(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	const Float* zs,
+	Float* out,
+	CountInt stride,
+	CountInt componentStride
+) {
+	// No vectorized version for this type
+	return 0;
+}
+
+template <typename Float>
+typename SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: curl3(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	const Float* zs,
+	Float* out,
+	CountInt stride,
+	CountInt componentStride
+) {
+	// No vectorized version for this type
+	return 0;
+}
+
+template <typename Float>
+typename SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise2_periodic(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	int32_t periodX,
+	int32_t periodY,
+	Float* out
+) {
+	// No vectorized version for this type
+	return 0;
+}
+
+template <typename Float>
+typename SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise3_periodic(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	const Float* zs,
+	int32_t periodX,
+	int32_t periodY,
+	int32_t periodZ,
+	Float* out
+) {
+	// No vectorized version for this type
+	return 0;
+}
+
+
+
 // SimplexNoiseHelper<Float, Dimensions>
 template <typename Float, int Dimensions>
 constexpr Float
@@ -307,10 +488,31 @@ SimplexNoiseHelper<Float, 2> :: gradient(
 template <typename Float>
 constexpr Float
 SimplexNoiseHelper<Float, 2> :: unnormalizedMaximum() {
-	// This is an approximated value achieved by brute force testing
+	// This is an approximated value achieved by brute force testing; the solver's refined extremum,
+	// 0.014255562202212987, is only 2 ulp smaller, so the original value is kept for stable output
 	return 0.01425556220221299;
 }
 
+template <typename Float>
+typename SimplexNoiseHelper<Float, 2>::HashInt
+SimplexNoiseHelper<Float, 2> :: periodicGradientHash(
+	const unsigned char* permutationArray,
+	HashInt x2,
+	HashInt y
+) {
+	assert(((x2 + y) & 0x1) == 0);
+
+	// Vertex (x2, y) is lattice vertex ((x2 + y) / 2, y)
+	return gradientHash(permutationArray, ((x2 + y) / 2) & 0xFF, y & 0xFF);
+}
+
+template <typename Float>
+constexpr Float
+SimplexNoiseHelper<Float, 2> :: periodicUnnormalizedMaximum() {
+	// This is an approximated value achieved by brute force testing
+	return 0.10832720470205576;
+}
+
 
 
 // SimplexNoiseHelper<Float, 3>
@@ -335,6 +537,15 @@ SimplexNoiseHelper<Float, 3> :: simplexOrders[][2][3] = {
 	{ {1,0,0}, {1,1,0} }, // 7
 };
 
+// Whole lattice cell offsets of the three curl potential components; any offsets work since lattice indices wrap at 256
+template <typename Float>
+const unsigned char
+SimplexNoiseHelper<Float, 3> :: curlOffsets[][3] = {
+	{0,0,0},
+	{91,193,45},
+	{167,62,145},
+};
+
 template <typename Float>
 constexpr Float
 SimplexNoiseHelper<Float, 3> :: skewFactor() {
@@ -421,8 +632,30 @@ SimplexNoiseHelper<Float, 3> :: gradient(
 template <typename Float>
 constexpr Float
 SimplexNoiseHelper<Float, 3> :: unnormalizedMaximum() {
-	// This is an approximated value achieved by brute force testing
-	return 0.03199015150473494;
+	// This is the extremum found by the solver, refined to machine precision
+	return 0.03199015385935426;
+}
+
+template <typename Float>
+typename SimplexNoiseHelper<Float, 3>::HashInt
+SimplexNoiseHelper<Float, 3> :: periodicGradientHash(
+	const unsigned char* permutationArray,
+	HashInt x2,
+	HashInt y2,
+	HashInt z2
+) {
+	assert(((x2 + y2) & 0x1) == 0);
+	assert(((x2 + z2) & 0x1) == 0);
+
+	// Vertex (x2, y2, z2) / 2 is lattice vertex ((y2 + z2) / 2, (x2 + z2) / 2, (x2 + y2) / 2)
+	return gradientHash(permutationArray, ((y2 + z2) / 2) & 0xFF, ((x2 + z2) / 2) & 0xFF, ((x2 + y2) / 2) & 0xFF);
+}
+
+template <typename Float>
+constexpr Float
+SimplexNoiseHelper<Float, 3> :: periodicUnnormalizedMaximum() {
+	// The same lattice as noise3's, only rotated
+	return unnormalizedMaximum();
 }
 
 
@@ -575,16 +808,30 @@ SimplexNoiseHelper<Float, 4> :: gradient(
 template <typename Float>
 constexpr Float
 SimplexNoiseHelper<Float, 4> :: unnormalizedMaximum() {
-	// This is an approximated value achieved by brute force testing
-	return 0.03718810613189993;
+	// This is the extremum found by the solver, refined to machine precision
+	return 0.03718811811127849;
 }
 
 
 
 // SimplexNoise<Float>
+template <typename Float>
+SimplexNoise<Float>
+SimplexNoise<Float> :: fromSeed(
+	SeedInt seed
+) {
+	SimplexNoise<Float> generator;
+	generator.perm = SimplexNoiseBase::acquirePermutation(seed);
+	generator.seed = seed;
+	generator.seeded = true;
+	return generator;
+}
+
 template <typename Float>
 SimplexNoise<Float> :: SimplexNoise() :
-	perm(SimplexNoiseBase::perm)
+	perm(SimplexNoiseBase::perm),
+	seed(0),
+	seeded(false)
 {
 }
 
@@ -592,13 +839,46 @@ template <typename Float>
 SimplexNoise<Float> :: SimplexNoise(
 	const unsigned char* perm
 ) :
-	perm(perm)
+	perm(perm),
+	seed(0),
+	seeded(false)
 {
 	assert(perm != nullptr);
 }
 
+template <typename Float>
+SimplexNoise<Float> :: SimplexNoise(
+	const SimplexNoise<Float>& other
+) :
+	perm(other.seeded ? SimplexNoiseBase::acquirePermutation(other.seed) : other.perm),
+	seed(other.seed),
+	seeded(other.seeded)
+{
+}
+
 template <typename Float>
 SimplexNoise<Float> :: ~SimplexNoise() {
+	if (this->seeded) {
+		SimplexNoiseBase::releasePermutation(this->seed);
+	}
+}
+
+template <typename Float>
+SimplexNoise<Float>&
+SimplexNoise<Float> :: operator = (
+	const SimplexNoise<Float>& other
+) {
+	// Acquire before releasing, in case both use the same seed
+	const unsigned char* perm = other.seeded ? SimplexNoiseBase::acquirePermutation(other.seed) : other.perm;
+	if (this->seeded) {
+		SimplexNoiseBase::releasePermutation(this->seed);
+	}
+
+	this->perm = perm;
+	this->seed = other.seed;
+	this->seeded = other.seeded;
+
+	return *this;
 }
 
 
@@ -616,6 +896,12 @@ SimplexNoise<Float> :: fast_floor(
 	//assert(x >= static_cast<Float>(std::numeric_limits<signed_int>::min()));
 	//assert(x <= static_cast<Float>(std::numeric_limits<signed_int>::max()));
 
+	if (std::numeric_limits<Float>::digits <= std::numeric_limits<unsigned_int>::digits) {
+		// The offset below would round away the fractional part (ie: float), so truncate and correct instead
+		signed_int i = static_cast<signed_int>(x);
+		return i - (static_cast<Float>(i) > x);
+	}
+
 	return static_cast<signed_int>(static_cast<unsigned_int>(x - static_cast<Float>(std::numeric_limits<signed_int>::min()))) + std::numeric_limits<signed_int>::min();
 }
 
@@ -634,9 +920,46 @@ SimplexNoise<Float> :: fast_ceiling(
 	//assert(x >= static_cast<Float>(std::numeric_limits<signed_int>::min()));
 	//assert(x <= static_cast<Float>(std::numeric_limits<signed_int>::max()));
 
+	if (std::numeric_limits<Float>::digits <= std::numeric_limits<unsigned_int>::digits) {
+		// Same as fast_floor
+		signed_int i = static_cast<signed_int>(x);
+		return i + (static_cast<Float>(i) < x);
+	}
+
 	return std::numeric_limits<signed_int>::max() - static_cast<signed_int>(static_cast<unsigned_int>(static_cast<Float>(std::numeric_limits<signed_int>::max()) - x));
 }
 
+template <typename Float>
+typename SimplexNoise<Float>::HashInt
+SimplexNoise<Float> :: wrap_period(
+	HashInt value,
+	HashInt period
+) {
+	assert(period >= 0);
+
+	if (period == 0) return value;
+
+	// Neighboring vertices of an already wrapped one are at most a period away
+	value += (value < 0) ? period : 0;
+	value -= (value >= period) ? period : 0;
+	if (value >= 0 && value < period) return value;
+
+	value %= period;
+	return (value < 0) ? value + period : value;
+}
+
+template <typename Float>
+Float
+SimplexNoise<Float> :: wrap_position(
+	Float value,
+	HashInt period
+) {
+	assert(period >= 0);
+
+	if (period == 0) return value;
+	return value - static_cast<Float>(SimplexNoise<Float>::fast_floor<HashInt>(value / period)) * period;
+}
+
 
 
 // 1d noise
@@ -759,6 +1082,42 @@ SimplexNoise<Float> :: noise1_octaves(
 	return n / total;
 }
 
+template <typename Float>
+void
+SimplexNoise<Float> :: noise1_batch(
+	CountInt count,
+	const Float* xs,
+	Float* out
+) {
+	assert(count == 0 || xs != nullptr);
+	assert(count == 0 || out != nullptr);
+
+	HashInt i0;
+	Float x0, x1;
+	Float t0, t1;
+	Float g;
+
+	for (CountInt i = 0; i < count; ++i) {
+		i0 = SimplexNoise<Float>::fast_floor<HashInt>(xs[i]);
+
+		SimplexNoiseHelper<Float, 1>::gradient(this->perm[i0 & 0xFF], g);
+		x0 = xs[i] - i0;
+		t0 = 1 - x0 * x0;
+		t0 *= t0;
+		t0 *= t0;
+		t0 *= g * x0;
+
+		SimplexNoiseHelper<Float, 1>::gradient(this->perm[(i0 + 1) & 0xFF], g);
+		x1 = x0 - 1;
+		t1 = 1 - x1 * x1;
+		t1 *= t1;
+		t1 *= t1;
+		t1 *= g * x1;
+
+		out[i] = (t0 + t1) / SimplexNoiseHelper<Float, 1>::unnormalizedMaximum();
+	}
+}
+
 
 
 // 2d noise
@@ -1020,63 +1379,736 @@ SimplexNoise<Float> :: noise2_octaves(
 	return n / total;
 }
 
+template <typename Float>
+void
+SimplexNoise<Float> :: noise2_batch(
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	Float* out
+) {
+	this->noise2_batch_offset(count, xs, ys, nullptr, out);
+}
+
+template <typename Float>
+void
+SimplexNoise<Float> :: noise2_batch_offset(
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	const HashInt* latticeOffset,
+	Float* out
+) {
+	assert(count == 0 || xs != nullptr);
+	assert(count == 0 || ys != nullptr);
+	assert(count == 0 || out != nullptr);
+
+	const HashInt offsetI = (latticeOffset != nullptr) ? latticeOffset[0] : 0;
+	const HashInt offsetJ = (latticeOffset != nullptr) ? latticeOffset[1] : 0;
+
+	// Vectorized kernel, if the CPU supports it
+	CountInt done = SimplexNoiseSimd::noise2(this->perm, count, xs, ys, latticeOffset, out);
+	xs += done;
+	ys += done;
+	out += done;
+	count -= done;
+
+	// Per-block scratch; the points are processed in two passes so that the
+	// skew/floor pass has no table lookups and can be vectorized
+	Float rx0[batchSize];
+	Float ry0[batchSize];
+	HashInt si[batchSize];
+	HashInt sj[batchSize];
+
+	Float sx, sy;
+	Float rx1, ry1;
+	Float gx, gy;
+	Float c, c0;
+	HashInt simplex0, simplex1;
+	CountInt i, n;
+
+	while (count > 0) {
+		n = (count < batchSize) ? count : batchSize;
+
+		// Skew points, find origins, and find the relative distances from the deskewed origins
+		for (i = 0; i < n; ++i) {
+			sx = xs[i];
+			sy = ys[i];
+			SimplexNoiseHelper<Float, 2>::skewPoint(sx, sy);
+			si[i] = SimplexNoise<Float>::fast_floor<HashInt>(sx);
+			sj[i] = SimplexNoise<Float>::fast_floor<HashInt>(sy);
+
+			rx0[i] = xs[i];
+			ry0[i] = ys[i];
+			SimplexNoiseHelper<Float, 2>::deskewPoint((si[i] + sj[i]), si[i], sj[i], rx0[i], ry0[i]);
+
+			si[i] = (si[i] + offsetI) & 0xFF;
+			sj[i] = (sj[i] + offsetJ) & 0xFF;
+		}
+
+		// Contributions; corners out of range are zeroed instead of skipped
+		for (i = 0; i < n; ++i) {
+			simplex0 = (rx0[i] >= ry0[i]);
+			simplex1 = !simplex0;
+
+			// Contribution 1
+			c0 = static_cast<Float>(0.5) - rx0[i] * rx0[i] - ry0[i] * ry0[i];
+			c0 = (c0 > 0) ? c0 : 0;
+			SimplexNoiseHelper<Float, 2>::gradient(SimplexNoiseHelper<Float, 2>::gradientHash(this->perm, si[i], sj[i]), gx, gy);
+			c0 *= c0;
+			c0 *= c0;
+			c0 *= (gx * rx0[i] + gy * ry0[i]);
+
+			// Contribution 2
+			rx1 = rx0[i];
+			ry1 = ry0[i];
+			SimplexNoiseHelper<Float, 2>::deskewPoint(1, simplex0, simplex1, rx1, ry1);
+			c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1;
+			c = (c > 0) ? c : 0;
+			SimplexNoiseHelper<Float, 2>::gradient(SimplexNoiseHelper<Float, 2>::gradientHash(this->perm, si[i] + simplex0, sj[i] + simplex1), gx, gy);
+			c *= c;
+			c *= c;
+			c0 += c * (gx * rx1 + gy * ry1);
+
+			// Contribution 3
+			rx1 = rx0[i];
+			ry1 = ry0[i];
+			SimplexNoiseHelper<Float, 2>::deskewPoint(2, 1, 1, rx1, ry1);
+			c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1;
+			c = (c > 0) ? c : 0;
+			SimplexNoiseHelper<Float, 2>::gradient(SimplexNoiseHelper<Float, 2>::gradientHash(this->perm, si[i] + 1, sj[i] + 1), gx, gy);
+			c *= c;
+			c *= c;
+			c0 += c * (gx * rx1 + gy * ry1);
+
+			out[i] = c0 / SimplexNoiseHelper<Float, 2>::unnormalizedMaximum();
+		}
 
+		// Next block
+		xs += n;
+		ys += n;
+		out += n;
+		count -= n;
+	}
+}
+
+
+template <typename Float>
+void
+SimplexNoise<Float> :: noise2_gradient_batch(
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	Float* out,
+	CountInt stride,
+	CountInt componentStride
+) {
+	// The value of point i is written to out[i * stride], and its derivatives to out[i * stride + componentStride * (1 + axis)];
+	// (stride = 3, componentStride = 1) is interleaved, and (stride = 1, componentStride = count) is planar
+	assert(count == 0 || xs != nullptr);
+	assert(count == 0 || ys != nullptr);
+	assert(count == 0 || out != nullptr);
+
+	// Vectorized kernel, if the CPU supports it
+	CountInt done = SimplexNoiseSimd::noise2_gradient(this->perm, count, xs, ys, out, stride, componentStride);
+	xs += done;
+	ys += done;
+	out += done * stride;
+	count -= done;
+
+	// Per-block scratch
+	Float rx0[batchSize];
+	Float ry0[batchSize];
+	HashInt si[batchSize];
+	HashInt sj[batchSize];
+
+	Float sx, sy;
+	Float rx1, ry1;
+	Float gx, gy;
+	Float c, c0, c1, dot;
+	Float dx, dy, dx2, dy2;
+	HashInt simplex0, simplex1;
+	CountInt i, n;
+
+	while (count > 0) {
+		n = (count < batchSize) ? count : batchSize;
+
+		// Skew points, find origins, and find the relative distances from the deskewed origins
+		for (i = 0; i < n; ++i) {
+			sx = xs[i];
+			sy = ys[i];
+			SimplexNoiseHelper<Float, 2>::skewPoint(sx, sy);
+			si[i] = SimplexNoise<Float>::fast_floor<HashInt>(sx);
+			sj[i] = SimplexNoise<Float>::fast_floor<HashInt>(sy);
+
+			rx0[i] = xs[i];
+			ry0[i] = ys[i];
+			SimplexNoiseHelper<Float, 2>::deskewPoint((si[i] + sj[i]), si[i], sj[i], rx0[i], ry0[i]);
+
+			si[i] &= 0xFF;
+			sj[i] &= 0xFF;
+		}
+
+		// Values and derivatives, computed the same way as noise2(x, y, dx, dy); corners out of range are zeroed instead of skipped
+		for (i = 0; i < n; ++i) {
+			simplex0 = (rx0[i] >= ry0[i]);
+			simplex1 = !simplex0;
+
+			// Contribution 1
+			c0 = static_cast<Float>(0.5) - rx0[i] * rx0[i] - ry0[i] * ry0[i];
+			c0 = (c0 > 0) ? c0 : 0;
+			SimplexNoiseHelper<Float, 2>::gradient(SimplexNoiseHelper<Float, 2>::gradientHash(this->perm, si[i], sj[i]), gx, gy);
+			dot = (gx * rx0[i] + gy * ry0[i]);
+			c1 = c0;
+			c0 *= c0;
+			dx = rx0[i] * dot * c0 * c1;
+			dy = ry0[i] * dot * c0 * c1;
+			c0 *= c0;
+			dx2 = gx * c0;
+			dy2 = gy * c0;
+			c0 *= dot;
+
+			// Contribution 2
+			rx1 = rx0[i];
+			ry1 = ry0[i];
+			SimplexNoiseHelper<Float, 2>::deskewPoint(1, simplex0, simplex1, rx1, ry1);
+			c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1;
+			c = (c > 0) ? c : 0;
+			SimplexNoiseHelper<Float, 2>::gradient(SimplexNoiseHelper<Float, 2>::gradientHash(this->perm, si[i] + simplex0, sj[i] + simplex1), gx, gy);
+			dot = (gx * rx1 + gy * ry1);
+			c1 = c;
+			c *= c;
+			dx += rx1 * dot * c * c1;
+			dy += ry1 * dot * c * c1;
+			c *= c;
+			dx2 += gx * c;
+			dy2 += gy * c;
+			c0 += c * dot;
+
+			// Contribution 3
+			rx1 = rx0[i];
+			ry1 = ry0[i];
+			SimplexNoiseHelper<Float, 2>::deskewPoint(2, 1, 1, rx1, ry1);
+			c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1;
+			c = (c > 0) ? c : 0;
+			SimplexNoiseHelper<Float, 2>::gradient(SimplexNoiseHelper<Float, 2>::gradientHash(this->perm, si[i] + 1, sj[i] + 1), gx, gy);
+			dot = (gx * rx1 + gy * ry1);
+			c1 = c;
+			c *= c;
+			dx += rx1 * dot * c * c1;
+			dy += ry1 * dot * c * c1;
+			c *= c;
+			dx2 += gx * c;
+			dy2 += gy * c;
+			c0 += c * dot;
+
+			// Complete derivative
+			dx = (dx * -8 + dx2) / SimplexNoiseHelper<Float, 2>::unnormalizedMaximum();
+			dy = (dy * -8 + dy2) / SimplexNoiseHelper<Float, 2>::unnormalizedMaximum();
+
+			out[0] = c0 / SimplexNoiseHelper<Float, 2>::unnormalizedMaximum();
+			out[componentStride] = dx;
+			out[componentStride * 2] = dy;
+			out += stride;
+		}
+
+		// Next block
+		xs += n;
+		ys += n;
+		count -= n;
+	}
+}
+
+template <typename Float>
+void
+SimplexNoise<Float> :: fill_grid2(
+	Float x0,
+	Float y0,
+	Float dx,
+	Float dy,
+	CountInt width,
+	CountInt height,
+	Float* out,
+	CountInt stride
+) {
+	assert(out != nullptr || width == 0 || height == 0);
+	assert(stride >= width);
+
+	// The value at out[j * stride + i] is noise2(x0 + i * dx, y0 + j * dy).
+	// Each row is first given to the vectorized kernels; whatever they don't cover is walked here.
+	// Neighboring points usually share a cell, so the gradient hashes of the current cell's corners
+	// are kept and only computed when first needed; they're indexed by (xoffset | yoffset << 1).
+	HashInt hashes[4];
+	unsigned int hashesValid = 0;
+	HashInt cellI = -1;
+	HashInt cellJ = -1;
+
+	Float x, y;
+	Float sx, sy;
+	Float rx0, ry0, rx1, ry1;
+	Float gx, gy;
+	Float c, c0;
+	HashInt si, sj;
+	HashInt simplex0, simplex1;
+	unsigned int k;
+	Float xs[batchSize];
+	Float ys[batchSize];
+	CountInt i, j, n, done;
+
+	for (j = 0; j < height; ++j) {
+		y = y0 + j * dy;
+
+		// Vectorized part of the row
+		for (i = 0; i < width; i += done) {
+			n = (width - i < batchSize) ? width - i : batchSize;
+			for (k = 0; k < n; ++k) {
+				xs[k] = x0 + (i + k) * dx;
+				ys[k] = y;
+			}
+			done = SimplexNoiseSimd::noise2(this->perm, n, xs, ys, nullptr, out + j * stride + i);
+			if (done < n) {
+				i += done;
+				break;
+			}
+		}
+
+		for (; i < width; ++i) {
+			x = x0 + i * dx;
+
+			// Skew point and find origin
+			sx = x;
+			sy = y;
+			SimplexNoiseHelper<Float, 2>::skewPoint(sx, sy);
+			si = SimplexNoise<Float>::fast_floor<HashInt>(sx);
+			sj = SimplexNoise<Float>::fast_floor<HashInt>(sy);
+
+			// The x,y relative distances from the deskewed origin
+			rx0 = x;
+			ry0 = y;
+			SimplexNoiseHelper<Float, 2>::deskewPoint((si + sj), si, sj, rx0, ry0);
+
+			// Truncate the integer indices to [0,255]
+			si &= 0xFF;
+			sj &= 0xFF;
+
+			// New cell
+			if (si != cellI || sj != cellJ) {
+				cellI = si;
+				cellJ = sj;
+				hashesValid = 0;
+			}
+
+			// Simplex second point order
+			simplex0 = (rx0 >= ry0);
+			simplex1 = !simplex0;
+
+			// Contribution 1
+			c0 = static_cast<Float>(0.5) - rx0 * rx0 - ry0 * ry0;
+			if (c0 <= 0) {
+				c0 = 0;
+			}
+			else {
+				if ((hashesValid & 0x1) == 0) {
+					hashes[0] = SimplexNoiseHelper<Float, 2>::gradientHash(this->perm, si, sj);
+					hashesValid |= 0x1;
+				}
+				SimplexNoiseHelper<Float, 2>::gradient(hashes[0], gx, gy);
+				c0 *= c0;
+				c0 *= c0;
+				c0 *= (gx * rx0 + gy * ry0);
+			}
+
+			// Contribution 2
+			rx1 = rx0;
+			ry1 = ry0;
+			SimplexNoiseHelper<Float, 2>::deskewPoint(1, simplex0, simplex1, rx1, ry1);
+			c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1;
+			if (c > 0) {
+				k = simplex0 | (simplex1 << 1);
+				if ((hashesValid & (1 << k)) == 0) {
+					hashes[k] = SimplexNoiseHelper<Float, 2>::gradientHash(this->perm, si + simplex0, sj + simplex1);
+					hashesValid |= (1 << k);
+				}
+				SimplexNoiseHelper<Float, 2>::gradient(hashes[k], gx, gy);
+				c *= c;
+				c *= c;
+				c *= (gx * rx1 + gy * ry1);
+
+				c0 += c;
+			}
+
+			// Contribution 3
+			rx1 = rx0;
+			ry1 = ry0;
+			SimplexNoiseHelper<Float, 2>::deskewPoint(2, 1, 1, rx1, ry1);
+			c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1;
+			if (c > 0) {
+				if ((hashesValid & 0x8) == 0) {
+					hashes[3] = SimplexNoiseHelper<Float, 2>::gradientHash(this->perm, si + 1, sj + 1);
+					hashesValid |= 0x8;
+				}
+				SimplexNoiseHelper<Float, 2>::gradient(hashes[3], gx, gy);
+				c *= c;
+				c *= c;
+				c *= (gx * rx1 + gy * ry1);
+
+				c0 += c;
+			}
+
+			// Done
+			out[j * stride + i] = c0 / SimplexNoiseHelper<Float, 2>::unnormalizedMaximum();
+		}
+	}
+}
 
-// 3d noise
 template <typename Float>
 Float
-SimplexNoise<Float> :: noise3(
+SimplexNoise<Float> :: noise2_periodic(
 	Float x,
 	Float y,
-	Float z
+	HashInt periodX,
+	HashInt periodY
 ) {
-	// fn(x,y,z) = sum((max(0, 0.5 - dot(xyz[i], xyz[i])) ^ 3) * dot(gradient[i], xyz[i]), i, 0, 3)
+	assert(periodX >= 0);
+	assert(periodY >= 0);
+	assert((periodY & 0x1) == 0);
 
-	// Skew point and find origin
-	Float sx = x;
-	Float sy = y;
-	Float sz = z;
-	SimplexNoiseHelper<Float, 3>::skewPoint(sx, sy, sz);
-	HashInt si = SimplexNoise<Float>::fast_floor<HashInt>(sx);
-	HashInt sj = SimplexNoise<Float>::fast_floor<HashInt>(sy);
-	HashInt sk = SimplexNoise<Float>::fast_floor<HashInt>(sz);
+	// fn(x,y) = sum((max(0, 0.8 - dot(xy[i], xy[i])) ^ 4) * dot(gradient[i], xy[i]), i, 0, 2)
+	// The lattice has vertices at (i - j / 2, j), so whole x periods and even y periods line up with it
 
-	// The x,y,z relative distances from the deskewed origin
-	Float rx0 = x;
-	Float ry0 = y;
-	Float rz0 = z;
-	SimplexNoiseHelper<Float, 3>::deskewPoint((si + sj + sk), si, sj, sk, rx0, ry0, rz0);
+	// Move the point into the first period; the simplex's vertices are then at most a period out of range
+	x = SimplexNoise<Float>::wrap_position(x, periodX);
+	y = SimplexNoise<Float>::wrap_position(y, periodY);
 
-	// Truncate the integer indices to [0,255]; this makes gradient hashing use less computations
-	si &= 0xFF;
-	sj &= 0xFF;
-	sk &= 0xFF;
+	// Shear point and find origin
+	Float su = x + y * static_cast<Float>(0.5);
+	HashInt si = SimplexNoise<Float>::fast_floor<HashInt>(su);
+	HashInt sj = SimplexNoise<Float>::fast_floor<HashInt>(y);
+	Float fu = su - si;
+	Float fv = y - sj;
 
-	// Simplex point order
-	int key =
-		(rx0 >= ry0 ? 0x1 : 0) |
-		(rx0 >= rz0 ? 0x2 : 0) |
-		(ry0 >= rz0 ? 0x4 : 0);
-	assert(key != 0x2);
-	assert(key != (0x1 | 0x4));
-	const unsigned char (*simplexOrder)[3] = SimplexNoiseHelper<Float, 3>::simplexOrders[key];
+	// The x,y relative distances from the origin vertex
+	Float rx0 = fu - fv * static_cast<Float>(0.5);
+	Float ry0 = fv;
 
-	Float rx1, ry1, rz1;
-	Float gx, gy, gz;
+	// The doubled x and the y coordinates of the origin vertex, wrapped to the periods
+	HashInt vertexPeriodX = 2 * periodX;
+	HashInt vx = SimplexNoise<Float>::wrap_period(2 * si - sj, vertexPeriodX);
+	HashInt vy = SimplexNoise<Float>::wrap_period(sj, periodY);
+
+	// Simplex second point order
+	// simplex0, simplex1 = (fu >= fv) ? (1, 0) : (0, 1); its doubled x,y offset is (2, 0) or (-1, 1)
+	HashInt simplex0 = (fu >= fv);
+	HashInt simplex1 = !simplex0;
+	Float rx1, ry1;
+	Float gx, gy;
 	Float c, c0;
 
-	// Contibution 1
-	c = static_cast<Float>(0.5) - rx0 * rx0 - ry0 * ry0 - rz0 * rz0;
-	if (c <= 0) {
+	// Contribution 1
+	c0 = static_cast<Float>(0.8) - rx0 * rx0 - ry0 * ry0;
+	if (c0 <= 0) {
 		c0 = 0;
 	}
 	else {
-		SimplexNoiseHelper<Float, 3>::gradient(SimplexNoiseHelper<Float, 3>::gradientHash(this->perm, si, sj, sk), gx, gy, gz);
-		c0 = c * c * c;
-		c0 *= (gx * rx0 + gy * ry0 + gz * rz0);
+		SimplexNoiseHelper<Float, 2>::gradient(SimplexNoiseHelper<Float, 2>::periodicGradientHash(this->perm, vx, vy), gx, gy);
+		c0 *= c0;
+		c0 *= c0;
+		c0 *= (gx * rx0 + gy * ry0);
 	}
 
-	// Contibution 2
+	// Contribution 2
+	rx1 = rx0 - simplex0 + simplex1 * static_cast<Float>(0.5);
+	ry1 = ry0 - simplex1;
+	c = static_cast<Float>(0.8) - rx1 * rx1 - ry1 * ry1;
+	if (c > 0) {
+		SimplexNoiseHelper<Float, 2>::gradient(SimplexNoiseHelper<Float, 2>::periodicGradientHash(
+			this->perm,
+			SimplexNoise<Float>::wrap_period(vx + 2 * simplex0 - simplex1, vertexPeriodX),
+			SimplexNoise<Float>::wrap_period(vy + simplex1, periodY)
+		), gx, gy);
+		c *= c;
+		c *= c;
+		c *= (gx * rx1 + gy * ry1);
+
+		c0 += c;
+	}
+
+	// Contribution 3
+	rx1 = rx0 - static_cast<Float>(0.5);
+	ry1 = ry0 - 1;
+	c = static_cast<Float>(0.8) - rx1 * rx1 - ry1 * ry1;
+	if (c > 0) {
+		SimplexNoiseHelper<Float, 2>::gradient(SimplexNoiseHelper<Float, 2>::periodicGradientHash(
+			this->perm,
+			SimplexNoise<Float>::wrap_period(vx + 1, vertexPeriodX),
+			SimplexNoise<Float>::wrap_period(vy + 1, periodY)
+		), gx, gy);
+		c *= c;
+		c *= c;
+		c *= (gx * rx1 + gy * ry1);
+
+		c0 += c;
+	}
+
+	// Done
+	return c0 / SimplexNoiseHelper<Float, 2>::periodicUnnormalizedMaximum();
+}
+
+template <typename Float>
+Float
+SimplexNoise<Float> :: noise2_periodic_octaves(
+	OctavesInt octaves,
+	Float x,
+	Float y,
+	HashInt periodX,
+	HashInt periodY
+) {
+	if (octaves <= 0) return 0;
+
+	// Each octave doubles the frequency, and so the periods
+	Float n = noise2_periodic(x, y, periodX, periodY);
+	Float scale = 1;
+	Float total = 1;
+
+	while (--octaves != 0) {
+		scale /= 2;
+		total += scale;
+		periodX *= 2;
+		periodY *= 2;
+		n += noise2_periodic(x / scale, y / scale, periodX, periodY) * scale;
+	}
+
+	return n / total;
+}
+
+template <typename Float>
+void
+SimplexNoise<Float> :: noise2_periodic_batch(
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	HashInt periodX,
+	HashInt periodY,
+	Float* out
+) {
+	assert(count == 0 || xs != nullptr);
+	assert(count == 0 || ys != nullptr);
+	assert(count == 0 || out != nullptr);
+	assert(periodX >= 0);
+	assert(periodY >= 0);
+	assert((periodY & 0x1) == 0);
+
+	// Vectorized kernel, if the CPU supports it
+	CountInt done = SimplexNoiseSimd::noise2_periodic(this->perm, count, xs, ys, periodX, periodY, out);
+	xs += done;
+	ys += done;
+	out += done;
+	count -= done;
+
+	// Per-block scratch; same two passes as noise2_batch
+	Float rx0[batchSize];
+	Float ry0[batchSize];
+	HashInt vx[batchSize];
+	HashInt vy[batchSize];
+	HashInt simplex0[batchSize];
+
+	Float x, y;
+	Float su, fu, fv;
+	Float rx1, ry1;
+	Float gx, gy;
+	Float c, c0;
+	HashInt si, sj, simplex1;
+	CountInt i, n;
+
+	// The doubled x coordinates of the vertices repeat every 2 * periodX
+	HashInt vertexPeriodX = 2 * periodX;
+
+	while (count > 0) {
+		n = (count < batchSize) ? count : batchSize;
+
+		// Move points into the first period, shear them, find origins, and find the relative distances from the origin vertices
+		for (i = 0; i < n; ++i) {
+			x = SimplexNoise<Float>::wrap_position(xs[i], periodX);
+			y = SimplexNoise<Float>::wrap_position(ys[i], periodY);
+
+			su = x + y * static_cast<Float>(0.5);
+			si = SimplexNoise<Float>::fast_floor<HashInt>(su);
+			sj = SimplexNoise<Float>::fast_floor<HashInt>(y);
+			fu = su - si;
+			fv = y - sj;
+
+			rx0[i] = fu - fv * static_cast<Float>(0.5);
+			ry0[i] = fv;
+			simplex0[i] = (fu >= fv);
+
+			vx[i] = SimplexNoise<Float>::wrap_period(2 * si - sj, vertexPeriodX);
+			vy[i] = SimplexNoise<Float>::wrap_period(sj, periodY);
+		}
+
+		// Contributions; corners out of range are zeroed instead of skipped
+		for (i = 0; i < n; ++i) {
+			simplex1 = !simplex0[i];
+
+			// Contribution 1
+			c0 = static_cast<Float>(0.8) - rx0[i] * rx0[i] - ry0[i] * ry0[i];
+			c0 = (c0 > 0) ? c0 : 0;
+			SimplexNoiseHelper<Float, 2>::gradient(SimplexNoiseHelper<Float, 2>::periodicGradientHash(this->perm, vx[i], vy[i]), gx, gy);
+			c0 *= c0;
+			c0 *= c0;
+			c0 *= (gx * rx0[i] + gy * ry0[i]);
+
+			// Contribution 2
+			rx1 = rx0[i] - simplex0[i] + simplex1 * static_cast<Float>(0.5);
+			ry1 = ry0[i] - simplex1;
+			c = static_cast<Float>(0.8) - rx1 * rx1 - ry1 * ry1;
+			c = (c > 0) ? c : 0;
+			SimplexNoiseHelper<Float, 2>::gradient(SimplexNoiseHelper<Float, 2>::periodicGradientHash(
+				this->perm,
+				SimplexNoise<Float>::wrap_period(vx[i] + 2 * simplex0[i] - simplex1, vertexPeriodX),
+				SimplexNoise<Float>::wrap_period(vy[i] + simplex1, periodY)
+			), gx, gy);
+			c *= c;
+			c *= c;
+			c0 += c * (gx * rx1 + gy * ry1);
+
+			// Contribution 3
+			rx1 = rx0[i] - static_cast<Float>(0.5);
+			ry1 = ry0[i] - 1;
+			c = static_cast<Float>(0.8) - rx1 * rx1 - ry1 * ry1;
+			c = (c > 0) ? c : 0;
+			SimplexNoiseHelper<Float, 2>::gradient(SimplexNoiseHelper<Float, 2>::periodicGradientHash(
+				this->perm,
+				SimplexNoise<Float>::wrap_period(vx[i] + 1, vertexPeriodX),
+				SimplexNoise<Float>::wrap_period(vy[i] + 1, periodY)
+			), gx, gy);
+			c *= c;
+			c *= c;
+			c0 += c * (gx * rx1 + gy * ry1);
+
+			out[i] = c0 / SimplexNoiseHelper<Float, 2>::periodicUnnormalizedMaximum();
+		}
+
+		// Next block
+		xs += n;
+		ys += n;
+		out += n;
+		count -= n;
+	}
+}
+
+template <typename Float>
+Float
+SimplexNoise<Float> :: noise2_chunk(
+	LatticeInt chunkX,
+	LatticeInt chunkY,
+	Float x,
+	Float y
+) {
+	Float out;
+	this->noise2_chunk_batch(chunkX, chunkY, 1, &x, &y, &out);
+	return out;
+}
+
+template <typename Float>
+void
+SimplexNoise<Float> :: noise2_chunk_batch(
+	LatticeInt chunkX,
+	LatticeInt chunkY,
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	Float* out
+) {
+	assert(count == 0 || xs != nullptr);
+	assert(count == 0 || ys != nullptr);
+	assert(count == 0 || out != nullptr);
+
+	// The skewed origin's whole part becomes a lattice offset, and its fraction f is moved into the points:
+	// shifting every axis by f / (1 + 2 * skewFactor) = f * (1 - 2 * deskewFactor) moves the skewed point by f
+	const LatticeInt origin[2] = { chunkX, chunkY };
+	HashInt latticeOffset[2];
+	const Float shift = static_cast<Float>(SimplexNoiseBase::skewChunkOrigin(2, origin, latticeOffset)) *
+		(1 - 2 * SimplexNoiseHelper<Float, 2>::deskewFactor());
+
+	// Per-block scratch
+	Float shiftedX[batchSize];
+	Float shiftedY[batchSize];
+	CountInt i, n;
+
+	while (count > 0) {
+		n = (count < batchSize) ? count : batchSize;
+
+		for (i = 0; i < n; ++i) {
+			shiftedX[i] = xs[i] + shift;
+			shiftedY[i] = ys[i] + shift;
+		}
+
+		this->noise2_batch_offset(n, shiftedX, shiftedY, latticeOffset, out);
+
+		// Next block
+		xs += n;
+		ys += n;
+		out += n;
+		count -= n;
+	}
+}
+
+
+// 3d noise
+template <typename Float>
+Float
+SimplexNoise<Float> :: noise3(
+	Float x,
+	Float y,
+	Float z
+) {
+	// fn(x,y,z) = sum((max(0, 0.5 - dot(xyz[i], xyz[i])) ^ 3) * dot(gradient[i], xyz[i]), i, 0, 3)
+
+	// Skew point and find origin
+	Float sx = x;
+	Float sy = y;
+	Float sz = z;
+	SimplexNoiseHelper<Float, 3>::skewPoint(sx, sy, sz);
+	HashInt si = SimplexNoise<Float>::fast_floor<HashInt>(sx);
+	HashInt sj = SimplexNoise<Float>::fast_floor<HashInt>(sy);
+	HashInt sk = SimplexNoise<Float>::fast_floor<HashInt>(sz);
+
+	// The x,y,z relative distances from the deskewed origin
+	Float rx0 = x;
+	Float ry0 = y;
+	Float rz0 = z;
+	SimplexNoiseHelper<Float, 3>::deskewPoint((si + sj + sk), si, sj, sk, rx0, ry0, rz0);
+
+	// Truncate the integer indices to [0,255]; this makes gradient hashing use less computations
+	si &= 0xFF;
+	sj &= 0xFF;
+	sk &= 0xFF;
+
+	// Simplex point order
+	int key =
+		(rx0 >= ry0 ? 0x1 : 0) |
+		(rx0 >= rz0 ? 0x2 : 0) |
+		(ry0 >= rz0 ? 0x4 : 0);
+	assert(key != 0x2);
+	assert(key != (0x1 | 0x4));
+	const unsigned char (*simplexOrder)[3] = SimplexNoiseHelper<Float, 3>::simplexOrders[key];
+
+	Float rx1, ry1, rz1;
+	Float gx, gy, gz;
+	Float c, c0;
+
+	// Contibution 1
+	c = static_cast<Float>(0.5) - rx0 * rx0 - ry0 * ry0 - rz0 * rz0;
+	if (c <= 0) {
+		c0 = 0;
+	}
+	else {
+		SimplexNoiseHelper<Float, 3>::gradient(SimplexNoiseHelper<Float, 3>::gradientHash(this->perm, si, sj, sk), gx, gy, gz);
+		c0 = c * c * c;
+		c0 *= (gx * rx0 + gy * ry0 + gz * rz0);
+	}
+
+	// Contibution 2
 	rx1 = rx0;
 	ry1 = ry0;
 	rz1 = rz0;
@@ -1291,76 +2323,1104 @@ SimplexNoise<Float> :: noise3(
 	*dz /= SimplexNoiseHelper<Float, 3>::unnormalizedMaximum();
 
 	// Done
-	return c0 / SimplexNoiseHelper<Float, 3>::unnormalizedMaximum();
+	return c0 / SimplexNoiseHelper<Float, 3>::unnormalizedMaximum();
+}
+
+template <typename Float>
+Float
+SimplexNoise<Float> :: noise3_octaves(
+	OctavesInt octaves,
+	Float x,
+	Float y,
+	Float z
+) {
+	if (octaves <= 0) return 0;
+
+	Float n = noise3(x, y, z);
+	Float scale = 1;
+	Float total = 1;
+
+	while (--octaves != 0) {
+		scale /= 2;
+		total += scale;
+		n += noise3(x / scale, y / scale, z / scale) * scale;
+	}
+
+	return n / total;
+}
+
+template <typename Float>
+Float
+SimplexNoise<Float> :: noise3_octaves(
+	OctavesInt octaves,
+	Float x,
+	Float y,
+	Float z,
+	Float* dx,
+	Float* dy,
+	Float* dz
+) {
+	assert(dx != nullptr);
+	assert(dy != nullptr);
+	assert(dz != nullptr);
+
+	if (octaves <= 0) {
+		*dx = 0;
+		*dy = 0;
+		*dz = 0;
+		return 0;
+	}
+
+	Float n = noise3(x, y, z, dx, dy, dz);
+	Float scale = 1;
+	Float total = 1;
+	Float d2[3];
+
+	while (--octaves != 0) {
+		scale /= 2;
+		total += scale;
+		n += noise3(x / scale, y / scale, z / scale, &d2[0], &d2[1], &d2[2]) * scale;
+		*dx += d2[0] * scale;
+		*dy += d2[1] * scale;
+		*dz += d2[2] * scale;
+	}
+
+	*dx /= total;
+	*dy /= total;
+	*dz /= total;
+	return n / total;
+}
+
+template <typename Float>
+void
+SimplexNoise<Float> :: noise3_batch(
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	const Float* zs,
+	Float* out
+) {
+	this->noise3_batch_offset(count, xs, ys, zs, nullptr, out);
+}
+
+template <typename Float>
+void
+SimplexNoise<Float> :: noise3_batch_offset(
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	const Float* zs,
+	const HashInt* latticeOffset,
+	Float* out
+) {
+	assert(count == 0 || xs != nullptr);
+	assert(count == 0 || ys != nullptr);
+	assert(count == 0 || zs != nullptr);
+	assert(count == 0 || out != nullptr);
+
+	const HashInt offsetI = (latticeOffset != nullptr) ? latticeOffset[0] : 0;
+	const HashInt offsetJ = (latticeOffset != nullptr) ? latticeOffset[1] : 0;
+	const HashInt offsetK = (latticeOffset != nullptr) ? latticeOffset[2] : 0;
+
+	// Vectorized kernel, if the CPU supports it
+	CountInt done = SimplexNoiseSimd::noise3(this->perm, count, xs, ys, zs, latticeOffset, out);
+	xs += done;
+	ys += done;
+	zs += done;
+	out += done;
+	count -= done;
+
+	// Per-block scratch
+	Float rx0[batchSize];
+	Float ry0[batchSize];
+	Float rz0[batchSize];
+	HashInt si[batchSize];
+	HashInt sj[batchSize];
+	HashInt sk[batchSize];
+
+	const unsigned char (*simplexOrder)[3];
+	Float sx, sy, sz;
+	Float rx1, ry1, rz1;
+	Float gx, gy, gz;
+	Float c, c0;
+	int key;
+	CountInt i, n;
+
+	while (count > 0) {
+		n = (count < batchSize) ? count : batchSize;
+
+		// Skew points, find origins, and find the relative distances from the deskewed origins
+		for (i = 0; i < n; ++i) {
+			sx = xs[i];
+			sy = ys[i];
+			sz = zs[i];
+			SimplexNoiseHelper<Float, 3>::skewPoint(sx, sy, sz);
+			si[i] = SimplexNoise<Float>::fast_floor<HashInt>(sx);
+			sj[i] = SimplexNoise<Float>::fast_floor<HashInt>(sy);
+			sk[i] = SimplexNoise<Float>::fast_floor<HashInt>(sz);
+
+			rx0[i] = xs[i];
+			ry0[i] = ys[i];
+			rz0[i] = zs[i];
+			SimplexNoiseHelper<Float, 3>::deskewPoint((si[i] + sj[i] + sk[i]), si[i], sj[i], sk[i], rx0[i], ry0[i], rz0[i]);
+
+			si[i] = (si[i] + offsetI) & 0xFF;
+			sj[i] = (sj[i] + offsetJ) & 0xFF;
+			sk[i] = (sk[i] + offsetK) & 0xFF;
+		}
+
+		// Contributions; corners out of range are zeroed instead of skipped
+		for (i = 0; i < n; ++i) {
+			key =
+				(rx0[i] >= ry0[i] ? 0x1 : 0) |
+				(rx0[i] >= rz0[i] ? 0x2 : 0) |
+				(ry0[i] >= rz0[i] ? 0x4 : 0);
+			simplexOrder = SimplexNoiseHelper<Float, 3>::simplexOrders[key];
+
+			// Contibution 1
+			c = static_cast<Float>(0.5) - rx0[i] * rx0[i] - ry0[i] * ry0[i] - rz0[i] * rz0[i];
+			c = (c > 0) ? c : 0;
+			SimplexNoiseHelper<Float, 3>::gradient(SimplexNoiseHelper<Float, 3>::gradientHash(this->perm, si[i], sj[i], sk[i]), gx, gy, gz);
+			c0 = c * c * c;
+			c0 *= (gx * rx0[i] + gy * ry0[i] + gz * rz0[i]);
+
+			// Contibution 2
+			rx1 = rx0[i];
+			ry1 = ry0[i];
+			rz1 = rz0[i];
+			SimplexNoiseHelper<Float, 3>::deskewPoint(1, simplexOrder[0][0], simplexOrder[0][1], simplexOrder[0][2], rx1, ry1, rz1);
+			c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1 - rz1 * rz1;
+			c = (c > 0) ? c : 0;
+			SimplexNoiseHelper<Float, 3>::gradient(SimplexNoiseHelper<Float, 3>::gradientHash(this->perm, si[i] + simplexOrder[0][0], sj[i] + simplexOrder[0][1], sk[i] + simplexOrder[0][2]), gx, gy, gz);
+			c = c * c * c;
+			c0 += c * (gx * rx1 + gy * ry1 + gz * rz1);
+
+			// Contibution 3
+			rx1 = rx0[i];
+			ry1 = ry0[i];
+			rz1 = rz0[i];
+			SimplexNoiseHelper<Float, 3>::deskewPoint(2, simplexOrder[1][0], simplexOrder[1][1], simplexOrder[1][2], rx1, ry1, rz1);
+			c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1 - rz1 * rz1;
+			c = (c > 0) ? c : 0;
+			SimplexNoiseHelper<Float, 3>::gradient(SimplexNoiseHelper<Float, 3>::gradientHash(this->perm, si[i] + simplexOrder[1][0], sj[i] + simplexOrder[1][1], sk[i] + simplexOrder[1][2]), gx, gy, gz);
+			c = c * c * c;
+			c0 += c * (gx * rx1 + gy * ry1 + gz * rz1);
+
+			// Contibution 4
+			rx1 = rx0[i];
+			ry1 = ry0[i];
+			rz1 = rz0[i];
+			SimplexNoiseHelper<Float, 3>::deskewPoint(3, 1, 1, 1, rx1, ry1, rz1);
+			c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1 - rz1 * rz1;
+			c = (c > 0) ? c : 0;
+			SimplexNoiseHelper<Float, 3>::gradient(SimplexNoiseHelper<Float, 3>::gradientHash(this->perm, si[i] + 1, sj[i] + 1, sk[i] + 1), gx, gy, gz);
+			c = c * c * c;
+			c0 += c * (gx * rx1 + gy * ry1 + gz * rz1);
+
+			out[i] = c0 / SimplexNoiseHelper<Float, 3>::unnormalizedMaximum();
+		}
+
+		// Next block
+		xs += n;
+		ys += n;
+		zs += n;
+		out += n;
+		count -= n;
+	}
+}
+
+
+template <typename Float>
+void
+SimplexNoise<Float> :: noise3_gradient_batch(
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	const Float* zs,
+	Float* out,
+	CountInt stride,
+	CountInt componentStride
+) {
+	// Same output layout as noise2_gradient_batch
+	assert(count == 0 || xs != nullptr);
+	assert(count == 0 || ys != nullptr);
+	assert(count == 0 || zs != nullptr);
+	assert(count == 0 || out != nullptr);
+
+	// Vectorized kernel, if the CPU supports it
+	CountInt done = SimplexNoiseSimd::noise3_gradient(this->perm, count, xs, ys, zs, out, stride, componentStride);
+	xs += done;
+	ys += done;
+	zs += done;
+	out += done * stride;
+	count -= done;
+
+	// Per-block scratch
+	Float rx0[batchSize];
+	Float ry0[batchSize];
+	Float rz0[batchSize];
+	HashInt si[batchSize];
+	HashInt sj[batchSize];
+	HashInt sk[batchSize];
+
+	const unsigned char (*simplexOrder)[3];
+	Float sx, sy, sz;
+	Float rx1, ry1, rz1;
+	Float gx, gy, gz;
+	Float c, c0, c2, dot;
+	Float dx, dy, dz, dx2, dy2, dz2;
+	int key;
+	CountInt i, n;
+
+	while (count > 0) {
+		n = (count < batchSize) ? count : batchSize;
+
+		// Skew points, find origins, and find the relative distances from the deskewed origins
+		for (i = 0; i < n; ++i) {
+			sx = xs[i];
+			sy = ys[i];
+			sz = zs[i];
+			SimplexNoiseHelper<Float, 3>::skewPoint(sx, sy, sz);
+			si[i] = SimplexNoise<Float>::fast_floor<HashInt>(sx);
+			sj[i] = SimplexNoise<Float>::fast_floor<HashInt>(sy);
+			sk[i] = SimplexNoise<Float>::fast_floor<HashInt>(sz);
+
+			rx0[i] = xs[i];
+			ry0[i] = ys[i];
+			rz0[i] = zs[i];
+			SimplexNoiseHelper<Float, 3>::deskewPoint((si[i] + sj[i] + sk[i]), si[i], sj[i], sk[i], rx0[i], ry0[i], rz0[i]);
+
+			si[i] &= 0xFF;
+			sj[i] &= 0xFF;
+			sk[i] &= 0xFF;
+		}
+
+		// Values and derivatives, computed the same way as noise3(x, y, z, dx, dy, dz); corners out of range are zeroed instead of skipped
+		for (i = 0; i < n; ++i) {
+			key =
+				(rx0[i] >= ry0[i] ? 0x1 : 0) |
+				(rx0[i] >= rz0[i] ? 0x2 : 0) |
+				(ry0[i] >= rz0[i] ? 0x4 : 0);
+			simplexOrder = SimplexNoiseHelper<Float, 3>::simplexOrders[key];
+
+			// Contibution 1
+			c0 = static_cast<Float>(0.5) - rx0[i] * rx0[i] - ry0[i] * ry0[i] - rz0[i] * rz0[i];
+			c0 = (c0 > 0) ? c0 : 0;
+			SimplexNoiseHelper<Float, 3>::gradient(SimplexNoiseHelper<Float, 3>::gradientHash(this->perm, si[i], sj[i], sk[i]), gx, gy, gz);
+			dot = (gx * rx0[i] + gy * ry0[i] + gz * rz0[i]);
+			c2 = c0 * c0;
+			c0 *= c2;
+			dx = rx0[i] * dot * c2;
+			dy = ry0[i] * dot * c2;
+			dz = rz0[i] * dot * c2;
+			dx2 = c0 * gx;
+			dy2 = c0 * gy;
+			dz2 = c0 * gz;
+			c0 *= dot;
+
+			// Contibution 2
+			rx1 = rx0[i];
+			ry1 = ry0[i];
+			rz1 = rz0[i];
+			SimplexNoiseHelper<Float, 3>::deskewPoint(1, simplexOrder[0][0], simplexOrder[0][1], simplexOrder[0][2], rx1, ry1, rz1);
+			c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1 - rz1 * rz1;
+			c = (c > 0) ? c : 0;
+			SimplexNoiseHelper<Float, 3>::gradient(SimplexNoiseHelper<Float, 3>::gradientHash(this->perm, si[i] + simplexOrder[0][0], sj[i] + simplexOrder[0][1], sk[i] + simplexOrder[0][2]), gx, gy, gz);
+			dot = (gx * rx1 + gy * ry1 + gz * rz1);
+			c2 = c * c;
+			c *= c2;
+			dx += rx1 * dot * c2;
+			dy += ry1 * dot * c2;
+			dz += rz1 * dot * c2;
+			dx2 += c * gx;
+			dy2 += c * gy;
+			dz2 += c * gz;
+			c0 += c * dot;
+
+			// Contibution 3
+			rx1 = rx0[i];
+			ry1 = ry0[i];
+			rz1 = rz0[i];
+			SimplexNoiseHelper<Float, 3>::deskewPoint(2, simplexOrder[1][0], simplexOrder[1][1], simplexOrder[1][2], rx1, ry1, rz1);
+			c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1 - rz1 * rz1;
+			c = (c > 0) ? c : 0;
+			SimplexNoiseHelper<Float, 3>::gradient(SimplexNoiseHelper<Float, 3>::gradientHash(this->perm, si[i] + simplexOrder[1][0], sj[i] + simplexOrder[1][1], sk[i] + simplexOrder[1][2]), gx, gy, gz);
+			dot = (gx * rx1 + gy * ry1 + gz * rz1);
+			c2 = c * c;
+			c *= c2;
+			dx += rx1 * dot * c2;
+			dy += ry1 * dot * c2;
+			dz += rz1 * dot * c2;
+			dx2 += c * gx;
+			dy2 += c * gy;
+			dz2 += c * gz;
+			c0 += c * dot;
+
+			// Contibution 4
+			rx1 = rx0[i];
+			ry1 = ry0[i];
+			rz1 = rz0[i];
+			SimplexNoiseHelper<Float, 3>::deskewPoint(3, 1, 1, 1, rx1, ry1, rz1);
+			c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1 - rz1 * rz1;
+			c = (c > 0) ? c : 0;
+			SimplexNoiseHelper<Float, 3>::gradient(SimplexNoiseHelper<Float, 3>::gradientHash(this->perm, si[i] + 1, sj[i] + 1, sk[i] + 1), gx, gy, gz);
+			dot = (gx * rx1 + gy * ry1 + gz * rz1);
+			c2 = c * c;
+			c *= c2;
+			dx += rx1 * dot * c2;
+			dy += ry1 * dot * c2;
+			dz += rz1 * dot * c2;
+			dx2 += c * gx;
+			dy2 += c * gy;
+			dz2 += c * gz;
+			c0 += c * dot;
+
+			// Complete derivative
+			dx = (dx * -6 + dx2) / SimplexNoiseHelper<Float, 3>::unnormalizedMaximum();
+			dy = (dy * -6 + dy2) / SimplexNoiseHelper<Float, 3>::unnormalizedMaximum();
+			dz = (dz * -6 + dz2) / SimplexNoiseHelper<Float, 3>::unnormalizedMaximum();
+
+			out[0] = c0 / SimplexNoiseHelper<Float, 3>::unnormalizedMaximum();
+			out[componentStride] = dx;
+			out[componentStride * 2] = dy;
+			out[componentStride * 3] = dz;
+			out += stride;
+		}
+
+		// Next block
+		xs += n;
+		ys += n;
+		zs += n;
+		count -= n;
+	}
+}
+
+template <typename Float>
+void
+SimplexNoise<Float> :: curl3(
+	Float x,
+	Float y,
+	Float z,
+	Float* cx,
+	Float* cy,
+	Float* cz
+) {
+	assert(cx != nullptr);
+	assert(cy != nullptr);
+	assert(cz != nullptr);
+
+	Float curl[3];
+	this->curl3_batch(1, &x, &y, &z, curl, 3, 1);
+	*cx = curl[0];
+	*cy = curl[1];
+	*cz = curl[2];
+}
+
+template <typename Float>
+void
+SimplexNoise<Float> :: curl3_batch(
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	const Float* zs,
+	Float* out,
+	CountInt stride,
+	CountInt componentStride
+) {
+	// The potential is (noise3(p + t[0]), noise3(p + t[1]), noise3(p + t[2])), where the offsets t[] are whole lattice cells
+	// (SimplexNoiseHelper<Float, 3>::curlOffsets); so all three components share the skew, simplex order, and falloff,
+	// and only differ in their gradients. The result uses the same output layout as noise3_gradient_batch, without a value:
+	//   curl = (dp[2]/dy - dp[1]/dz, dp[0]/dz - dp[2]/dx, dp[1]/dx - dp[0]/dy)
+	assert(count == 0 || xs != nullptr);
+	assert(count == 0 || ys != nullptr);
+	assert(count == 0 || zs != nullptr);
+	assert(count == 0 || out != nullptr);
+
+	// Vectorized kernel, if the CPU supports it
+	CountInt done = SimplexNoiseSimd::curl3(this->perm, count, xs, ys, zs, out, stride, componentStride);
+	xs += done;
+	ys += done;
+	zs += done;
+	out += done * stride;
+	count -= done;
+
+	// Per-block scratch
+	Float points[3][batchSize];
+	HashInt pointFloors[3][batchSize];
+
+	// Corners 1 and 2 come from the simplex order
+	static const unsigned char corners[4][3] = { {0,0,0}, {0,0,0}, {0,0,0}, {1,1,1} };
+	const unsigned char (*simplexOrder)[3];
+	HashInt base[3][3];
+	HashInt corner[3];
+	Float point0[3];
+	Float point1[3];
+	Float gradient[3][3];
+	Float dot[3];
+	Float positive[3];
+	Float positive2[3];
+	Float negative[3];
+	Float negative2[3];
+	Float c, c2;
+	int key, a, b, m;
+	CountInt i, n;
+
+	while (count > 0) {
+		n = (count < batchSize) ? count : batchSize;
+
+		// Skew points, find origins, and find the relative distances from the deskewed origins
+		for (i = 0; i < n; ++i) {
+			point0[0] = xs[i];
+			point0[1] = ys[i];
+			point0[2] = zs[i];
+			SimplexNoiseHelper<Float, 3>::skewPoint(point0[0], point0[1], point0[2]);
+			corner[0] = SimplexNoise<Float>::fast_floor<HashInt>(point0[0]);
+			corner[1] = SimplexNoise<Float>::fast_floor<HashInt>(point0[1]);
+			corner[2] = SimplexNoise<Float>::fast_floor<HashInt>(point0[2]);
+
+			point0[0] = xs[i];
+			point0[1] = ys[i];
+			point0[2] = zs[i];
+			SimplexNoiseHelper<Float, 3>::deskewPoint((corner[0] + corner[1] + corner[2]), corner[0], corner[1], corner[2], point0[0], point0[1], point0[2]);
+
+			for (a = 0; a < 3; ++a) {
+				points[a][i] = point0[a];
+				pointFloors[a][i] = corner[a] & 0xFF;
+			}
+		}
+
+		// Curls
+		for (i = 0; i < n; ++i) {
+			for (a = 0; a < 3; ++a) {
+				point0[a] = points[a][i];
+				for (b = 0; b < 3; ++b) base[b][a] = (pointFloors[a][i] + SimplexNoiseHelper<Float, 3>::curlOffsets[b][a]) & 0xFF;
+				positive[a] = 0;
+				positive2[a] = 0;
+				negative[a] = 0;
+				negative2[a] = 0;
+			}
+
+			key =
+				(point0[0] >= point0[1] ? 0x1 : 0) |
+				(point0[0] >= point0[2] ? 0x2 : 0) |
+				(point0[1] >= point0[2] ? 0x4 : 0);
+			simplexOrder = SimplexNoiseHelper<Float, 3>::simplexOrders[key];
+
+			for (m = 0; m < 4; ++m) {
+				// Corner m of the simplex
+				for (a = 0; a < 3; ++a) {
+					corner[a] = corners[m][a];
+					point1[a] = point0[a];
+				}
+				if (m == 1 || m == 2) {
+					for (a = 0; a < 3; ++a) corner[a] = simplexOrder[m - 1][a];
+				}
+				SimplexNoiseHelper<Float, 3>::deskewPoint(m, corner[0], corner[1], corner[2], point1[0], point1[1], point1[2]);
+
+				// Corners out of range are skipped; with three hashes per corner, this is cheaper than zeroing them
+				c = static_cast<Float>(0.5) - point1[0] * point1[0] - point1[1] * point1[1] - point1[2] * point1[2];
+				if (c <= 0) continue;
+				c2 = c * c;
+				c *= c2;
+
+				// Each potential component uses its own gradient
+				for (b = 0; b < 3; ++b) {
+					SimplexNoiseHelper<Float, 3>::gradient(SimplexNoiseHelper<Float, 3>::gradientHash(this->perm, base[b][0] + corner[0], base[b][1] + corner[1], base[b][2] + corner[2]), gradient[b][0], gradient[b][1], gradient[b][2]);
+					dot[b] = (gradient[b][0] * point1[0] + gradient[b][1] * point1[1] + gradient[b][2] * point1[2]);
+				}
+
+				// Derivatives are accumulated in two parts, the same way as noise3(x, y, z, dx, dy, dz)
+				positive[0] += point1[1] * dot[2] * c2;
+				positive2[0] += c * gradient[2][1];
+				negative[0] += point1[2] * dot[1] * c2;
+				negative2[0] += c * gradient[1][2];
+
+				positive[1] += point1[2] * dot[0] * c2;
+				positive2[1] += c * gradient[0][2];
+				negative[1] += point1[0] * dot[2] * c2;
+				negative2[1] += c * gradient[2][0];
+
+				positive[2] += point1[0] * dot[1] * c2;
+				positive2[2] += c * gradient[1][0];
+				negative[2] += point1[1] * dot[0] * c2;
+				negative2[2] += c * gradient[0][1];
+			}
+
+			// Complete derivatives
+			for (a = 0; a < 3; ++a) {
+				out[componentStride * a] = ((positive[a] * -6 + positive2[a]) - (negative[a] * -6 + negative2[a])) / SimplexNoiseHelper<Float, 3>::unnormalizedMaximum();
+			}
+			out += stride;
+		}
+
+		// Next block
+		xs += n;
+		ys += n;
+		zs += n;
+		count -= n;
+	}
+}
+
+template <typename Float>
+void
+SimplexNoise<Float> :: fill_grid3(
+	Float x0,
+	Float y0,
+	Float z,
+	Float dx,
+	Float dy,
+	CountInt width,
+	CountInt height,
+	Float* out,
+	CountInt stride
+) {
+	assert(out != nullptr || width == 0 || height == 0);
+	assert(stride >= width);
+
+	// The value at out[j * stride + i] is noise3(x0 + i * dx, y0 + j * dy, z).
+	// The gradient hashes of the current cell's corners are indexed by (xoffset | yoffset << 1 | zoffset << 2).
+	HashInt hashes[8];
+	unsigned int hashesValid = 0;
+	HashInt cellI = -1;
+	HashInt cellJ = -1;
+	HashInt cellK = -1;
+
+	const unsigned char (*simplexOrder)[3];
+	Float x, y;
+	Float sx, sy, sz;
+	Float rx0, ry0, rz0, rx1, ry1, rz1;
+	Float gx, gy, gz;
+	Float c, c0;
+	HashInt si, sj, sk;
+	int key;
+	unsigned int k;
+	Float xs[batchSize];
+	Float ys[batchSize];
+	Float zs[batchSize];
+	CountInt i, j, n, done;
+
+	for (j = 0; j < height; ++j) {
+		y = y0 + j * dy;
+
+		// Vectorized part of the row
+		for (i = 0; i < width; i += done) {
+			n = (width - i < batchSize) ? width - i : batchSize;
+			for (k = 0; k < n; ++k) {
+				xs[k] = x0 + (i + k) * dx;
+				ys[k] = y;
+				zs[k] = z;
+			}
+			done = SimplexNoiseSimd::noise3(this->perm, n, xs, ys, zs, nullptr, out + j * stride + i);
+			if (done < n) {
+				i += done;
+				break;
+			}
+		}
+
+		for (; i < width; ++i) {
+			x = x0 + i * dx;
+
+			// Skew point and find origin
+			sx = x;
+			sy = y;
+			sz = z;
+			SimplexNoiseHelper<Float, 3>::skewPoint(sx, sy, sz);
+			si = SimplexNoise<Float>::fast_floor<HashInt>(sx);
+			sj = SimplexNoise<Float>::fast_floor<HashInt>(sy);
+			sk = SimplexNoise<Float>::fast_floor<HashInt>(sz);
+
+			// The x,y,z relative distances from the deskewed origin
+			rx0 = x;
+			ry0 = y;
+			rz0 = z;
+			SimplexNoiseHelper<Float, 3>::deskewPoint((si + sj + sk), si, sj, sk, rx0, ry0, rz0);
+
+			// Truncate the integer indices to [0,255]
+			si &= 0xFF;
+			sj &= 0xFF;
+			sk &= 0xFF;
+
+			// New cell
+			if (si != cellI || sj != cellJ || sk != cellK) {
+				cellI = si;
+				cellJ = sj;
+				cellK = sk;
+				hashesValid = 0;
+			}
+
+			// Simplex point order
+			key =
+				(rx0 >= ry0 ? 0x1 : 0) |
+				(rx0 >= rz0 ? 0x2 : 0) |
+				(ry0 >= rz0 ? 0x4 : 0);
+			assert(key != 0x2);
+			assert(key != (0x1 | 0x4));
+			simplexOrder = SimplexNoiseHelper<Float, 3>::simplexOrders[key];
+
+			// Contibution 1
+			c = static_cast<Float>(0.5) - rx0 * rx0 - ry0 * ry0 - rz0 * rz0;
+			if (c <= 0) {
+				c0 = 0;
+			}
+			else {
+				if ((hashesValid & 0x1) == 0) {
+					hashes[0] = SimplexNoiseHelper<Float, 3>::gradientHash(this->perm, si, sj, sk);
+					hashesValid |= 0x1;
+				}
+				SimplexNoiseHelper<Float, 3>::gradient(hashes[0], gx, gy, gz);
+				c0 = c * c * c;
+				c0 *= (gx * rx0 + gy * ry0 + gz * rz0);
+			}
+
+			// Contibution 2
+			rx1 = rx0;
+			ry1 = ry0;
+			rz1 = rz0;
+			SimplexNoiseHelper<Float, 3>::deskewPoint(1, simplexOrder[0][0], simplexOrder[0][1], simplexOrder[0][2], rx1, ry1, rz1);
+			c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1 - rz1 * rz1;
+			if (c > 0) {
+				k = simplexOrder[0][0] | (simplexOrder[0][1] << 1) | (simplexOrder[0][2] << 2);
+				if ((hashesValid & (1 << k)) == 0) {
+					hashes[k] = SimplexNoiseHelper<Float, 3>::gradientHash(this->perm, si + simplexOrder[0][0], sj + simplexOrder[0][1], sk + simplexOrder[0][2]);
+					hashesValid |= (1 << k);
+				}
+				SimplexNoiseHelper<Float, 3>::gradient(hashes[k], gx, gy, gz);
+				c = c * c * c;
+				c *= (gx * rx1 + gy * ry1 + gz * rz1);
+
+				c0 += c;
+			}
+
+			// Contibution 3
+			rx1 = rx0;
+			ry1 = ry0;
+			rz1 = rz0;
+			SimplexNoiseHelper<Float, 3>::deskewPoint(2, simplexOrder[1][0], simplexOrder[1][1], simplexOrder[1][2], rx1, ry1, rz1);
+			c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1 - rz1 * rz1;
+			if (c > 0) {
+				k = simplexOrder[1][0] | (simplexOrder[1][1] << 1) | (simplexOrder[1][2] << 2);
+				if ((hashesValid & (1 << k)) == 0) {
+					hashes[k] = SimplexNoiseHelper<Float, 3>::gradientHash(this->perm, si + simplexOrder[1][0], sj + simplexOrder[1][1], sk + simplexOrder[1][2]);
+					hashesValid |= (1 << k);
+				}
+				SimplexNoiseHelper<Float, 3>::gradient(hashes[k], gx, gy, gz);
+				c = c * c * c;
+				c *= (gx * rx1 + gy * ry1 + gz * rz1);
+
+				c0 += c;
+			}
+
+			// Contibution 4
+			rx1 = rx0;
+			ry1 = ry0;
+			rz1 = rz0;
+			SimplexNoiseHelper<Float, 3>::deskewPoint(3, 1, 1, 1, rx1, ry1, rz1);
+			c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1 - rz1 * rz1;
+			if (c > 0) {
+				if ((hashesValid & 0x80) == 0) {
+					hashes[7] = SimplexNoiseHelper<Float, 3>::gradientHash(this->perm, si + 1, sj + 1, sk + 1);
+					hashesValid |= 0x80;
+				}
+				SimplexNoiseHelper<Float, 3>::gradient(hashes[7], gx, gy, gz);
+				c = c * c * c;
+				c *= (gx * rx1 + gy * ry1 + gz * rz1);
+
+				c0 += c;
+			}
+
+			// Done
+			out[j * stride + i] = c0 / SimplexNoiseHelper<Float, 3>::unnormalizedMaximum();
+		}
+	}
+}
+
+template <typename Float>
+Float
+SimplexNoise<Float> :: noise3_periodic(
+	Float x,
+	Float y,
+	Float z,
+	HashInt periodX,
+	HashInt periodY,
+	HashInt periodZ
+) {
+	assert(periodX >= 0);
+	assert(periodY >= 0);
+	assert(periodZ >= 0);
+
+	// fn(x,y,z) = sum((max(0, 0.5 - dot(xyz[i], xyz[i])) ^ 3) * dot(gradient[i], xyz[i]), i, 0, 3)
+	// The lattice has vertices at (-i + j + k, i - j + k, i + j - k) / 2, so whole periods line up with it
+
+	// Move the point into the first period; the simplex's vertices are then at most a period out of range
+	x = SimplexNoise<Float>::wrap_position(x, periodX);
+	y = SimplexNoise<Float>::wrap_position(y, periodY);
+	z = SimplexNoise<Float>::wrap_position(z, periodZ);
+
+	// Transform point into lattice space and find origin
+	Float su = y + z;
+	Float sv = x + z;
+	Float sw = x + y;
+	HashInt si = SimplexNoise<Float>::fast_floor<HashInt>(su);
+	HashInt sj = SimplexNoise<Float>::fast_floor<HashInt>(sv);
+	HashInt sk = SimplexNoise<Float>::fast_floor<HashInt>(sw);
+	Float fu = su - si;
+	Float fv = sv - sj;
+	Float fw = sw - sk;
+
+	// The x,y,z relative distances from the origin vertex
+	Float rx0 = (fv + fw - fu) * static_cast<Float>(0.5);
+	Float ry0 = (fu + fw - fv) * static_cast<Float>(0.5);
+	Float rz0 = (fu + fv - fw) * static_cast<Float>(0.5);
+
+	// The doubled coordinates of the origin vertex, wrapped to the periods
+	HashInt vertexPeriodX = 2 * periodX;
+	HashInt vertexPeriodY = 2 * periodY;
+	HashInt vertexPeriodZ = 2 * periodZ;
+	HashInt vx = SimplexNoise<Float>::wrap_period(sj + sk - si, vertexPeriodX);
+	HashInt vy = SimplexNoise<Float>::wrap_period(si + sk - sj, vertexPeriodY);
+	HashInt vz = SimplexNoise<Float>::wrap_period(si + sj - sk, vertexPeriodZ);
+
+	// Simplex point order
+	int key =
+		(fu >= fv ? 0x1 : 0) |
+		(fu >= fw ? 0x2 : 0) |
+		(fv >= fw ? 0x4 : 0);
+	assert(key != 0x2);
+	assert(key != (0x1 | 0x4));
+	const unsigned char (*simplexOrder)[3] = SimplexNoiseHelper<Float, 3>::simplexOrders[key];
+
+	Float rx1, ry1, rz1;
+	Float gx, gy, gz;
+	Float c, c0;
+	int ox, oy, oz;
+
+	// Contibution 1
+	c = static_cast<Float>(0.5) - rx0 * rx0 - ry0 * ry0 - rz0 * rz0;
+	if (c <= 0) {
+		c0 = 0;
+	}
+	else {
+		SimplexNoiseHelper<Float, 3>::gradient(SimplexNoiseHelper<Float, 3>::periodicGradientHash(this->perm, vx, vy, vz), gx, gy, gz);
+		c0 = c * c * c;
+		c0 *= (gx * rx0 + gy * ry0 + gz * rz0);
+	}
+
+	// Contibution 2
+	ox = simplexOrder[0][1] + simplexOrder[0][2] - simplexOrder[0][0];
+	oy = simplexOrder[0][0] + simplexOrder[0][2] - simplexOrder[0][1];
+	oz = simplexOrder[0][0] + simplexOrder[0][1] - simplexOrder[0][2];
+	rx1 = rx0 - ox * static_cast<Float>(0.5);
+	ry1 = ry0 - oy * static_cast<Float>(0.5);
+	rz1 = rz0 - oz * static_cast<Float>(0.5);
+	c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1 - rz1 * rz1;
+	if (c > 0) {
+		SimplexNoiseHelper<Float, 3>::gradient(SimplexNoiseHelper<Float, 3>::periodicGradientHash(
+			this->perm,
+			SimplexNoise<Float>::wrap_period(vx + ox, vertexPeriodX),
+			SimplexNoise<Float>::wrap_period(vy + oy, vertexPeriodY),
+			SimplexNoise<Float>::wrap_period(vz + oz, vertexPeriodZ)
+		), gx, gy, gz);
+		c = c * c * c;
+		c *= (gx * rx1 + gy * ry1 + gz * rz1);
+
+		c0 += c;
+	}
+
+	// Contibution 3
+	ox = simplexOrder[1][1] + simplexOrder[1][2] - simplexOrder[1][0];
+	oy = simplexOrder[1][0] + simplexOrder[1][2] - simplexOrder[1][1];
+	oz = simplexOrder[1][0] + simplexOrder[1][1] - simplexOrder[1][2];
+	rx1 = rx0 - ox * static_cast<Float>(0.5);
+	ry1 = ry0 - oy * static_cast<Float>(0.5);
+	rz1 = rz0 - oz * static_cast<Float>(0.5);
+	c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1 - rz1 * rz1;
+	if (c > 0) {
+		SimplexNoiseHelper<Float, 3>::gradient(SimplexNoiseHelper<Float, 3>::periodicGradientHash(
+			this->perm,
+			SimplexNoise<Float>::wrap_period(vx + ox, vertexPeriodX),
+			SimplexNoise<Float>::wrap_period(vy + oy, vertexPeriodY),
+			SimplexNoise<Float>::wrap_period(vz + oz, vertexPeriodZ)
+		), gx, gy, gz);
+		c = c * c * c;
+		c *= (gx * rx1 + gy * ry1 + gz * rz1);
+
+		c0 += c;
+	}
+
+	// Contibution 4
+	rx1 = rx0 - static_cast<Float>(0.5);
+	ry1 = ry0 - static_cast<Float>(0.5);
+	rz1 = rz0 - static_cast<Float>(0.5);
+	c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1 - rz1 * rz1;
+	if (c > 0) {
+		SimplexNoiseHelper<Float, 3>::gradient(SimplexNoiseHelper<Float, 3>::periodicGradientHash(
+			this->perm,
+			SimplexNoise<Float>::wrap_period(vx + 1, vertexPeriodX),
+			SimplexNoise<Float>::wrap_period(vy + 1, vertexPeriodY),
+			SimplexNoise<Float>::wrap_period(vz + 1, vertexPeriodZ)
+		), gx, gy, gz);
+		c = c * c * c;
+		c *= (gx * rx1 + gy * ry1 + gz * rz1);
+
+		c0 += c;
+	}
+
+	// Done
+	return c0 / SimplexNoiseHelper<Float, 3>::periodicUnnormalizedMaximum();
 }
 
 template <typename Float>
 Float
-SimplexNoise<Float> :: noise3_octaves(
+SimplexNoise<Float> :: noise3_periodic_octaves(
 	OctavesInt octaves,
 	Float x,
 	Float y,
-	Float z
+	Float z,
+	HashInt periodX,
+	HashInt periodY,
+	HashInt periodZ
 ) {
 	if (octaves <= 0) return 0;
 
-	Float n = noise3(x, y, z);
+	// Each octave doubles the frequency, and so the periods
+	Float n = noise3_periodic(x, y, z, periodX, periodY, periodZ);
 	Float scale = 1;
 	Float total = 1;
 
 	while (--octaves != 0) {
 		scale /= 2;
 		total += scale;
-		n += noise3(x / scale, y / scale, z / scale) * scale;
+		periodX *= 2;
+		periodY *= 2;
+		periodZ *= 2;
+		n += noise3_periodic(x / scale, y / scale, z / scale, periodX, periodY, periodZ) * scale;
 	}
 
 	return n / total;
 }
 
+template <typename Float>
+void
+SimplexNoise<Float> :: noise3_periodic_batch(
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	const Float* zs,
+	HashInt periodX,
+	HashInt periodY,
+	HashInt periodZ,
+	Float* out
+) {
+	assert(count == 0 || xs != nullptr);
+	assert(count == 0 || ys != nullptr);
+	assert(count == 0 || zs != nullptr);
+	assert(count == 0 || out != nullptr);
+	assert(periodX >= 0);
+	assert(periodY >= 0);
+	assert(periodZ >= 0);
+
+	// Vectorized kernel, if the CPU supports it
+	CountInt done = SimplexNoiseSimd::noise3_periodic(this->perm, count, xs, ys, zs, periodX, periodY, periodZ, out);
+	xs += done;
+	ys += done;
+	zs += done;
+	out += done;
+	count -= done;
+
+	// Per-block scratch; same two passes as noise3_batch
+	Float rx0[batchSize];
+	Float ry0[batchSize];
+	Float rz0[batchSize];
+	HashInt vx[batchSize];
+	HashInt vy[batchSize];
+	HashInt vz[batchSize];
+	int keys[batchSize];
+
+	Float x, y, z;
+	Float su, sv, sw;
+	Float fu, fv, fw;
+	Float rx1, ry1, rz1;
+	Float gx, gy, gz;
+	Float c, c0;
+	HashInt si, sj, sk;
+	int ox, oy, oz;
+	const unsigned char (*simplexOrder)[3];
+	CountInt i, n;
+
+	// The doubled coordinates of the vertices repeat every 2 * period
+	HashInt vertexPeriodX = 2 * periodX;
+	HashInt vertexPeriodY = 2 * periodY;
+	HashInt vertexPeriodZ = 2 * periodZ;
+
+	while (count > 0) {
+		n = (count < batchSize) ? count : batchSize;
+
+		// Move points into the first period, transform them, find origins, and find the relative distances from the origin vertices
+		for (i = 0; i < n; ++i) {
+			x = SimplexNoise<Float>::wrap_position(xs[i], periodX);
+			y = SimplexNoise<Float>::wrap_position(ys[i], periodY);
+			z = SimplexNoise<Float>::wrap_position(zs[i], periodZ);
+
+			su = y + z;
+			sv = x + z;
+			sw = x + y;
+			si = SimplexNoise<Float>::fast_floor<HashInt>(su);
+			sj = SimplexNoise<Float>::fast_floor<HashInt>(sv);
+			sk = SimplexNoise<Float>::fast_floor<HashInt>(sw);
+			fu = su - si;
+			fv = sv - sj;
+			fw = sw - sk;
+
+			rx0[i] = (fv + fw - fu) * static_cast<Float>(0.5);
+			ry0[i] = (fu + fw - fv) * static_cast<Float>(0.5);
+			rz0[i] = (fu + fv - fw) * static_cast<Float>(0.5);
+			keys[i] =
+				(fu >= fv ? 0x1 : 0) |
+				(fu >= fw ? 0x2 : 0) |
+				(fv >= fw ? 0x4 : 0);
+
+			vx[i] = SimplexNoise<Float>::wrap_period(sj + sk - si, vertexPeriodX);
+			vy[i] = SimplexNoise<Float>::wrap_period(si + sk - sj, vertexPeriodY);
+			vz[i] = SimplexNoise<Float>::wrap_period(si + sj - sk, vertexPeriodZ);
+		}
+
+		// Contributions; corners out of range are zeroed instead of skipped
+		for (i = 0; i < n; ++i) {
+			simplexOrder = SimplexNoiseHelper<Float, 3>::simplexOrders[keys[i]];
+
+			// Contribution 1
+			c = static_cast<Float>(0.5) - rx0[i] * rx0[i] - ry0[i] * ry0[i] - rz0[i] * rz0[i];
+			c = (c > 0) ? c : 0;
+			SimplexNoiseHelper<Float, 3>::gradient(SimplexNoiseHelper<Float, 3>::periodicGradientHash(this->perm, vx[i], vy[i], vz[i]), gx, gy, gz);
+			c0 = c * c * c;
+			c0 *= (gx * rx0[i] + gy * ry0[i] + gz * rz0[i]);
+
+			// Contribution 2
+			ox = simplexOrder[0][1] + simplexOrder[0][2] - simplexOrder[0][0];
+			oy = simplexOrder[0][0] + simplexOrder[0][2] - simplexOrder[0][1];
+			oz = simplexOrder[0][0] + simplexOrder[0][1] - simplexOrder[0][2];
+			rx1 = rx0[i] - ox * static_cast<Float>(0.5);
+			ry1 = ry0[i] - oy * static_cast<Float>(0.5);
+			rz1 = rz0[i] - oz * static_cast<Float>(0.5);
+			c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1 - rz1 * rz1;
+			c = (c > 0) ? c : 0;
+			SimplexNoiseHelper<Float, 3>::gradient(SimplexNoiseHelper<Float, 3>::periodicGradientHash(
+				this->perm,
+				SimplexNoise<Float>::wrap_period(vx[i] + ox, vertexPeriodX),
+				SimplexNoise<Float>::wrap_period(vy[i] + oy, vertexPeriodY),
+				SimplexNoise<Float>::wrap_period(vz[i] + oz, vertexPeriodZ)
+			), gx, gy, gz);
+			c0 += c * c * c * (gx * rx1 + gy * ry1 + gz * rz1);
+
+			// Contribution 3
+			ox = simplexOrder[1][1] + simplexOrder[1][2] - simplexOrder[1][0];
+			oy = simplexOrder[1][0] + simplexOrder[1][2] - simplexOrder[1][1];
+			oz = simplexOrder[1][0] + simplexOrder[1][1] - simplexOrder[1][2];
+			rx1 = rx0[i] - ox * static_cast<Float>(0.5);
+			ry1 = ry0[i] - oy * static_cast<Float>(0.5);
+			rz1 = rz0[i] - oz * static_cast<Float>(0.5);
+			c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1 - rz1 * rz1;
+			c = (c > 0) ? c : 0;
+			SimplexNoiseHelper<Float, 3>::gradient(SimplexNoiseHelper<Float, 3>::periodicGradientHash(
+				this->perm,
+				SimplexNoise<Float>::wrap_period(vx[i] + ox, vertexPeriodX),
+				SimplexNoise<Float>::wrap_period(vy[i] + oy, vertexPeriodY),
+				SimplexNoise<Float>::wrap_period(vz[i] + oz, vertexPeriodZ)
+			), gx, gy, gz);
+			c0 += c * c * c * (gx * rx1 + gy * ry1 + gz * rz1);
+
+			// Contribution 4
+			rx1 = rx0[i] - static_cast<Float>(0.5);
+			ry1 = ry0[i] - static_cast<Float>(0.5);
+			rz1 = rz0[i] - static_cast<Float>(0.5);
+			c = static_cast<Float>(0.5) - rx1 * rx1 - ry1 * ry1 - rz1 * rz1;
+			c = (c > 0) ? c : 0;
+			SimplexNoiseHelper<Float, 3>::gradient(SimplexNoiseHelper<Float, 3>::periodicGradientHash(
+				this->perm,
+				SimplexNoise<Float>::wrap_period(vx[i] + 1, vertexPeriodX),
+				SimplexNoise<Float>::wrap_period(vy[i] + 1, vertexPeriodY),
+				SimplexNoise<Float>::wrap_period(vz[i] + 1, vertexPeriodZ)
+			), gx, gy, gz);
+			c0 += c * c * c * (gx * rx1 + gy * ry1 + gz * rz1);
+
+			out[i] = c0 / SimplexNoiseHelper<Float, 3>::periodicUnnormalizedMaximum();
+		}
+
+		// Next block
+		xs += n;
+		ys += n;
+		zs += n;
+		out += n;
+		count -= n;
+	}
+}
+
 template <typename Float>
 Float
-SimplexNoise<Float> :: noise3_octaves(
-	OctavesInt octaves,
+SimplexNoise<Float> :: noise3_chunk(
+	LatticeInt chunkX,
+	LatticeInt chunkY,
+	LatticeInt chunkZ,
 	Float x,
 	Float y,
-	Float z,
-	Float* dx,
-	Float* dy,
-	Float* dz
+	Float z
 ) {
-	assert(dx != nullptr);
-	assert(dy != nullptr);
-	assert(dz != nullptr);
+	Float out;
+	this->noise3_chunk_batch(chunkX, chunkY, chunkZ, 1, &x, &y, &z, &out);
+	return out;
+}
 
-	if (octaves <= 0) {
-		*dx = 0;
-		*dy = 0;
-		*dz = 0;
-		return 0;
-	}
+template <typename Float>
+void
+SimplexNoise<Float> :: noise3_chunk_batch(
+	LatticeInt chunkX,
+	LatticeInt chunkY,
+	LatticeInt chunkZ,
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	const Float* zs,
+	Float* out
+) {
+	assert(count == 0 || xs != nullptr);
+	assert(count == 0 || ys != nullptr);
+	assert(count == 0 || zs != nullptr);
+	assert(count == 0 || out != nullptr);
+
+	// The skewed origin's whole part becomes a lattice offset, and its fraction f is moved into the points:
+	// shifting every axis by f / (1 + 3 * skewFactor) = f * (1 - 3 * deskewFactor) moves the skewed point by f
+	const LatticeInt origin[3] = { chunkX, chunkY, chunkZ };
+	HashInt latticeOffset[3];
+	const Float shift = static_cast<Float>(SimplexNoiseBase::skewChunkOrigin(3, origin, latticeOffset)) *
+		(1 - 3 * SimplexNoiseHelper<Float, 3>::deskewFactor());
+
+	// Per-block scratch
+	Float shiftedX[batchSize];
+	Float shiftedY[batchSize];
+	Float shiftedZ[batchSize];
+	CountInt i, n;
+
+	while (count > 0) {
+		n = (count < batchSize) ? count : batchSize;
+
+		for (i = 0; i < n; ++i) {
+			shiftedX[i] = xs[i] + shift;
+			shiftedY[i] = ys[i] + shift;
+			shiftedZ[i] = zs[i] + shift;
+		}
 
-	Float n = noise3(x, y, z, dx, dy, dz);
-	Float scale = 1;
-	Float total = 1;
-	Float d2[3];
+		this->noise3_batch_offset(n, shiftedX, shiftedY, shiftedZ, latticeOffset, out);
 
-	while (--octaves != 0) {
-		scale /= 2;
-		total += scale;
-		n += noise3(x / scale, y / scale, z / scale, &d2[0], &d2[1], &d2[2]) * scale;
-		*dx += d2[0] * scale;
-		*dy += d2[1] * scale;
-		*dz += d2[2] * scale;
+		// Next block
+		xs += n;
+		ys += n;
+		zs += n;
+		out += n;
+		count -= n;
 	}
-
-	*dx /= total;
-	*dy /= total;
-	*dz /= total;
-	return n / total;
 }
 
 
-
 // 4d noise
 template <typename Float>
 Float
@@ -1734,6 +3794,481 @@ SimplexNoise<Float> :: noise4_octaves(
 	return n / total;
 }
 
+template <typename Float>
+void
+SimplexNoise<Float> :: noise4_batch(
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	const Float* zs,
+	const Float* ws,
+	Float* out
+) {
+	this->noise4_batch_offset(count, xs, ys, zs, ws, nullptr, out);
+}
+
+template <typename Float>
+void
+SimplexNoise<Float> :: noise4_batch_offset(
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	const Float* zs,
+	const Float* ws,
+	const HashInt* latticeOffset,
+	Float* out
+) {
+	assert(count == 0 || xs != nullptr);
+	assert(count == 0 || ys != nullptr);
+	assert(count == 0 || zs != nullptr);
+	assert(count == 0 || ws != nullptr);
+	assert(count == 0 || out != nullptr);
+
+	HashInt offset[4];
+	for (unsigned int k = 0; k < 4; ++k) {
+		offset[k] = (latticeOffset != nullptr) ? latticeOffset[k] : 0;
+	}
+
+	// Vectorized kernel, if the CPU supports it
+	CountInt done = SimplexNoiseSimd::noise4(this->perm, count, xs, ys, zs, ws, latticeOffset, out);
+	xs += done;
+	ys += done;
+	zs += done;
+	ws += done;
+	out += done;
+	count -= done;
+
+	// Per-block scratch
+	Float points[4][batchSize];
+	HashInt pointFloors[4][batchSize];
+
+	Float point0[4];
+	Float point1[4];
+	Float gradient[4];
+	HashInt pointFloor[4];
+	HashInt pointRank[4];
+	HashInt simplexOrder[4];
+	Float c, c0;
+	CountInt i, n;
+	unsigned int j, k;
+
+	while (count > 0) {
+		n = (count < batchSize) ? count : batchSize;
+
+		// Skew points, find origins, and find the relative distances from the deskewed origins
+		for (i = 0; i < n; ++i) {
+			point0[0] = xs[i];
+			point0[1] = ys[i];
+			point0[2] = zs[i];
+			point0[3] = ws[i];
+			SimplexNoiseHelper<Float, 4>::skewPoint(point0);
+			pointFloor[0] = SimplexNoise<Float>::fast_floor<HashInt>(point0[0]);
+			pointFloor[1] = SimplexNoise<Float>::fast_floor<HashInt>(point0[1]);
+			pointFloor[2] = SimplexNoise<Float>::fast_floor<HashInt>(point0[2]);
+			pointFloor[3] = SimplexNoise<Float>::fast_floor<HashInt>(point0[3]);
+
+			point0[0] = xs[i];
+			point0[1] = ys[i];
+			point0[2] = zs[i];
+			point0[3] = ws[i];
+			SimplexNoiseHelper<Float, 4>::deskewPoint((pointFloor[0] + pointFloor[1] + pointFloor[2] + pointFloor[3]), pointFloor, point0);
+
+			for (k = 0; k < 4; ++k) {
+				points[k][i] = point0[k];
+				pointFloors[k][i] = (pointFloor[k] + offset[k]) & 0xFF;
+			}
+		}
+
+		// Contributions; corners out of range are zeroed instead of skipped
+		for (i = 0; i < n; ++i) {
+			for (k = 0; k < 4; ++k) {
+				point0[k] = points[k][i];
+				pointFloor[k] = pointFloors[k][i];
+			}
+
+			// Find simplex order by ranking; ties are broken the same way as the insertion sort in noise4
+			for (k = 0; k < 4; ++k) {
+				pointRank[k] = 1;
+				for (j = 0; j < k; ++j) pointRank[k] += (point0[j] >= point0[k]);
+				for (j = k + 1; j < 4; ++j) pointRank[k] += (point0[j] > point0[k]);
+			}
+
+			// First case
+			c = static_cast<Float>(0.5) - SimplexNoiseHelper<Float, 4>::dot(point0, point0);
+			c = (c > 0) ? c : 0;
+			SimplexNoiseHelper<Float, 4>::gradient(SimplexNoiseHelper<Float, 4>::gradientHash(this->perm, pointFloor), gradient);
+			c0 = c * c * c;
+			c0 *= SimplexNoiseHelper<Float, 4>::dot(gradient, point0);
+
+			// Remaining points
+			for (j = 1; j <= 4; ++j) {
+				for (k = 0; k < 4; ++k) {
+					simplexOrder[k] = (pointRank[k] <= static_cast<HashInt>(j));
+					point1[k] = point0[k];
+				}
+				SimplexNoiseHelper<Float, 4>::deskewPoint(j, simplexOrder, point1);
+
+				c = static_cast<Float>(0.5) - SimplexNoiseHelper<Float, 4>::dot(point1, point1);
+				c = (c > 0) ? c : 0;
+				SimplexNoiseHelper<Float, 4>::gradient(SimplexNoiseHelper<Float, 4>::gradientHash(this->perm, pointFloor, simplexOrder), gradient);
+				c = c * c * c;
+				c0 += c * SimplexNoiseHelper<Float, 4>::dot(gradient, point1);
+			}
+
+			out[i] = c0 / SimplexNoiseHelper<Float, 4>::unnormalizedMaximum();
+		}
+
+		// Next block
+		xs += n;
+		ys += n;
+		zs += n;
+		ws += n;
+		out += n;
+		count -= n;
+	}
+}
+
+
+template <typename Float>
+void
+SimplexNoise<Float> :: noise4_gradient_batch(
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	const Float* zs,
+	const Float* ws,
+	Float* out,
+	CountInt stride,
+	CountInt componentStride
+) {
+	// Same output layout as noise2_gradient_batch
+	assert(count == 0 || xs != nullptr);
+	assert(count == 0 || ys != nullptr);
+	assert(count == 0 || zs != nullptr);
+	assert(count == 0 || ws != nullptr);
+	assert(count == 0 || out != nullptr);
+
+	// Per-block scratch
+	Float points[4][batchSize];
+	HashInt pointFloors[4][batchSize];
+
+	Float point0[4];
+	Float point1[4];
+	Float gradient[4];
+	Float derivative[4];
+	Float derivative2[4];
+	HashInt pointFloor[4];
+	HashInt pointRank[4];
+	HashInt simplexOrder[4];
+	Float c, c0, c2, dot;
+	CountInt i, n;
+	unsigned int j, k;
+
+	while (count > 0) {
+		n = (count < batchSize) ? count : batchSize;
+
+		// Skew points, find origins, and find the relative distances from the deskewed origins
+		for (i = 0; i < n; ++i) {
+			point0[0] = xs[i];
+			point0[1] = ys[i];
+			point0[2] = zs[i];
+			point0[3] = ws[i];
+			SimplexNoiseHelper<Float, 4>::skewPoint(point0);
+			pointFloor[0] = SimplexNoise<Float>::fast_floor<HashInt>(point0[0]);
+			pointFloor[1] = SimplexNoise<Float>::fast_floor<HashInt>(point0[1]);
+			pointFloor[2] = SimplexNoise<Float>::fast_floor<HashInt>(point0[2]);
+			pointFloor[3] = SimplexNoise<Float>::fast_floor<HashInt>(point0[3]);
+
+			point0[0] = xs[i];
+			point0[1] = ys[i];
+			point0[2] = zs[i];
+			point0[3] = ws[i];
+			SimplexNoiseHelper<Float, 4>::deskewPoint((pointFloor[0] + pointFloor[1] + pointFloor[2] + pointFloor[3]), pointFloor, point0);
+
+			for (k = 0; k < 4; ++k) {
+				points[k][i] = point0[k];
+				pointFloors[k][i] = pointFloor[k] & 0xFF;
+			}
+		}
+
+		// Values and derivatives, computed the same way as noise4(x, y, z, w, dx, dy, dz, dw); corners out of range are zeroed instead of skipped
+		for (i = 0; i < n; ++i) {
+			for (k = 0; k < 4; ++k) {
+				point0[k] = points[k][i];
+				pointFloor[k] = pointFloors[k][i];
+			}
+
+			// Find simplex order by ranking; ties are broken the same way as the insertion sort in noise4
+			for (k = 0; k < 4; ++k) {
+				pointRank[k] = 1;
+				for (j = 0; j < k; ++j) pointRank[k] += (point0[j] >= point0[k]);
+				for (j = k + 1; j < 4; ++j) pointRank[k] += (point0[j] > point0[k]);
+			}
+
+			// First case
+			c0 = static_cast<Float>(0.5) - SimplexNoiseHelper<Float, 4>::dot(point0, point0);
+			c0 = (c0 > 0) ? c0 : 0;
+			SimplexNoiseHelper<Float, 4>::gradient(SimplexNoiseHelper<Float, 4>::gradientHash(this->perm, pointFloor), gradient);
+			dot = SimplexNoiseHelper<Float, 4>::dot(gradient, point0);
+			c2 = c0 * c0;
+			c0 *= c2;
+			for (k = 0; k < 4; ++k) {
+				derivative[k] = point0[k] * dot * c2;
+				derivative2[k] = c0 * gradient[k];
+			}
+			c0 *= dot;
+
+			// Remaining points
+			for (j = 1; j <= 4; ++j) {
+				for (k = 0; k < 4; ++k) {
+					simplexOrder[k] = (pointRank[k] <= static_cast<HashInt>(j));
+					point1[k] = point0[k];
+				}
+				SimplexNoiseHelper<Float, 4>::deskewPoint(j, simplexOrder, point1);
+
+				c = static_cast<Float>(0.5) - SimplexNoiseHelper<Float, 4>::dot(point1, point1);
+				c = (c > 0) ? c : 0;
+				SimplexNoiseHelper<Float, 4>::gradient(SimplexNoiseHelper<Float, 4>::gradientHash(this->perm, pointFloor, simplexOrder), gradient);
+				dot = SimplexNoiseHelper<Float, 4>::dot(gradient, point1);
+				c2 = c * c;
+				c *= c2;
+				for (k = 0; k < 4; ++k) {
+					derivative[k] += point1[k] * dot * c2;
+					derivative2[k] += c * gradient[k];
+				}
+				c0 += c * dot;
+			}
+
+			// Complete derivative
+			out[0] = c0 / SimplexNoiseHelper<Float, 4>::unnormalizedMaximum();
+			for (k = 0; k < 4; ++k) {
+				out[componentStride * (k + 1)] = (derivative[k] * -6 + derivative2[k]) / SimplexNoiseHelper<Float, 4>::unnormalizedMaximum();
+			}
+			out += stride;
+		}
+
+		// Next block
+		xs += n;
+		ys += n;
+		zs += n;
+		ws += n;
+		count -= n;
+	}
+}
+
+template <typename Float>
+void
+SimplexNoise<Float> :: fill_grid4(
+	Float x0,
+	Float y0,
+	Float z,
+	Float w,
+	Float dx,
+	Float dy,
+	CountInt width,
+	CountInt height,
+	Float* out,
+	CountInt stride
+) {
+	assert(out != nullptr || width == 0 || height == 0);
+	assert(stride >= width);
+
+	// The value at out[j * stride + i] is noise4(x0 + i * dx, y0 + j * dy, z, w).
+	// The gradient hashes of the current cell's corners are indexed by (xoffset | yoffset << 1 | zoffset << 2 | woffset << 3).
+	HashInt hashes[16];
+	unsigned int hashesValid = 0;
+	HashInt cell[4] = { -1, -1, -1, -1 };
+
+	Float point0[4];
+	Float point1[4];
+	Float gradient[4];
+	HashInt pointFloor[4];
+	HashInt pointRank[4];
+	HashInt simplexOrder[4];
+	Float c, c0;
+	unsigned int k, m, n;
+	Float xs[batchSize];
+	Float ys[batchSize];
+	Float zs[batchSize];
+	Float ws[batchSize];
+	CountInt i, j, count, done;
+
+	for (j = 0; j < height; ++j) {
+		// Vectorized part of the row
+		for (i = 0; i < width; i += done) {
+			count = (width - i < batchSize) ? width - i : batchSize;
+			for (k = 0; k < count; ++k) {
+				xs[k] = x0 + (i + k) * dx;
+				ys[k] = y0 + j * dy;
+				zs[k] = z;
+				ws[k] = w;
+			}
+			done = SimplexNoiseSimd::noise4(this->perm, count, xs, ys, zs, ws, nullptr, out + j * stride + i);
+			if (done < count) {
+				i += done;
+				break;
+			}
+		}
+
+		for (; i < width; ++i) {
+			// Skew point and find origin
+			point0[0] = x0 + i * dx;
+			point0[1] = y0 + j * dy;
+			point0[2] = z;
+			point0[3] = w;
+			SimplexNoiseHelper<Float, 4>::skewPoint(point0);
+			pointFloor[0] = SimplexNoise<Float>::fast_floor<HashInt>(point0[0]);
+			pointFloor[1] = SimplexNoise<Float>::fast_floor<HashInt>(point0[1]);
+			pointFloor[2] = SimplexNoise<Float>::fast_floor<HashInt>(point0[2]);
+			pointFloor[3] = SimplexNoise<Float>::fast_floor<HashInt>(point0[3]);
+
+			// The x,y,z,w relative distances from the deskewed origin
+			point0[0] = x0 + i * dx;
+			point0[1] = y0 + j * dy;
+			point0[2] = z;
+			point0[3] = w;
+			SimplexNoiseHelper<Float, 4>::deskewPoint((pointFloor[0] + pointFloor[1] + pointFloor[2] + pointFloor[3]), pointFloor, point0);
+
+			// Truncate the integer indices to [0,255]
+			pointFloor[0] &= 0xFF;
+			pointFloor[1] &= 0xFF;
+			pointFloor[2] &= 0xFF;
+			pointFloor[3] &= 0xFF;
+
+			// New cell
+			if (pointFloor[0] != cell[0] || pointFloor[1] != cell[1] || pointFloor[2] != cell[2] || pointFloor[3] != cell[3]) {
+				cell[0] = pointFloor[0];
+				cell[1] = pointFloor[1];
+				cell[2] = pointFloor[2];
+				cell[3] = pointFloor[3];
+				hashesValid = 0;
+			}
+
+			// Find simplex order by ranking; ties are broken the same way as the insertion sort in noise4
+			for (k = 0; k < 4; ++k) {
+				pointRank[k] = 1;
+				for (m = 0; m < k; ++m) pointRank[k] += (point0[m] >= point0[k]);
+				for (m = k + 1; m < 4; ++m) pointRank[k] += (point0[m] > point0[k]);
+			}
+
+			// First case
+			c = static_cast<Float>(0.5) - SimplexNoiseHelper<Float, 4>::dot(point0, point0);
+			if (c <= 0) {
+				c0 = 0;
+			}
+			else {
+				if ((hashesValid & 0x1) == 0) {
+					hashes[0] = SimplexNoiseHelper<Float, 4>::gradientHash(this->perm, pointFloor);
+					hashesValid |= 0x1;
+				}
+				SimplexNoiseHelper<Float, 4>::gradient(hashes[0], gradient);
+				c0 = c * c * c;
+				c0 *= SimplexNoiseHelper<Float, 4>::dot(gradient, point0);
+			}
+
+			// Loop over remaining points
+			for (n = 1; n <= 4; ++n) {
+				for (k = 0; k < 4; ++k) {
+					simplexOrder[k] = (pointRank[k] <= static_cast<HashInt>(n));
+					point1[k] = point0[k];
+				}
+				SimplexNoiseHelper<Float, 4>::deskewPoint(n, simplexOrder, point1);
+
+				c = static_cast<Float>(0.5) - SimplexNoiseHelper<Float, 4>::dot(point1, point1);
+				if (c > 0) {
+					k = simplexOrder[0] | (simplexOrder[1] << 1) | (simplexOrder[2] << 2) | (simplexOrder[3] << 3);
+					if ((hashesValid & (1 << k)) == 0) {
+						hashes[k] = SimplexNoiseHelper<Float, 4>::gradientHash(this->perm, pointFloor, simplexOrder);
+						hashesValid |= (1 << k);
+					}
+					SimplexNoiseHelper<Float, 4>::gradient(hashes[k], gradient);
+					c = c * c * c;
+					c *= SimplexNoiseHelper<Float, 4>::dot(gradient, point1);
+
+					// Add to sum
+					c0 += c;
+				}
+			}
+
+			// Done
+			out[j * stride + i] = c0 / SimplexNoiseHelper<Float, 4>::unnormalizedMaximum();
+		}
+	}
+}
+
+template <typename Float>
+Float
+SimplexNoise<Float> :: noise4_chunk(
+	LatticeInt chunkX,
+	LatticeInt chunkY,
+	LatticeInt chunkZ,
+	LatticeInt chunkW,
+	Float x,
+	Float y,
+	Float z,
+	Float w
+) {
+	Float out;
+	this->noise4_chunk_batch(chunkX, chunkY, chunkZ, chunkW, 1, &x, &y, &z, &w, &out);
+	return out;
+}
+
+template <typename Float>
+void
+SimplexNoise<Float> :: noise4_chunk_batch(
+	LatticeInt chunkX,
+	LatticeInt chunkY,
+	LatticeInt chunkZ,
+	LatticeInt chunkW,
+	CountInt count,
+	const Float* xs,
+	const Float* ys,
+	const Float* zs,
+	const Float* ws,
+	Float* out
+) {
+	assert(count == 0 || xs != nullptr);
+	assert(count == 0 || ys != nullptr);
+	assert(count == 0 || zs != nullptr);
+	assert(count == 0 || ws != nullptr);
+	assert(count == 0 || out != nullptr);
+
+	// The skewed origin's whole part becomes a lattice offset, and its fraction f is moved into the points:
+	// shifting every axis by f / (1 + 4 * skewFactor) = f * (1 - 4 * deskewFactor) moves the skewed point by f
+	const LatticeInt origin[4] = { chunkX, chunkY, chunkZ, chunkW };
+	HashInt latticeOffset[4];
+	const Float shift = static_cast<Float>(SimplexNoiseBase::skewChunkOrigin(4, origin, latticeOffset)) *
+		(1 - 4 * SimplexNoiseHelper<Float, 4>::deskewFactor());
+
+	// Per-block scratch
+	Float shiftedX[batchSize];
+	Float shiftedY[batchSize];
+	Float shiftedZ[batchSize];
+	Float shiftedW[batchSize];
+	CountInt i, n;
+
+	while (count > 0) {
+		n = (count < batchSize) ? count : batchSize;
+
+		for (i = 0; i < n; ++i) {
+			shiftedX[i] = xs[i] + shift;
+			shiftedY[i] = ys[i] + shift;
+			shiftedZ[i] = zs[i] + shift;
+			shiftedW[i] = ws[i] + shift;
+		}
+
+		this->noise4_batch_offset(n, shiftedX, shiftedY, shiftedZ, shiftedW, latticeOffset, out);
+
+		// Next block
+		xs += n;
+		ys += n;
+		zs += n;
+		ws += n;
+		out += n;
+		count -= n;
+	}
+}
+
 
 // n-d noise
 template <typename Float>
@@ -1744,116 +4279,176 @@ SimplexNoise<Float> :: noise_n(
 	int dimensions,
 	const Float* position
 ) {
-	assert(power > 0);
+	// Plain powers keep using pow, so existing results don't change
+	return this->noise_n(maxRadius, SimplexNoisePower<Float>(power, false), dimensions, position);
+}
+
+template <typename Float>
+Float
+SimplexNoise<Float> :: noise_n(
+	Float maxRadius,
+	const SimplexNoisePower<Float>& power,
+	int dimensions,
+	const Float* position
+) {
 	assert(dimensions > 1);
 	assert(position != nullptr);
 
-	// Helper struct for sorting
-	struct Point {
-		unsigned int index;
-		Point* next;
-	};
+	// Fixed dimension versions
+	switch (dimensions) {
+		case 2: return this->noise<2>(maxRadius, power, position);
+		case 3: return this->noise<3>(maxRadius, power, position);
+		case 4: return this->noise<4>(maxRadius, power, position);
+		case 5: return this->noise<5>(maxRadius, power, position);
+		case 6: return this->noise<6>(maxRadius, power, position);
+		case 7: return this->noise<7>(maxRadius, power, position);
+		case 8: return this->noise<8>(maxRadius, power, position);
+		case 9: return this->noise<9>(maxRadius, power, position);
+		case 10: return this->noise<10>(maxRadius, power, position);
+		case 11: return this->noise<11>(maxRadius, power, position);
+		case 12: return this->noise<12>(maxRadius, power, position);
+		case 13: return this->noise<13>(maxRadius, power, position);
+		case 14: return this->noise<14>(maxRadius, power, position);
+		case 15: return this->noise<15>(maxRadius, power, position);
+		case 16: return this->noise<16>(maxRadius, power, position);
+	}
+
+	// Stack scratch space; only very high dimension counts use the heap
+	if (dimensions <= maxStackDimensions) {
+		Float point0[maxStackDimensions];
+		Float point1[maxStackDimensions];
+		Float gradient[maxStackDimensions];
+		HashInt pointFloor[maxStackDimensions];
+		HashInt pointRank[maxStackDimensions];
+		HashInt simplexOrder[maxStackDimensions];
+
+		return this->noise_n_scratch<0>(maxRadius, power, dimensions, position, point0, point1, gradient, pointFloor, pointRank, simplexOrder);
+	}
+
+	Float* point0 = new Float[dimensions * 3];
+	HashInt* pointFloor = new HashInt[dimensions * 3];
+	Float c0 = this->noise_n_scratch<0>(maxRadius, power, dimensions, position, point0, point0 + dimensions, point0 + dimensions * 2, pointFloor, pointFloor + dimensions, pointFloor + dimensions * 2);
+
+	// Clean
+	delete [] point0;
+	delete [] pointFloor;
+
+	// Done
+	return c0;
+}
+
+template <typename Float>
+template <int Dimensions>
+Float
+SimplexNoise<Float> :: noise(
+	Float maxRadius,
+	Float power,
+	const Float* position
+) {
+	return this->noise<Dimensions>(maxRadius, SimplexNoisePower<Float>(power, false), position);
+}
+
+template <typename Float>
+template <int Dimensions>
+Float
+SimplexNoise<Float> :: noise(
+	Float maxRadius,
+	const SimplexNoisePower<Float>& power,
+	const Float* position
+) {
+	static_assert(Dimensions > 1, "Dimensions must be at least 2");
+	assert(position != nullptr);
+
+	std::array<Float, Dimensions> point0;
+	std::array<Float, Dimensions> point1;
+	std::array<Float, Dimensions> gradient;
+	std::array<HashInt, Dimensions> pointFloor;
+	std::array<HashInt, Dimensions> pointRank;
+	std::array<HashInt, Dimensions> simplexOrder;
+
+	return this->noise_n_scratch<Dimensions>(maxRadius, power, Dimensions, position, point0.data(), point1.data(), gradient.data(), pointFloor.data(), pointRank.data(), simplexOrder.data());
+}
+
+template <typename Float>
+template <int Dimensions>
+Float
+SimplexNoise<Float> :: noise_n_scratch(
+	Float maxRadius,
+	const SimplexNoisePower<Float>& power,
+	int dimensions,
+	const Float* position,
+	Float* point0,
+	Float* point1,
+	Float* gradient,
+	HashInt* pointFloor,
+	HashInt* pointRank,
+	HashInt* simplexOrder
+) {
+	assert(Dimensions == 0 || Dimensions == dimensions);
+
+	// A non-zero Dimensions makes the loop bounds compile time constants
+	const int d = (Dimensions > 0) ? Dimensions : dimensions;
 
 	// Vars
-	Float* point0 = new Float[dimensions];
-	Float* point1 = new Float[dimensions];
-	Float* gradient = new Float[dimensions];
-	HashInt* pointFloor = new HashInt[dimensions];
-	HashInt* simplexOrder = new HashInt[dimensions];
-	Point* pointOrder = new Point[dimensions];
 	Float c0, c1;
-	Float currentValue;
-	Point* first;
-	Point* current;
-	Point** pos;
 	HashInt pointFloorSum;
-	unsigned int i, j;
-	int k;
-	Float skewFactor = SimplexNoiseGenericHelper<Float>::skewFactor(dimensions);
-	Float deskewFactor = SimplexNoiseGenericHelper<Float>::deskewFactor(dimensions);
+	int i, k, m;
+	Float skewFactor = SimplexNoiseGenericHelper<Float>::skewFactor(d);
+	Float deskewFactor = SimplexNoiseGenericHelper<Float>::deskewFactor(d);
 
 	// Skew point and find origin
-	for (k = 0; k < dimensions; ++k) point0[k] = position[k];
-	SimplexNoiseGenericHelper<Float>::skewPoint(dimensions, skewFactor, point0);
-	for (k = 0; k < dimensions; ++k) pointFloor[k] = SimplexNoise<Float>::fast_floor<HashInt>(point0[k]);
+	for (k = 0; k < d; ++k) point0[k] = position[k];
+	SimplexNoiseGenericHelper<Float>::template skewPoint<Dimensions>(d, skewFactor, point0);
+	for (k = 0; k < d; ++k) pointFloor[k] = SimplexNoise<Float>::fast_floor<HashInt>(point0[k]);
 
 	// The x,y,z,w relative distances from the deskewed origin
-	for (k = 0; k < dimensions; ++k) point0[k] = position[k];
+	for (k = 0; k < d; ++k) point0[k] = position[k];
 	pointFloorSum = pointFloor[0];
-	for (k = 1; k < dimensions; ++k) pointFloorSum += pointFloor[k];
-	SimplexNoiseGenericHelper<Float>::deskewPoint(dimensions, deskewFactor, pointFloorSum, pointFloor, point0);
+	for (k = 1; k < d; ++k) pointFloorSum += pointFloor[k];
+	SimplexNoiseGenericHelper<Float>::template deskewPoint<Dimensions>(d, deskewFactor, pointFloorSum, pointFloor, point0);
 
 	// Truncate the integer indices to [0,255]; this makes gradient hashing use less computations
-	for (k = 0; k < dimensions; ++k) pointFloor[k] &= 0xFF;
-
-	// Find simplex order using insertion sort
-	first = &(pointOrder[0]);
-	pointOrder[0].index = 0;
-	for (i = 1; i < dimensions; ++i) {
-		current = &(pointOrder[i]);
-		current->index = i;
-		currentValue = point0[i];
-		pos = &first;
-		for (j = 0; ; ) {
-			if (currentValue <= point0[(*pos)->index]) {
-				// insert at this position
-				current->next = *pos;
-				*pos = current;
-				break;
-			}
-			if (++j >= i) {
-				// currentValue is the new minimum
-				(*pos)->next = current;
-				break;
-			}
-			pos = &(*pos)->next;
-		}
+	for (k = 0; k < d; ++k) pointFloor[k] &= 0xFF;
+
+	// Find simplex order by ranking; ties are broken the same way as an insertion sort
+	// which inserts each value before the first value greater than or equal to it
+	for (k = 0; k < d; ++k) {
+		pointRank[k] = 1;
+		for (m = 0; m < k; ++m) pointRank[k] += (point0[m] >= point0[k]);
+		for (m = k + 1; m < d; ++m) pointRank[k] += (point0[m] > point0[k]);
 	}
 
 	// First case; this is a simplified version of the (i=0) case of the loop below
-	c0 = static_cast<Float>(maxRadius) - SimplexNoiseGenericHelper<Float>::dot(dimensions, point0, point0);
+	c0 = static_cast<Float>(maxRadius) - SimplexNoiseGenericHelper<Float>::template dot<Dimensions>(d, point0, point0);
 	if (c0 < 0) {
 		c0 = 0;
 	}
 	else {
-		SimplexNoiseGenericHelper<Float>::gradient(dimensions, this->perm, pointFloor, nullptr, gradient);
-		c0 = ::pow(c0, power);
-		c0 *= SimplexNoiseGenericHelper<Float>::dot(dimensions, gradient, point0);
+		SimplexNoiseGenericHelper<Float>::template gradient<Dimensions>(d, this->perm, pointFloor, nullptr, gradient);
+		c0 = power.apply(c0);
+		c0 *= SimplexNoiseGenericHelper<Float>::template dot<Dimensions>(d, gradient, point0);
 	}
 
 	// Loop over remaining points
-	for (i = 1; i <= dimensions; ++i) {
+	for (i = 1; i <= d; ++i) {
 		// Simplex orders
-		current = first;
-		for (j = dimensions; ; ) {
-			simplexOrder[current->index] = (j <= i);
-			if (--j == 0) break;
-			current = current->next;
-		}
+		for (k = 0; k < d; ++k) simplexOrder[k] = (pointRank[k] <= i);
 
 		// Relative distances for the remaining simplex points
-		for (k = 0; k < dimensions; ++k) point1[k] = point0[k];
-		SimplexNoiseGenericHelper<Float>::deskewPoint(dimensions, deskewFactor, i, simplexOrder, point1);
+		for (k = 0; k < d; ++k) point1[k] = point0[k];
+		SimplexNoiseGenericHelper<Float>::template deskewPoint<Dimensions>(d, deskewFactor, i, simplexOrder, point1);
 
-		c1 = static_cast<Float>(maxRadius) - SimplexNoiseGenericHelper<Float>::dot(dimensions, point1, point1);
+		c1 = static_cast<Float>(maxRadius) - SimplexNoiseGenericHelper<Float>::template dot<Dimensions>(d, point1, point1);
 		if (c1 > 0) {
-			SimplexNoiseGenericHelper<Float>::gradient(dimensions, this->perm, pointFloor, simplexOrder, gradient);
-			c1 = ::pow(c1, power);
-			c1 *= SimplexNoiseGenericHelper<Float>::dot(dimensions, gradient, point1);
+			SimplexNoiseGenericHelper<Float>::template gradient<Dimensions>(d, this->perm, pointFloor, simplexOrder, gradient);
+			c1 = power.apply(c1);
+			c1 *= SimplexNoiseGenericHelper<Float>::template dot<Dimensions>(d, gradient, point1);
 
 			// Add to sum
 			c0 += c1;
 		}
 	}
 
-	// Clean
-	delete [] point0;
-	delete [] point1;
-	delete [] gradient;
-	delete [] pointFloor;
-	delete [] simplexOrder;
-	delete [] pointOrder;
-
 	// Done
 	return c0;
 }
@@ -0,0 +1,331 @@
+/*
+	Templated SimplexNoise; fractal brownian motion
+*/
+#ifndef ___H_SIMPLEX_NOISE_FBM
+#define ___H_SIMPLEX_NOISE_FBM
+
+
+
+#include <cstdint>
+#include <vector>
+
+#include "SimplexNoise.hpp"
+
+
+
+// Class definitions
+template <typename Float, int Dimensions>
+class SimplexNoiseFbmHelper;
+
+/**
+	Sum of octaves of noise, with each octave's frequency and amplitude precomputed on construction.
+		fbm(p) = sum(amplitude[i] * noise(rotation[i] * (p * frequency[i]) + offset[i]), i) / sum(amplitude[i], i)
+	The optional per-octave offsets and rotations keep the octaves' lattices from lining up.
+
+	Instead of a plain sum, the octaves can also be combined as (with n[i] being the noise of octave i, and a[i] its amplitude):
+		Turbulence: sum(a[i] * |n[i]|)
+		Ridged multifractal: s[i] = (offset - |n[i]|)^2 * w[i], sum(a[i] * s[i]), where w[0] = 1 and w[i + 1] = clamp(s[i] * weightGain, 0, 1)
+		Hybrid multifractal: s[i] = (n[i] + offset) * a[i], sum(w[i] * s[i]), where w[0] = 1 and w[i + 1] = min(w[i], 1) * s[i]
+	All of them are divided by sum(a[i]) as well, and have analytic derivatives.
+
+	@param Float
+		The floating point type to use
+	@param Dimensions
+		The number of dimensions of the noise; 1 to 4
+*/
+template <typename Float, int Dimensions>
+class SimplexNoiseFbm final {
+	static_assert(Dimensions >= 1 && Dimensions <= 4, "Dimensions must be in the range [1,4]");
+
+public: // Public types
+	typedef typename SimplexNoise<Float>::OctavesInt OctavesInt;
+	typedef typename SimplexNoise<Float>::CountInt CountInt;
+
+	enum class Variant {
+		Fbm,
+		Turbulence,
+		Ridged,
+		Hybrid,
+	};
+
+private: // Private types
+	struct Octave {
+		Float frequency;
+		Float amplitude;
+		Float offset[Dimensions];
+		Float rotation[Dimensions][Dimensions];
+		bool rotated;
+	};
+
+private: // Private static members
+	static constexpr unsigned int batchSize = 64;
+
+private: // Private instance members
+	SimplexNoise<Float> generator;
+	std::vector<Octave> octaves;
+	Float normalization;
+	Variant variant;
+	Float variantOffset;
+	Float weightGain;
+
+public: // Public static methods
+	/**
+		Generates random per-octave offsets and rotations for the constructor.
+
+		@param seed
+			The seed to generate from
+		@param octaves
+			The number of octaves
+		@param offsets
+			Receives octaves * Dimensions values in [0,64)
+		@param rotations
+			Receives octaves row-major Dimensions x Dimensions orthonormal matrices; may be nullptr
+	*/
+	static void
+	generateTransforms(
+		uint64_t seed,
+		OctavesInt octaves,
+		Float* offsets,
+		Float* rotations
+	);
+
+public: // Public instance methods
+	/**
+		@param generator
+			The noise generator to use; it's copied
+		@param octaves
+			The number of octaves
+		@param frequency
+			The frequency of the first octave
+		@param lacunarity
+			The frequency multiplier between successive octaves
+		@param gain
+			The amplitude multiplier between successive octaves; the first octave has an amplitude of 1
+		@param amplitudeTolerance
+			Octaves whose share of the total amplitude is below this are skipped
+	*/
+	SimplexNoiseFbm(
+		const SimplexNoise<Float>& generator,
+		OctavesInt octaves,
+		Float frequency = 1,
+		Float lacunarity = 2,
+		Float gain = static_cast<Float>(0.5),
+		Float amplitudeTolerance = 0
+	);
+
+	/**
+		Same as above, with per-octave offsets and rotations.
+
+		@param offsets
+			octaves * Dimensions values; the offset of octave i is offsets[i * Dimensions : (i + 1) * Dimensions].
+			May be nullptr
+		@param rotations
+			octaves row-major Dimensions x Dimensions matrices; the rotation of octave i starts at rotations[i * Dimensions * Dimensions].
+			May be nullptr
+	*/
+	SimplexNoiseFbm(
+		const SimplexNoise<Float>& generator,
+		OctavesInt octaves,
+		Float frequency,
+		Float lacunarity,
+		Float gain,
+		Float amplitudeTolerance,
+		const Float* offsets,
+		const Float* rotations
+	);
+
+	// The number of octaves which are evaluated
+	OctavesInt
+	getOctaveCount() const;
+
+	/**
+		Changes how octaves are combined; defaults to Variant::Fbm.
+
+		@param variant
+			The way to combine octaves
+		@param offset
+			The offset used by Variant::Ridged and Variant::Hybrid; usually 1 for ridged and 0.7 for hybrid
+		@param weightGain
+			The multiplier of the weight feedback used by Variant::Ridged
+	*/
+	void
+	setVariant(
+		Variant variant,
+		Float offset = 1,
+		Float weightGain = 2
+	);
+
+	Variant
+	getVariant() const;
+
+	/**
+		@param position
+			The position to evaluate at; must contain Dimensions values
+		@return
+			The normalized combination of the octaves; for Variant::Fbm, in the range [-1,1]
+	*/
+	Float
+	noise(
+		const Float* position
+	);
+
+	/**
+		@param position
+			The position to evaluate at; must contain Dimensions values
+		@param derivative
+			The analytic gradient of the result; must have room for Dimensions values
+	*/
+	Float
+	noise(
+		const Float* position,
+		Float* derivative
+	);
+
+	/**
+		@param count
+			The number of positions
+		@param coordinates
+			Dimensions arrays of count values each; coordinates[k][i] is the k-th coordinate of position i
+		@param out
+			The results; must have room for count values
+	*/
+	void
+	noise_batch(
+		CountInt count,
+		const Float* const* coordinates,
+		Float* out
+	);
+
+private: // Private instance methods
+	void
+	transformPoint(
+		const Octave& octave,
+		const Float* position,
+		Float* result
+	) const;
+
+};
+
+// Dimension specific calls to SimplexNoise<Float>
+template <typename Float>
+class SimplexNoiseFbmHelper<Float, 1> final {
+public:
+	typedef typename SimplexNoise<Float>::CountInt CountInt;
+
+	static Float
+	noise(
+		SimplexNoise<Float>& generator,
+		const Float* position
+	);
+
+	static Float
+	noise(
+		SimplexNoise<Float>& generator,
+		const Float* position,
+		Float* derivative
+	);
+
+	static void
+	noise_batch(
+		SimplexNoise<Float>& generator,
+		CountInt count,
+		const Float* const* coordinates,
+		Float* out
+	);
+
+};
+
+template <typename Float>
+class SimplexNoiseFbmHelper<Float, 2> final {
+public:
+	typedef typename SimplexNoise<Float>::CountInt CountInt;
+
+	static Float
+	noise(
+		SimplexNoise<Float>& generator,
+		const Float* position
+	);
+
+	static Float
+	noise(
+		SimplexNoise<Float>& generator,
+		const Float* position,
+		Float* derivative
+	);
+
+	static void
+	noise_batch(
+		SimplexNoise<Float>& generator,
+		CountInt count,
+		const Float* const* coordinates,
+		Float* out
+	);
+
+};
+
+template <typename Float>
+class SimplexNoiseFbmHelper<Float, 3> final {
+public:
+	typedef typename SimplexNoise<Float>::CountInt CountInt;
+
+	static Float
+	noise(
+		SimplexNoise<Float>& generator,
+		const Float* position
+	);
+
+	static Float
+	noise(
+		SimplexNoise<Float>& generator,
+		const Float* position,
+		Float* derivative
+	);
+
+	static void
+	noise_batch(
+		SimplexNoise<Float>& generator,
+		CountInt count,
+		const Float* const* coordinates,
+		Float* out
+	);
+
+};
+
+template <typename Float>
+class SimplexNoiseFbmHelper<Float, 4> final {
+public:
+	typedef typename SimplexNoise<Float>::CountInt CountInt;
+
+	static Float
+	noise(
+		SimplexNoise<Float>& generator,
+		const Float* position
+	);
+
+	static Float
+	noise(
+		SimplexNoise<Float>& generator,
+		const Float* position,
+		Float* derivative
+	);
+
+	static void
+	noise_batch(
+		SimplexNoise<Float>& generator,
+		CountInt count,
+		const Float* const* coordinates,
+		Float* out
+	);
+
+};
+
+
+
+// Template implementations
+#include "SimplexNoiseFbm.t.hpp"
+
+
+
+#endif // ___H_SIMPLEX_NOISE_FBM
+
+
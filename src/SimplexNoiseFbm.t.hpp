@@ -0,0 +1,531 @@
+/*
+	Templated SimplexNoise; fractal brownian motion
+*/
+#include <cassert>
+#include <cmath>
+
+
+
+// SimplexNoiseFbmHelper<Float, Dimensions>
+template <typename Float>
+Float
+SimplexNoiseFbmHelper<Float, 1> :: noise(
+	SimplexNoise<Float>& generator,
+	const Float* position
+) {
+	return generator.noise1(position[0]);
+}
+
+template <typename Float>
+Float
+SimplexNoiseFbmHelper<Float, 1> :: noise(
+	SimplexNoise<Float>& generator,
+	const Float* position,
+	Float* derivative
+) {
+	return generator.noise1(position[0], &derivative[0]);
+}
+
+template <typename Float>
+void
+SimplexNoiseFbmHelper<Float, 1> :: noise_batch(
+	SimplexNoise<Float>& generator,
+	CountInt count,
+	const Float* const* coordinates,
+	Float* out
+) {
+	generator.noise1_batch(count, coordinates[0], out);
+}
+
+template <typename Float>
+Float
+SimplexNoiseFbmHelper<Float, 2> :: noise(
+	SimplexNoise<Float>& generator,
+	const Float* position
+) {
+	return generator.noise2(position[0], position[1]);
+}
+
+template <typename Float>
+Float
+SimplexNoiseFbmHelper<Float, 2> :: noise(
+	SimplexNoise<Float>& generator,
+	const Float* position,
+	Float* derivative
+) {
+	return generator.noise2(position[0], position[1], &derivative[0], &derivative[1]);
+}
+
+template <typename Float>
+void
+SimplexNoiseFbmHelper<Float, 2> :: noise_batch(
+	SimplexNoise<Float>& generator,
+	CountInt count,
+	const Float* const* coordinates,
+	Float* out
+) {
+	generator.noise2_batch(count, coordinates[0], coordinates[1], out);
+}
+
+template <typename Float>
+Float
+SimplexNoiseFbmHelper<Float, 3> :: noise(
+	SimplexNoise<Float>& generator,
+	const Float* position
+) {
+	return generator.noise3(position[0], position[1], position[2]);
+}
+
+template <typename Float>
+Float
+SimplexNoiseFbmHelper<Float, 3> :: noise(
+	SimplexNoise<Float>& generator,
+	const Float* position,
+	Float* derivative
+) {
+	return generator.noise3(position[0], position[1], position[2], &derivative[0], &derivative[1], &derivative[2]);
+}
+
+template <typename Float>
+void
+SimplexNoiseFbmHelper<Float, 3> :: noise_batch(
+	SimplexNoise<Float>& generator,
+	CountInt count,
+	const Float* const* coordinates,
+	Float* out
+) {
+	generator.noise3_batch(count, coordinates[0], coordinates[1], coordinates[2], out);
+}
+
+template <typename Float>
+Float
+SimplexNoiseFbmHelper<Float, 4> :: noise(
+	SimplexNoise<Float>& generator,
+	const Float* position
+) {
+	return generator.noise4(position[0], position[1], position[2], position[3]);
+}
+
+template <typename Float>
+Float
+SimplexNoiseFbmHelper<Float, 4> :: noise(
+	SimplexNoise<Float>& generator,
+	const Float* position,
+	Float* derivative
+) {
+	return generator.noise4(position[0], position[1], position[2], position[3], &derivative[0], &derivative[1], &derivative[2], &derivative[3]);
+}
+
+template <typename Float>
+void
+SimplexNoiseFbmHelper<Float, 4> :: noise_batch(
+	SimplexNoise<Float>& generator,
+	CountInt count,
+	const Float* const* coordinates,
+	Float* out
+) {
+	generator.noise4_batch(count, coordinates[0], coordinates[1], coordinates[2], coordinates[3], out);
+}
+
+
+
+// SimplexNoiseFbm<Float, Dimensions>
+template <typename Float, int Dimensions>
+void
+SimplexNoiseFbm<Float, Dimensions> :: generateTransforms(
+	uint64_t seed,
+	OctavesInt octaves,
+	Float* offsets,
+	Float* rotations
+) {
+	assert(offsets != nullptr);
+
+	// splitmix64, mapped to [0,1)
+	uint64_t state = seed;
+	uint64_t z;
+	auto random = [&state, &z] () -> Float {
+		z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		z ^= (z >> 31);
+		return static_cast<Float>((z >> 11) * (1.0 / 9007199254740992.0));
+	};
+
+	Float* r;
+	Float length, dot;
+	OctavesInt i;
+	int j, k, m;
+
+	for (i = 0; i < octaves; ++i) {
+		for (k = 0; k < Dimensions; ++k) offsets[i * Dimensions + k] = random() * 64;
+
+		if (rotations == nullptr) continue;
+
+		// Gram-Schmidt orthonormalization of random rows
+		r = rotations + i * Dimensions * Dimensions;
+		for (j = 0; j < Dimensions; ++j) {
+			do {
+				for (k = 0; k < Dimensions; ++k) r[j * Dimensions + k] = random() * 2 - 1;
+
+				for (m = 0; m < j; ++m) {
+					dot = 0;
+					for (k = 0; k < Dimensions; ++k) dot += r[j * Dimensions + k] * r[m * Dimensions + k];
+					for (k = 0; k < Dimensions; ++k) r[j * Dimensions + k] -= dot * r[m * Dimensions + k];
+				}
+
+				length = 0;
+				for (k = 0; k < Dimensions; ++k) length += r[j * Dimensions + k] * r[j * Dimensions + k];
+			}
+			while (length < static_cast<Float>(1e-4));
+
+			length = 1 / ::sqrt(length);
+			for (k = 0; k < Dimensions; ++k) r[j * Dimensions + k] *= length;
+		}
+	}
+}
+
+template <typename Float, int Dimensions>
+SimplexNoiseFbm<Float, Dimensions> :: SimplexNoiseFbm(
+	const SimplexNoise<Float>& generator,
+	OctavesInt octaves,
+	Float frequency,
+	Float lacunarity,
+	Float gain,
+	Float amplitudeTolerance
+) :
+	SimplexNoiseFbm(generator, octaves, frequency, lacunarity, gain, amplitudeTolerance, nullptr, nullptr)
+{
+}
+
+template <typename Float, int Dimensions>
+SimplexNoiseFbm<Float, Dimensions> :: SimplexNoiseFbm(
+	const SimplexNoise<Float>& generator,
+	OctavesInt octaves,
+	Float frequency,
+	Float lacunarity,
+	Float gain,
+	Float amplitudeTolerance,
+	const Float* offsets,
+	const Float* rotations
+) :
+	generator(generator),
+	octaves(),
+	normalization(0),
+	variant(Variant::Fbm),
+	variantOffset(1),
+	weightGain(2)
+{
+	assert(amplitudeTolerance >= 0);
+
+	// Frequencies, amplitudes, and transforms
+	Float amplitude = 1;
+	Float total = 0;
+	Octave o;
+	OctavesInt i;
+	int j, k;
+
+	for (i = 0; i < octaves; ++i) {
+		o.frequency = frequency;
+		o.amplitude = amplitude;
+		for (k = 0; k < Dimensions; ++k) {
+			o.offset[k] = (offsets != nullptr) ? offsets[i * Dimensions + k] : 0;
+		}
+		o.rotated = (rotations != nullptr);
+		for (j = 0; j < Dimensions; ++j) {
+			for (k = 0; k < Dimensions; ++k) {
+				o.rotation[j][k] = o.rotated ? rotations[(i * Dimensions + j) * Dimensions + k] : static_cast<Float>(j == k);
+			}
+		}
+		this->octaves.push_back(o);
+		total += amplitude;
+
+		frequency *= lacunarity;
+		amplitude *= gain;
+	}
+
+	// Skip octaves which contribute too little
+	if (amplitudeTolerance > 0) {
+		Float totalRemoved = 0;
+		for (i = 0; i < this->octaves.size(); ) {
+			if (this->octaves[i].amplitude < amplitudeTolerance * total) {
+				totalRemoved += this->octaves[i].amplitude;
+				this->octaves.erase(this->octaves.begin() + i);
+			}
+			else {
+				++i;
+			}
+		}
+		total -= totalRemoved;
+	}
+
+	if (total > 0) {
+		this->normalization = 1 / total;
+	}
+}
+
+template <typename Float, int Dimensions>
+typename SimplexNoiseFbm<Float, Dimensions>::OctavesInt
+SimplexNoiseFbm<Float, Dimensions> :: getOctaveCount() const {
+	return static_cast<OctavesInt>(this->octaves.size());
+}
+
+template <typename Float, int Dimensions>
+void
+SimplexNoiseFbm<Float, Dimensions> :: setVariant(
+	Variant variant,
+	Float offset,
+	Float weightGain
+) {
+	this->variant = variant;
+	this->variantOffset = offset;
+	this->weightGain = weightGain;
+}
+
+template <typename Float, int Dimensions>
+typename SimplexNoiseFbm<Float, Dimensions>::Variant
+SimplexNoiseFbm<Float, Dimensions> :: getVariant() const {
+	return this->variant;
+}
+
+template <typename Float, int Dimensions>
+Float
+SimplexNoiseFbm<Float, Dimensions> :: noise(
+	const Float* position
+) {
+	assert(position != nullptr);
+
+	Float p[Dimensions];
+	Float n = 0;
+	Float v, s;
+	Float weight = 1;
+
+	for (const Octave& o : this->octaves) {
+		this->transformPoint(o, position, p);
+		v = SimplexNoiseFbmHelper<Float, Dimensions>::noise(this->generator, p);
+
+		switch (this->variant) {
+			case Variant::Fbm:
+				n += v * o.amplitude;
+			break;
+			case Variant::Turbulence:
+				n += ((v < 0) ? -v : v) * o.amplitude;
+			break;
+			case Variant::Ridged:
+				s = this->variantOffset - ((v < 0) ? -v : v);
+				s *= s * weight;
+				n += s * o.amplitude;
+				weight = s * this->weightGain;
+				if (weight < 0) weight = 0;
+				else if (weight > 1) weight = 1;
+			break;
+			default: // Variant::Hybrid
+				if (weight > 1) weight = 1;
+				s = (v + this->variantOffset) * o.amplitude;
+				n += weight * s;
+				weight *= s;
+			break;
+		}
+	}
+
+	return n * this->normalization;
+}
+
+template <typename Float, int Dimensions>
+Float
+SimplexNoiseFbm<Float, Dimensions> :: noise(
+	const Float* position,
+	Float* derivative
+) {
+	assert(position != nullptr);
+	assert(derivative != nullptr);
+
+	Float p[Dimensions];
+	Float d[Dimensions];
+	Float dv[Dimensions];
+	Float weightDerivative[Dimensions];
+	Float n = 0;
+	Float v, s, a, sign, scale;
+	Float weight = 1;
+	int j, k;
+
+	for (k = 0; k < Dimensions; ++k) {
+		derivative[k] = 0;
+		weightDerivative[k] = 0;
+	}
+
+	for (const Octave& o : this->octaves) {
+		this->transformPoint(o, position, p);
+		v = SimplexNoiseFbmHelper<Float, Dimensions>::noise(this->generator, p, d);
+
+		// d/dp noise(R * p * frequency + offset) = frequency * transpose(R) * noise'(...)
+		if (o.rotated) {
+			for (k = 0; k < Dimensions; ++k) {
+				dv[k] = 0;
+				for (j = 0; j < Dimensions; ++j) dv[k] += o.rotation[j][k] * d[j];
+				dv[k] *= o.frequency;
+			}
+		}
+		else {
+			for (k = 0; k < Dimensions; ++k) dv[k] = d[k] * o.frequency;
+		}
+
+		switch (this->variant) {
+			case Variant::Fbm:
+				n += v * o.amplitude;
+				for (k = 0; k < Dimensions; ++k) derivative[k] += dv[k] * o.amplitude;
+			break;
+			case Variant::Turbulence:
+				sign = (v < 0) ? -1 : 1;
+				n += v * sign * o.amplitude;
+				scale = sign * o.amplitude;
+				for (k = 0; k < Dimensions; ++k) derivative[k] += dv[k] * scale;
+			break;
+			case Variant::Ridged:
+				// s = a^2 * weight, with a = offset - |v|; evaluated in the same order as noise(position)
+				sign = (v < 0) ? -1 : 1;
+				a = this->variantOffset - v * sign;
+				s = a * (a * weight);
+				n += s * o.amplitude;
+				for (k = 0; k < Dimensions; ++k) {
+					// ds = -2 * a * sign(v) * dv * weight + a^2 * dweight; reuses dv for ds
+					dv[k] = a * (a * weightDerivative[k] - 2 * sign * dv[k] * weight);
+					derivative[k] += dv[k] * o.amplitude;
+				}
+
+				weight = s * this->weightGain;
+				if (weight <= 0 || weight >= 1) {
+					weight = (weight <= 0) ? 0 : 1;
+					for (k = 0; k < Dimensions; ++k) weightDerivative[k] = 0;
+				}
+				else {
+					for (k = 0; k < Dimensions; ++k) weightDerivative[k] = dv[k] * this->weightGain;
+				}
+			break;
+			default: // Variant::Hybrid
+				if (weight > 1) {
+					weight = 1;
+					for (k = 0; k < Dimensions; ++k) weightDerivative[k] = 0;
+				}
+				s = (v + this->variantOffset) * o.amplitude;
+				n += weight * s;
+				for (k = 0; k < Dimensions; ++k) {
+					// d(weight * s) is both the change of the sum and of the next weight
+					weightDerivative[k] = weightDerivative[k] * s + weight * dv[k] * o.amplitude;
+					derivative[k] += weightDerivative[k];
+				}
+				weight *= s;
+			break;
+		}
+	}
+
+	for (k = 0; k < Dimensions; ++k) derivative[k] *= this->normalization;
+	return n * this->normalization;
+}
+
+template <typename Float, int Dimensions>
+void
+SimplexNoiseFbm<Float, Dimensions> :: noise_batch(
+	CountInt count,
+	const Float* const* coordinates,
+	Float* out
+) {
+	assert(count == 0 || coordinates != nullptr);
+	assert(count == 0 || out != nullptr);
+
+	// Per-block scratch; each octave is evaluated for a whole block so the vectorized batch kernels can be used
+	Float scaled[Dimensions][batchSize];
+	const Float* scaledPointers[Dimensions];
+	Float octaveValues[batchSize];
+	Float weights[batchSize];
+	Float p[Dimensions];
+	Float q[Dimensions];
+	Float v, s;
+	CountInt offset, i, n;
+	int k;
+
+	for (k = 0; k < Dimensions; ++k) scaledPointers[k] = scaled[k];
+
+	for (offset = 0; offset < count; offset += n) {
+		n = (count - offset < batchSize) ? count - offset : batchSize;
+
+		for (i = 0; i < n; ++i) {
+			out[offset + i] = 0;
+			weights[i] = 1;
+		}
+
+		for (const Octave& o : this->octaves) {
+			if (o.rotated) {
+				for (i = 0; i < n; ++i) {
+					for (k = 0; k < Dimensions; ++k) p[k] = coordinates[k][offset + i];
+					this->transformPoint(o, p, q);
+					for (k = 0; k < Dimensions; ++k) scaled[k][i] = q[k];
+				}
+			}
+			else {
+				for (k = 0; k < Dimensions; ++k) {
+					for (i = 0; i < n; ++i) scaled[k][i] = coordinates[k][offset + i] * o.frequency + o.offset[k];
+				}
+			}
+
+			SimplexNoiseFbmHelper<Float, Dimensions>::noise_batch(this->generator, n, scaledPointers, octaveValues);
+
+			// Same as noise(position)
+			switch (this->variant) {
+				case Variant::Fbm:
+					for (i = 0; i < n; ++i) out[offset + i] += octaveValues[i] * o.amplitude;
+				break;
+				case Variant::Turbulence:
+					for (i = 0; i < n; ++i) {
+						v = octaveValues[i];
+						out[offset + i] += ((v < 0) ? -v : v) * o.amplitude;
+					}
+				break;
+				case Variant::Ridged:
+					for (i = 0; i < n; ++i) {
+						v = octaveValues[i];
+						s = this->variantOffset - ((v < 0) ? -v : v);
+						s *= s * weights[i];
+						out[offset + i] += s * o.amplitude;
+						s *= this->weightGain;
+						weights[i] = (s < 0) ? 0 : ((s > 1) ? 1 : s);
+					}
+				break;
+				default: // Variant::Hybrid
+					for (i = 0; i < n; ++i) {
+						if (weights[i] > 1) weights[i] = 1;
+						s = (octaveValues[i] + this->variantOffset) * o.amplitude;
+						out[offset + i] += weights[i] * s;
+						weights[i] *= s;
+					}
+				break;
+			}
+		}
+
+		for (i = 0; i < n; ++i) out[offset + i] *= this->normalization;
+	}
+}
+
+template <typename Float, int Dimensions>
+void
+SimplexNoiseFbm<Float, Dimensions> :: transformPoint(
+	const Octave& octave,
+	const Float* position,
+	Float* result
+) const {
+	Float scaled[Dimensions];
+	int j, k;
+
+	for (k = 0; k < Dimensions; ++k) scaled[k] = position[k] * octave.frequency;
+
+	if (octave.rotated) {
+		for (j = 0; j < Dimensions; ++j) {
+			result[j] = octave.offset[j];
+			for (k = 0; k < Dimensions; ++k) result[j] += octave.rotation[j][k] * scaled[k];
+		}
+	}
+	else {
+		for (k = 0; k < Dimensions; ++k) result[k] = scaled[k] + octave.offset[k];
+	}
+}
+
+
@@ -0,0 +1,137 @@
+/*
+	Templated SimplexNoise; tiled image generation
+*/
+#ifndef ___H_SIMPLEX_NOISE_IMAGE
+#define ___H_SIMPLEX_NOISE_IMAGE
+
+
+
+#include <cstddef>
+#include <functional>
+
+#include "SimplexNoiseThreadPool.hpp"
+
+
+
+// Class definitions
+template <typename Float>
+class SimplexNoiseImage final {
+public: // Public types
+	typedef std::size_t CountInt;
+
+	/**
+		Fills one tile of the image.
+
+		@param x
+			The x coordinate of the tile's first pixel
+		@param y
+			The y coordinate of the tile's first pixel
+		@param width
+			The width of the tile
+		@param height
+			The height of the tile
+		@param out
+			The tile's values; pixel (x + i, y + j) is out[j * stride + i]
+		@param stride
+			The distance between rows of out
+		@param thread
+			The index of the thread filling the tile; useful for per-thread scratch space
+	*/
+	typedef std::function<void(CountInt x, CountInt y, CountInt width, CountInt height, Float* out, CountInt stride, unsigned int thread)> TileFunction;
+
+public: // Public static members
+	// 64x64 tiles keep a tile of doubles within 32KB
+	static constexpr CountInt defaultTileSize = 64;
+
+private: // Private instance members
+	CountInt width;
+	CountInt height;
+	CountInt tileWidth;
+	CountInt tileHeight;
+	CountInt tilesX;
+	CountInt tilesY;
+	Float* values;
+	Float* tileMinimum;
+	Float* tileMaximum;
+	Float minimum;
+	Float maximum;
+
+public: // Public instance methods
+	SimplexNoiseImage(
+		CountInt width,
+		CountInt height,
+		CountInt tileWidth = defaultTileSize,
+		CountInt tileHeight = defaultTileSize
+	);
+	SimplexNoiseImage(const SimplexNoiseImage<Float>&) = delete;
+	~SimplexNoiseImage();
+
+	SimplexNoiseImage<Float>& operator = (const SimplexNoiseImage<Float>&) = delete;
+
+	CountInt
+	getWidth() const;
+
+	CountInt
+	getHeight() const;
+
+	// Row-major values; pixel (x, y) is getValues()[y * getWidth() + x]
+	const Float*
+	getValues() const;
+
+	Float*
+	getValues();
+
+	// The range of the values from the last call to generate
+	Float
+	getMinimum() const;
+
+	Float
+	getMaximum() const;
+
+	/**
+		Fills every tile of the image using function, then finds the range of the values.
+		Tiles are evaluated on the threads of pool, and each tile's range is found
+		by the thread which filled it.
+
+		@param pool
+			The thread pool to use
+		@param function
+			The function used to fill each tile; it must be safe to call from multiple threads at once
+	*/
+	void
+	generate(
+		SimplexNoiseThreadPool& pool,
+		const TileFunction& function
+	);
+
+	/**
+		Same as above, but only uses the calling thread.
+	*/
+	void
+	generate(
+		const TileFunction& function
+	);
+
+private: // Private instance methods
+	void
+	generateTile(
+		CountInt tile,
+		const TileFunction& function,
+		unsigned int thread
+	);
+
+	void
+	mergeRanges();
+
+};
+
+
+
+// Template implementations
+#include "SimplexNoiseImage.t.hpp"
+
+
+
+#endif // ___H_SIMPLEX_NOISE_IMAGE
+
+
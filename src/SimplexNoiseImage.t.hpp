@@ -0,0 +1,149 @@
+/*
+	Templated SimplexNoise; tiled image generation
+*/
+#include <cassert>
+
+
+
+// SimplexNoiseImage<Float>
+template <typename Float>
+constexpr typename SimplexNoiseImage<Float>::CountInt SimplexNoiseImage<Float> :: defaultTileSize;
+
+template <typename Float>
+SimplexNoiseImage<Float> :: SimplexNoiseImage(
+	CountInt width,
+	CountInt height,
+	CountInt tileWidth,
+	CountInt tileHeight
+) :
+	width(width),
+	height(height),
+	tileWidth(tileWidth),
+	tileHeight(tileHeight),
+	tilesX((width + tileWidth - 1) / tileWidth),
+	tilesY((height + tileHeight - 1) / tileHeight),
+	values(new Float[width * height]),
+	tileMinimum(new Float[tilesX * tilesY]),
+	tileMaximum(new Float[tilesX * tilesY]),
+	minimum(0),
+	maximum(0)
+{
+	assert(width > 0);
+	assert(height > 0);
+	assert(tileWidth > 0);
+	assert(tileHeight > 0);
+}
+
+template <typename Float>
+SimplexNoiseImage<Float> :: ~SimplexNoiseImage() {
+	delete [] this->values;
+	delete [] this->tileMinimum;
+	delete [] this->tileMaximum;
+}
+
+template <typename Float>
+typename SimplexNoiseImage<Float>::CountInt
+SimplexNoiseImage<Float> :: getWidth() const {
+	return this->width;
+}
+
+template <typename Float>
+typename SimplexNoiseImage<Float>::CountInt
+SimplexNoiseImage<Float> :: getHeight() const {
+	return this->height;
+}
+
+template <typename Float>
+const Float*
+SimplexNoiseImage<Float> :: getValues() const {
+	return this->values;
+}
+
+template <typename Float>
+Float*
+SimplexNoiseImage<Float> :: getValues() {
+	return this->values;
+}
+
+template <typename Float>
+Float
+SimplexNoiseImage<Float> :: getMinimum() const {
+	return this->minimum;
+}
+
+template <typename Float>
+Float
+SimplexNoiseImage<Float> :: getMaximum() const {
+	return this->maximum;
+}
+
+template <typename Float>
+void
+SimplexNoiseImage<Float> :: generate(
+	SimplexNoiseThreadPool& pool,
+	const TileFunction& function
+) {
+	pool.run(this->tilesX * this->tilesY, [this, &function] (CountInt tile, unsigned int thread) {
+		this->generateTile(tile, function, thread);
+	});
+
+	this->mergeRanges();
+}
+
+template <typename Float>
+void
+SimplexNoiseImage<Float> :: generate(
+	const TileFunction& function
+) {
+	for (CountInt tile = 0; tile < this->tilesX * this->tilesY; ++tile) {
+		this->generateTile(tile, function, 0);
+	}
+
+	this->mergeRanges();
+}
+
+template <typename Float>
+void
+SimplexNoiseImage<Float> :: generateTile(
+	CountInt tile,
+	const TileFunction& function,
+	unsigned int thread
+) {
+	CountInt x = (tile % this->tilesX) * this->tileWidth;
+	CountInt y = (tile / this->tilesX) * this->tileHeight;
+	CountInt w = (this->width - x < this->tileWidth) ? this->width - x : this->tileWidth;
+	CountInt h = (this->height - y < this->tileHeight) ? this->height - y : this->tileHeight;
+	Float* out = this->values + y * this->width + x;
+
+	// Fill
+	function(x, y, w, h, out, this->width, thread);
+
+	// Range
+	Float min = out[0];
+	Float max = out[0];
+	Float v;
+	for (CountInt j = 0; j < h; ++j) {
+		for (CountInt i = 0; i < w; ++i) {
+			v = out[j * this->width + i];
+			if (v < min) min = v;
+			if (v > max) max = v;
+		}
+	}
+
+	this->tileMinimum[tile] = min;
+	this->tileMaximum[tile] = max;
+}
+
+template <typename Float>
+void
+SimplexNoiseImage<Float> :: mergeRanges() {
+	this->minimum = this->tileMinimum[0];
+	this->maximum = this->tileMaximum[0];
+
+	for (CountInt tile = 1; tile < this->tilesX * this->tilesY; ++tile) {
+		if (this->tileMinimum[tile] < this->minimum) this->minimum = this->tileMinimum[tile];
+		if (this->tileMaximum[tile] > this->maximum) this->maximum = this->tileMaximum[tile];
+	}
+}
+
+
@@ -0,0 +1,262 @@
+/*
+	Templated SimplexNoise; image writer
+*/
+#include "SimplexNoiseImageWriter.hpp"
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+
+
+// SimplexNoiseImageWriter
+SimplexNoiseImageWriter :: SimplexNoiseImageWriter() :
+	file(nullptr),
+	ownsFile(false),
+	failed(false),
+	format(Format::Gray8),
+	width(0),
+	height(0),
+	rowsWritten(0),
+	buffer(nullptr),
+	minimum(0.0),
+	range(1.0),
+	bias(0.0)
+{
+}
+
+SimplexNoiseImageWriter :: ~SimplexNoiseImageWriter() {
+	this->close();
+}
+
+bool
+SimplexNoiseImageWriter :: open(
+	const char* filename,
+	Format format,
+	CountInt width,
+	CountInt height
+) {
+	assert(filename != nullptr);
+	assert(width > 0);
+	assert(height > 0);
+
+	this->close();
+
+	if (strcmp(filename, "-") == 0) {
+		this->file = stdout;
+		this->ownsFile = false;
+#ifdef _WIN32
+		// put into binary mode on windows
+		_setmode(_fileno(stdout), _O_BINARY);
+#endif
+	}
+	else {
+		this->file = fopen(filename, "wb");
+		this->ownsFile = true;
+		if (this->file == nullptr) return false;
+	}
+
+	this->failed = false;
+	this->format = format;
+	this->width = width;
+	this->height = height;
+	this->rowsWritten = 0;
+
+	// 4 bytes per value is enough for every format: a float, or up to 3 ascii digits and a newline
+	this->buffer = new unsigned char[width * 4];
+
+	// Header
+	int result;
+	switch (format) {
+		case Format::Gray8:
+			result = fprintf(this->file, "P5\n%lu %lu\n255\n", static_cast<unsigned long>(width), static_cast<unsigned long>(height));
+		break;
+		case Format::Gray16:
+			result = fprintf(this->file, "P5\n%lu %lu\n65535\n", static_cast<unsigned long>(width), static_cast<unsigned long>(height));
+		break;
+		case Format::Gray8Ascii:
+			result = fprintf(this->file, "P2\n%lu %lu\n255\n", static_cast<unsigned long>(width), static_cast<unsigned long>(height));
+		break;
+		default: // Format::Float32
+		{
+			// A negative scale means little endian
+			uint16_t endianTest = 1;
+			bool littleEndian = (*reinterpret_cast<unsigned char*>(&endianTest) == 1);
+			result = fprintf(this->file, "Pf\n%lu %lu\n%s\n", static_cast<unsigned long>(width), static_cast<unsigned long>(height), littleEndian ? "-1.0" : "1.0");
+		}
+		break;
+	}
+
+	if (result < 0) this->failed = true;
+	return !this->failed;
+}
+
+void
+SimplexNoiseImageWriter :: setRange(
+	double minimum,
+	double maximum
+) {
+	this->minimum = minimum;
+	this->range = maximum - minimum;
+	this->bias = 0.0;
+}
+
+void
+SimplexNoiseImageWriter :: setSymmetricRange(
+	double extent
+) {
+	this->minimum = 0.0;
+	this->range = extent * 2.0;
+	this->bias = 0.5;
+}
+
+bool
+SimplexNoiseImageWriter :: writeRow(
+	const float* values
+) {
+	return this->writeRowTemplate<float>(values);
+}
+
+bool
+SimplexNoiseImageWriter :: writeRow(
+	const double* values
+) {
+	return this->writeRowTemplate<double>(values);
+}
+
+bool
+SimplexNoiseImageWriter :: writeImage(
+	const float* values,
+	CountInt stride
+) {
+	return this->writeImageTemplate<float>(values, stride);
+}
+
+bool
+SimplexNoiseImageWriter :: writeImage(
+	const double* values,
+	CountInt stride
+) {
+	return this->writeImageTemplate<double>(values, stride);
+}
+
+bool
+SimplexNoiseImageWriter :: close() {
+	bool success = !this->failed;
+
+	if (this->file != nullptr) {
+		if (this->ownsFile) {
+			if (fclose(this->file) != 0) success = false;
+		}
+		else {
+			if (fflush(this->file) != 0) success = false;
+		}
+		this->file = nullptr;
+	}
+
+	delete [] this->buffer;
+	this->buffer = nullptr;
+
+	return success;
+}
+
+template <typename Float>
+bool
+SimplexNoiseImageWriter :: writeRowTemplate(
+	const Float* values
+) {
+	assert(this->file != nullptr);
+	assert(values != nullptr);
+	assert(this->rowsWritten < this->height);
+
+	if (this->failed) return false;
+
+	unsigned char* b = this->buffer;
+	double n;
+	unsigned int px;
+	float f;
+	CountInt i;
+
+	// Quantize the row
+	if (this->format == Format::Float32) {
+		for (i = 0; i < this->width; ++i) {
+			f = static_cast<float>(values[i]);
+			memcpy(b, &f, sizeof(float));
+			b += sizeof(float);
+		}
+	}
+	else {
+		unsigned int maxValue = (this->format == Format::Gray16) ? 65535 : 255;
+
+		for (i = 0; i < this->width; ++i) {
+			if (this->range == 0) {
+				n = 0.5;
+			}
+			else {
+				n = this->bias + (values[i] - this->minimum) / this->range;
+				if (n < 0.0) n = 0.0;
+				else if (n > 1.0) n = 1.0;
+			}
+			px = static_cast<unsigned int>(n * maxValue + 0.5);
+
+			switch (this->format) {
+				case Format::Gray8:
+					*(b++) = static_cast<unsigned char>(px);
+				break;
+				case Format::Gray16:
+					// Big endian
+					*(b++) = static_cast<unsigned char>(px >> 8);
+					*(b++) = static_cast<unsigned char>(px & 0xFF);
+				break;
+				default: // Format::Gray8Ascii
+					if (px >= 100) *(b++) = static_cast<unsigned char>('0' + px / 100);
+					if (px >= 10) *(b++) = static_cast<unsigned char>('0' + (px / 10) % 10);
+					*(b++) = static_cast<unsigned char>('0' + px % 10);
+					*(b++) = '\n';
+				break;
+			}
+		}
+	}
+
+	// Write
+	CountInt size = static_cast<CountInt>(b - this->buffer);
+	if (fwrite(this->buffer, 1, size, this->file) != size) {
+		this->failed = true;
+		return false;
+	}
+
+	++this->rowsWritten;
+	return true;
+}
+
+template <typename Float>
+bool
+SimplexNoiseImageWriter :: writeImageTemplate(
+	const Float* values,
+	CountInt stride
+) {
+	assert(values != nullptr);
+	assert(stride >= this->width);
+
+	CountInt y;
+
+	if (this->format == Format::Float32) {
+		// Bottom to top
+		for (y = this->height; y > 0; --y) {
+			if (!this->writeRowTemplate<Float>(values + (y - 1) * stride)) return false;
+		}
+	}
+	else {
+		for (y = 0; y < this->height; ++y) {
+			if (!this->writeRowTemplate<Float>(values + y * stride)) return false;
+		}
+	}
+
+	return true;
+}
+
+
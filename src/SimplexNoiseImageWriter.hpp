@@ -0,0 +1,159 @@
+/*
+	Templated SimplexNoise; image writer
+*/
+#ifndef ___H_SIMPLEX_NOISE_IMAGE_WRITER
+#define ___H_SIMPLEX_NOISE_IMAGE_WRITER
+
+
+
+#include <cstddef>
+#include <cstdio>
+
+
+
+// Class definitions
+class SimplexNoiseImageWriter final {
+public: // Public types
+	typedef std::size_t CountInt;
+
+	enum class Format {
+		Gray8,      // P5, maxval 255
+		Gray16,     // P5, maxval 65535
+		Gray8Ascii, // P2, maxval 255
+		Float32,    // PFM, single channel; values are written as-is
+	};
+
+private: // Private instance members
+	FILE* file;
+	bool ownsFile;
+	bool failed;
+	Format format;
+	CountInt width;
+	CountInt height;
+	CountInt rowsWritten;
+	unsigned char* buffer;
+	double minimum;
+	double range;
+	double bias;
+
+public: // Public instance methods
+	SimplexNoiseImageWriter();
+	SimplexNoiseImageWriter(const SimplexNoiseImageWriter&) = delete;
+	~SimplexNoiseImageWriter();
+
+	SimplexNoiseImageWriter& operator = (const SimplexNoiseImageWriter&) = delete;
+
+	/**
+		Opens a file and writes the image header.
+
+		@param filename
+			The file to write to, or "-" for stdout
+		@param format
+			The output format
+		@param width
+			The width of the image
+		@param height
+			The height of the image
+		@return
+			true on success
+	*/
+	bool
+	open(
+		const char* filename,
+		Format format,
+		CountInt width,
+		CountInt height
+	);
+
+	/**
+		Sets the range mapped onto [0, maxval] for the integer formats; values outside of it are clamped.
+		Values are quantized as (value - minimum) / (maximum - minimum).
+		If maximum == minimum, every value maps to the middle.
+		Defaults to [0, 1].
+	*/
+	void
+	setRange(
+		double minimum,
+		double maximum
+	);
+
+	/**
+		Same as setRange(-extent, extent), but values are quantized as 0.5 + value / (2 * extent),
+		so 0 always maps exactly to the middle.
+	*/
+	void
+	setSymmetricRange(
+		double extent
+	);
+
+	/**
+		Writes the next row of the file using a single write call.
+		Rows are written in file order, which is bottom to top for PFM.
+
+		@param values
+			The row's values; must contain width values
+		@return
+			true on success
+	*/
+	bool
+	writeRow(
+		const float* values
+	);
+
+	bool
+	writeRow(
+		const double* values
+	);
+
+	/**
+		Writes a whole top to bottom image, in the right row order for the format.
+
+		@param values
+			The image's values; pixel (x, y) is values[y * stride + x]
+		@param stride
+			The distance between rows of values
+		@return
+			true on success
+	*/
+	bool
+	writeImage(
+		const float* values,
+		CountInt stride
+	);
+
+	bool
+	writeImage(
+		const double* values,
+		CountInt stride
+	);
+
+	/**
+		Flushes and closes the file; stdout is only flushed.
+
+		@return
+			true if everything was written successfully
+	*/
+	bool
+	close();
+
+private: // Private instance methods
+	template <typename Float>
+	bool
+	writeRowTemplate(
+		const Float* values
+	);
+
+	template <typename Float>
+	bool
+	writeImageTemplate(
+		const Float* values,
+		CountInt stride
+	);
+
+};
+
+
+
+#endif // ___H_SIMPLEX_NOISE_IMAGE_WRITER
+
+
@@ -0,0 +1,2033 @@
+/*
+	Templated SimplexNoise; vectorized kernels
+*/
+#include "SimplexNoise.hpp"
+
+
+
+#if !defined(SIMPLEX_NOISE_NO_SIMD) && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+	#define SIMPLEX_NOISE_SIMD_X86
+#endif
+
+#ifdef SIMPLEX_NOISE_SIMD_X86
+	#include <immintrin.h>
+
+	// Check compiler
+	#ifdef _MSC_VER
+		// Visual C++ (not tested); intrinsics are usable without enabling the instruction set globally
+		#include <intrin.h>
+		#define TARGET_AVX2
+		#define TARGET_AVX512F
+	#else
+		// Default: assume g++; only the kernels are compiled for AVX2/AVX-512, so the rest of the program still runs anywhere
+		#define TARGET_AVX2 __attribute__((target("avx2")))
+		#define TARGET_AVX512F __attribute__((target("avx512f")))
+
+		// AVX-512F implies FMA; don't let multiply-adds be fused, so the results match the scalar code exactly
+		#pragma GCC optimize("fp-contract=off")
+
+		// g++ 12 reports the intentionally undefined operands used inside the AVX-512 intrinsics
+		#pragma GCC diagnostic ignored "-Wuninitialized"
+		#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+	#endif
+#endif
+
+
+
+// Feature detection
+bool
+SimplexNoiseSimd :: hasAvx2() {
+#ifdef SIMPLEX_NOISE_SIMD_X86
+	#ifdef _MSC_VER
+		static const bool supported = []() {
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7) return false;
+
+			// OSXSAVE and AVX, then YMM state enabled by the OS
+			__cpuid(info, 1);
+			if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) return false;
+			if ((_xgetbv(0) & 0x6) != 0x6) return false;
+
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+		}();
+	#else
+		static const bool supported = (__builtin_cpu_supports("avx2") != 0);
+	#endif
+
+	return supported;
+#else
+	return false;
+#endif
+}
+
+bool
+SimplexNoiseSimd :: hasAvx512f() {
+#ifdef SIMPLEX_NOISE_SIMD_X86
+	#ifdef _MSC_VER
+		static const bool supported = []() {
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7) return false;
+
+			// OSXSAVE, then YMM, ZMM and opmask state enabled by the OS
+			__cpuid(info, 1);
+			if ((info[2] & (1 << 27)) == 0) return false;
+			if ((_xgetbv(0) & 0xE6) != 0xE6) return false;
+
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 16)) != 0;
+		}();
+	#else
+		static const bool supported = (__builtin_cpu_supports("avx512f") != 0);
+	#endif
+
+	return supported;
+#else
+	return false;
+#endif
+}
+
+
+
+#ifdef SIMPLEX_NOISE_SIMD_X86
+
+/**
+	Vector operations for the AVX2 kernels.
+	The kernels are written once against this interface; the float version
+	processes 8 values at a time and the double version processes 4.
+*/
+class SimplexNoiseAvx2Float final {
+public:
+	typedef float Float;
+	typedef __m256 Vector;
+	typedef __m256i IntVector;
+
+	static constexpr int width = 8;
+
+	static TARGET_AVX2 inline Vector load(const Float* p) { return _mm256_loadu_ps(p); }
+	static TARGET_AVX2 inline void store(Float* p, Vector a) { _mm256_storeu_ps(p, a); }
+	static TARGET_AVX2 inline Vector set(Float v) { return _mm256_set1_ps(v); }
+	static TARGET_AVX2 inline IntVector seti(int32_t v) { return _mm256_set1_epi32(v); }
+
+	static TARGET_AVX2 inline Vector add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+	static TARGET_AVX2 inline Vector sub(Vector a, Vector b) { return _mm256_sub_ps(a, b); }
+	static TARGET_AVX2 inline Vector mul(Vector a, Vector b) { return _mm256_mul_ps(a, b); }
+	static TARGET_AVX2 inline Vector div(Vector a, Vector b) { return _mm256_div_ps(a, b); }
+	static TARGET_AVX2 inline Vector max(Vector a, Vector b) { return _mm256_max_ps(a, b); }
+
+	static TARGET_AVX2 inline Vector bitAnd(Vector a, Vector b) { return _mm256_and_ps(a, b); }
+	static TARGET_AVX2 inline Vector bitOr(Vector a, Vector b) { return _mm256_or_ps(a, b); }
+	static TARGET_AVX2 inline Vector bitXor(Vector a, Vector b) { return _mm256_xor_ps(a, b); }
+	static TARGET_AVX2 inline Vector bitAndNot(Vector a, Vector b) { return _mm256_andnot_ps(a, b); } // (~a & b)
+	static TARGET_AVX2 inline Vector select(Vector mask, Vector a, Vector b) { return _mm256_blendv_ps(b, a, mask); } // (mask ? a : b)
+	static TARGET_AVX2 inline Vector compareGreaterEqual(Vector a, Vector b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+	static TARGET_AVX2 inline Vector allBits() { return _mm256_castsi256_ps(_mm256_set1_epi32(-1)); }
+
+	static TARGET_AVX2 inline IntVector addi(IntVector a, IntVector b) { return _mm256_add_epi32(a, b); }
+	static TARGET_AVX2 inline IntVector andi(IntVector a, IntVector b) { return _mm256_and_si256(a, b); }
+	static TARGET_AVX2 inline IntVector subi(IntVector a, IntVector b) { return _mm256_sub_epi32(a, b); }
+	static TARGET_AVX2 inline IntVector halfi(IntVector a) { return _mm256_srai_epi32(a, 1); } // (a / 2) for even a
+
+	// Same result as SimplexNoise<Float>::wrap_period for values at most a period out of [0,period)
+	static TARGET_AVX2 inline IntVector wrapi(IntVector a, IntVector period) {
+		a = _mm256_add_epi32(a, _mm256_and_si256(_mm256_cmpgt_epi32(_mm256_setzero_si256(), a), period));
+		return _mm256_sub_epi32(a, _mm256_andnot_si256(_mm256_cmpgt_epi32(period, a), period));
+	}
+
+	// Same result as SimplexNoise<float>::fast_floor
+	static TARGET_AVX2 inline IntVector floor(Vector a) { return _mm256_cvttps_epi32(_mm256_floor_ps(a)); }
+	static TARGET_AVX2 inline Vector toFloat(IntVector a) { return _mm256_cvtepi32_ps(a); }
+	static TARGET_AVX2 inline IntVector maskToInt(Vector mask) { return _mm256_srli_epi32(_mm256_castps_si256(mask), 31); }
+
+	// Lanes where (a & bit) != 0
+	static TARGET_AVX2 inline Vector bitMask(IntVector a, int32_t bit) {
+		IntVector b = _mm256_set1_epi32(bit);
+		return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(a, b), b));
+	}
+
+	// permutationArray[index] for indices in [0, 511]
+	static TARGET_AVX2 inline IntVector permute(const unsigned char* permutationArray, IntVector index) {
+		// Gathers read 4 bytes, so read the 4 bytes ending at the index (or starting at 0) to stay inside the array
+		IntVector start = _mm256_max_epi32(_mm256_sub_epi32(index, _mm256_set1_epi32(3)), _mm256_setzero_si256());
+		IntVector shift = _mm256_slli_epi32(_mm256_sub_epi32(index, start), 3);
+		IntVector v = _mm256_i32gather_epi32(reinterpret_cast<const int*>(permutationArray), start, 1);
+		return _mm256_and_si256(_mm256_srlv_epi32(v, shift), _mm256_set1_epi32(0xFF));
+	}
+
+};
+
+class SimplexNoiseAvx2Double final {
+public:
+	typedef double Float;
+	typedef __m256d Vector;
+	typedef __m128i IntVector;
+
+	static constexpr int width = 4;
+
+	static TARGET_AVX2 inline Vector load(const Float* p) { return _mm256_loadu_pd(p); }
+	static TARGET_AVX2 inline void store(Float* p, Vector a) { _mm256_storeu_pd(p, a); }
+	static TARGET_AVX2 inline Vector set(Float v) { return _mm256_set1_pd(v); }
+	static TARGET_AVX2 inline IntVector seti(int32_t v) { return _mm_set1_epi32(v); }
+
+	static TARGET_AVX2 inline Vector add(Vector a, Vector b) { return _mm256_add_pd(a, b); }
+	static TARGET_AVX2 inline Vector sub(Vector a, Vector b) { return _mm256_sub_pd(a, b); }
+	static TARGET_AVX2 inline Vector mul(Vector a, Vector b) { return _mm256_mul_pd(a, b); }
+	static TARGET_AVX2 inline Vector div(Vector a, Vector b) { return _mm256_div_pd(a, b); }
+	static TARGET_AVX2 inline Vector max(Vector a, Vector b) { return _mm256_max_pd(a, b); }
+
+	static TARGET_AVX2 inline Vector bitAnd(Vector a, Vector b) { return _mm256_and_pd(a, b); }
+	static TARGET_AVX2 inline Vector bitOr(Vector a, Vector b) { return _mm256_or_pd(a, b); }
+	static TARGET_AVX2 inline Vector bitXor(Vector a, Vector b) { return _mm256_xor_pd(a, b); }
+	static TARGET_AVX2 inline Vector bitAndNot(Vector a, Vector b) { return _mm256_andnot_pd(a, b); } // (~a & b)
+	static TARGET_AVX2 inline Vector select(Vector mask, Vector a, Vector b) { return _mm256_blendv_pd(b, a, mask); } // (mask ? a : b)
+	static TARGET_AVX2 inline Vector compareGreaterEqual(Vector a, Vector b) { return _mm256_cmp_pd(a, b, _CMP_GE_OQ); }
+	static TARGET_AVX2 inline Vector allBits() { return _mm256_castsi256_pd(_mm256_set1_epi64x(-1)); }
+
+	static TARGET_AVX2 inline IntVector addi(IntVector a, IntVector b) { return _mm_add_epi32(a, b); }
+	static TARGET_AVX2 inline IntVector andi(IntVector a, IntVector b) { return _mm_and_si128(a, b); }
+	static TARGET_AVX2 inline IntVector subi(IntVector a, IntVector b) { return _mm_sub_epi32(a, b); }
+	static TARGET_AVX2 inline IntVector halfi(IntVector a) { return _mm_srai_epi32(a, 1); } // (a / 2) for even a
+
+	// Same result as SimplexNoise<Float>::wrap_period for values at most a period out of [0,period)
+	static TARGET_AVX2 inline IntVector wrapi(IntVector a, IntVector period) {
+		a = _mm_add_epi32(a, _mm_and_si128(_mm_cmpgt_epi32(_mm_setzero_si128(), a), period));
+		return _mm_sub_epi32(a, _mm_andnot_si128(_mm_cmpgt_epi32(period, a), period));
+	}
+
+	// Same result as SimplexNoise<double>::fast_floor, including its rounding of values just below an integer
+	static TARGET_AVX2 inline IntVector floor(Vector a) {
+		Vector offset = _mm256_set1_pd(2147483648.0);
+		return _mm256_cvttpd_epi32(_mm256_sub_pd(_mm256_floor_pd(_mm256_add_pd(a, offset)), offset));
+	}
+	static TARGET_AVX2 inline Vector toFloat(IntVector a) { return _mm256_cvtepi32_pd(a); }
+	static TARGET_AVX2 inline IntVector maskToInt(Vector mask) { return _mm256_cvttpd_epi32(_mm256_and_pd(mask, _mm256_set1_pd(1.0))); }
+
+	// Lanes where (a & bit) != 0
+	static TARGET_AVX2 inline Vector bitMask(IntVector a, int32_t bit) {
+		IntVector b = _mm_set1_epi32(bit);
+		return _mm256_castsi256_pd(_mm256_cvtepi32_epi64(_mm_cmpeq_epi32(_mm_and_si128(a, b), b)));
+	}
+
+	// permutationArray[index] for indices in [0, 511]
+	static TARGET_AVX2 inline IntVector permute(const unsigned char* permutationArray, IntVector index) {
+		IntVector start = _mm_max_epi32(_mm_sub_epi32(index, _mm_set1_epi32(3)), _mm_setzero_si128());
+		IntVector shift = _mm_slli_epi32(_mm_sub_epi32(index, start), 3);
+		IntVector v = _mm_i32gather_epi32(reinterpret_cast<const int*>(permutationArray), start, 1);
+		return _mm_and_si128(_mm_srlv_epi32(v, shift), _mm_set1_epi32(0xFF));
+	}
+
+};
+
+
+
+/**
+	Contribution of a single simplex corner to a 3d noise value.
+	Corners which are out of range are zeroed instead of skipped.
+*/
+template <typename V>
+static TARGET_AVX2 inline typename V::Vector
+noise3Contribution(
+	const unsigned char* permutationArray,
+	typename V::IntVector i,
+	typename V::IntVector j,
+	typename V::IntVector k,
+	typename V::Vector x,
+	typename V::Vector y,
+	typename V::Vector z
+) {
+	typedef typename V::Vector Vector;
+	typedef typename V::IntVector IntVector;
+
+	Vector c = V::sub(V::sub(V::sub(V::set(0.5), V::mul(x, x)), V::mul(y, y)), V::mul(z, z));
+	c = V::max(c, V::set(0.0));
+
+	IntVector hash = V::permute(permutationArray, V::addi(i, V::permute(permutationArray, V::addi(j, V::permute(permutationArray, k)))));
+
+	// SimplexNoiseHelper<Float, 3>::gradientTable[hash & 0xB] has one zero and two (+/-)1 components:
+	//   (hash & 0x8) == 0 : { 0, (hash & 0x2) ? 1 : -1, (hash & 0x1) ? 1 : -1 }
+	//   (hash & 0x8) != 0 : { (hash & 0x2) ? 1 : -1, (hash & 0x1) ? 1 : -1, 0 }
+	Vector signBit = V::set(-0.0);
+	Vector high = V::bitMask(hash, 0x8);
+	Vector u = V::select(high, x, y);
+	Vector v = V::select(high, y, z);
+	u = V::bitXor(u, V::bitAndNot(V::bitMask(hash, 0x2), signBit));
+	v = V::bitXor(v, V::bitAndNot(V::bitMask(hash, 0x1), signBit));
+
+	return V::mul(V::mul(V::mul(c, c), c), V::add(u, v));
+}
+
+/**
+	3d noise; this performs the same operations in the same order as SimplexNoise<Float>::noise3,
+	so the results are identical.
+*/
+template <typename V>
+static TARGET_AVX2 void
+noise3Avx2(
+	const unsigned char* permutationArray,
+	SimplexNoiseSimd::CountInt count,
+	const typename V::Float* xs,
+	const typename V::Float* ys,
+	const typename V::Float* zs,
+	const int32_t* latticeOffset,
+	typename V::Float* out
+) {
+	typedef typename V::Float Float;
+	typedef typename V::Vector Vector;
+	typedef typename V::IntVector IntVector;
+
+	const Vector skewFactor = V::set(SimplexNoiseHelper<Float, 3>::skewFactor());
+	const Vector deskewFactor = V::set(SimplexNoiseHelper<Float, 3>::deskewFactor());
+	const Vector deskew1 = V::set(static_cast<Float>(1) * SimplexNoiseHelper<Float, 3>::deskewFactor());
+	const Vector deskew2 = V::set(static_cast<Float>(2) * SimplexNoiseHelper<Float, 3>::deskewFactor());
+	const Vector deskew3 = V::set(static_cast<Float>(3) * SimplexNoiseHelper<Float, 3>::deskewFactor());
+	const Vector one = V::set(1.0);
+	const Vector maximum = V::set(SimplexNoiseHelper<Float, 3>::unnormalizedMaximum());
+	const IntVector mask = V::seti(0xFF);
+	const IntVector ione = V::seti(1);
+	const IntVector offsetI = V::seti(latticeOffset != nullptr ? latticeOffset[0] : 0);
+	const IntVector offsetJ = V::seti(latticeOffset != nullptr ? latticeOffset[1] : 0);
+	const IntVector offsetK = V::seti(latticeOffset != nullptr ? latticeOffset[2] : 0);
+
+	Vector x, y, z, skew;
+	Vector rx0, ry0, rz0;
+	Vector xy, xz, yz;
+	Vector order1i, order1j, order1k, order2i, order2j, order2k;
+	Vector c0;
+	IntVector si, sj, sk;
+
+	for (SimplexNoiseSimd::CountInt n = 0; n < count; n += V::width) {
+		x = V::load(xs + n);
+		y = V::load(ys + n);
+		z = V::load(zs + n);
+
+		// Skew point and find origin
+		skew = V::mul(V::add(V::add(x, y), z), skewFactor);
+		si = V::floor(V::add(x, skew));
+		sj = V::floor(V::add(y, skew));
+		sk = V::floor(V::add(z, skew));
+
+		// The x,y,z relative distances from the deskewed origin
+		skew = V::mul(V::toFloat(V::addi(V::addi(si, sj), sk)), deskewFactor);
+		rx0 = V::add(V::sub(x, V::toFloat(si)), skew);
+		ry0 = V::add(V::sub(y, V::toFloat(sj)), skew);
+		rz0 = V::add(V::sub(z, V::toFloat(sk)), skew);
+
+		// Offset and truncate the integer indices to [0,255]
+		si = V::andi(V::addi(si, offsetI), mask);
+		sj = V::andi(V::addi(sj, offsetJ), mask);
+		sk = V::andi(V::addi(sk, offsetK), mask);
+
+		// Simplex point order; equivalent to SimplexNoiseHelper<Float, 3>::simplexOrders[key]
+		xy = V::compareGreaterEqual(rx0, ry0);
+		xz = V::compareGreaterEqual(rx0, rz0);
+		yz = V::compareGreaterEqual(ry0, rz0);
+		order1i = V::bitAnd(xy, xz);
+		order1j = V::bitAndNot(xy, yz);
+		order1k = V::bitAndNot(V::bitOr(xz, yz), V::allBits());
+		order2i = V::bitOr(xy, xz);
+		order2j = V::bitAndNot(V::bitAndNot(yz, xy), V::allBits());
+		order2k = V::bitAndNot(V::bitAnd(xz, yz), V::allBits());
+
+		// Contributions
+		c0 = noise3Contribution<V>(permutationArray, si, sj, sk, rx0, ry0, rz0);
+
+		c0 = V::add(c0, noise3Contribution<V>(
+			permutationArray,
+			V::addi(si, V::maskToInt(order1i)),
+			V::addi(sj, V::maskToInt(order1j)),
+			V::addi(sk, V::maskToInt(order1k)),
+			V::add(V::sub(rx0, V::bitAnd(order1i, one)), deskew1),
+			V::add(V::sub(ry0, V::bitAnd(order1j, one)), deskew1),
+			V::add(V::sub(rz0, V::bitAnd(order1k, one)), deskew1)
+		));
+
+		c0 = V::add(c0, noise3Contribution<V>(
+			permutationArray,
+			V::addi(si, V::maskToInt(order2i)),
+			V::addi(sj, V::maskToInt(order2j)),
+			V::addi(sk, V::maskToInt(order2k)),
+			V::add(V::sub(rx0, V::bitAnd(order2i, one)), deskew2),
+			V::add(V::sub(ry0, V::bitAnd(order2j, one)), deskew2),
+			V::add(V::sub(rz0, V::bitAnd(order2k, one)), deskew2)
+		));
+
+		c0 = V::add(c0, noise3Contribution<V>(
+			permutationArray,
+			V::addi(si, ione),
+			V::addi(sj, ione),
+			V::addi(sk, ione),
+			V::add(V::sub(rx0, one), deskew3),
+			V::add(V::sub(ry0, one), deskew3),
+			V::add(V::sub(rz0, one), deskew3)
+		));
+
+		// Done
+		V::store(out + n, V::div(c0, maximum));
+	}
+}
+
+
+
+/**
+	Writes Components vectors of width values to a gradient output buffer;
+	component c of value l goes to out[l * stride + c * componentStride].
+*/
+template <typename Float, int Width, int Components>
+static inline void
+storeGradient(
+	const Float (*values)[Width],
+	Float* out,
+	SimplexNoiseSimd::CountInt stride,
+	SimplexNoiseSimd::CountInt componentStride
+) {
+	for (int l = 0; l < Width; ++l) {
+		for (int c = 0; c < Components; ++c) {
+			out[l * stride + c * componentStride] = values[c][l];
+		}
+	}
+}
+
+/**
+	Contribution of a single simplex corner to a 3d noise value and its derivative.
+	The derivative is accumulated in two parts, the same way as SimplexNoise<Float>::noise3(x, y, z, dx, dy, dz):
+		derivative = -6 * sum(position * dot * c^2) + sum(c^3 * gradient)
+*/
+template <typename V>
+static TARGET_AVX2 inline void
+noise3GradientContribution(
+	const unsigned char* permutationArray,
+	typename V::IntVector i,
+	typename V::IntVector j,
+	typename V::IntVector k,
+	typename V::Vector x,
+	typename V::Vector y,
+	typename V::Vector z,
+	typename V::Vector& value,
+	typename V::Vector* derivative,
+	typename V::Vector* derivative2
+) {
+	typedef typename V::Vector Vector;
+	typedef typename V::IntVector IntVector;
+
+	Vector c = V::sub(V::sub(V::sub(V::set(0.5), V::mul(x, x)), V::mul(y, y)), V::mul(z, z));
+	c = V::max(c, V::set(0.0));
+
+	IntVector hash = V::permute(permutationArray, V::addi(i, V::permute(permutationArray, V::addi(j, V::permute(permutationArray, k)))));
+
+	// Same gradient decoding as noise3Contribution
+	Vector signBit = V::set(-0.0);
+	Vector one = V::set(1.0);
+	Vector high = V::bitMask(hash, 0x8);
+	Vector sign2 = V::bitXor(one, V::bitAndNot(V::bitMask(hash, 0x2), signBit));
+	Vector sign1 = V::bitXor(one, V::bitAndNot(V::bitMask(hash, 0x1), signBit));
+	Vector gx = V::bitAnd(high, sign2);
+	Vector gy = V::select(high, sign1, sign2);
+	Vector gz = V::bitAndNot(high, sign1);
+	Vector u = V::bitXor(V::select(high, x, y), V::bitAndNot(V::bitMask(hash, 0x2), signBit));
+	Vector v = V::bitXor(V::select(high, y, z), V::bitAndNot(V::bitMask(hash, 0x1), signBit));
+	Vector dot = V::add(u, v);
+
+	Vector c2 = V::mul(c, c);
+	c = V::mul(c, c2);
+
+	derivative[0] = V::add(derivative[0], V::mul(V::mul(x, dot), c2));
+	derivative[1] = V::add(derivative[1], V::mul(V::mul(y, dot), c2));
+	derivative[2] = V::add(derivative[2], V::mul(V::mul(z, dot), c2));
+	derivative2[0] = V::add(derivative2[0], V::mul(c, gx));
+	derivative2[1] = V::add(derivative2[1], V::mul(c, gy));
+	derivative2[2] = V::add(derivative2[2], V::mul(c, gz));
+	value = V::add(value, V::mul(c, dot));
+}
+
+/**
+	3d noise and its derivative; this performs the same operations in the same order as
+	SimplexNoise<Float>::noise3(x, y, z, dx, dy, dz), so the results are identical.
+*/
+template <typename V>
+static TARGET_AVX2 void
+noise3GradientAvx2(
+	const unsigned char* permutationArray,
+	SimplexNoiseSimd::CountInt count,
+	const typename V::Float* xs,
+	const typename V::Float* ys,
+	const typename V::Float* zs,
+	typename V::Float* out,
+	SimplexNoiseSimd::CountInt stride,
+	SimplexNoiseSimd::CountInt componentStride
+) {
+	typedef typename V::Float Float;
+	typedef typename V::Vector Vector;
+	typedef typename V::IntVector IntVector;
+
+	const Vector skewFactor = V::set(SimplexNoiseHelper<Float, 3>::skewFactor());
+	const Vector deskewFactor = V::set(SimplexNoiseHelper<Float, 3>::deskewFactor());
+	const Vector deskew1 = V::set(static_cast<Float>(1) * SimplexNoiseHelper<Float, 3>::deskewFactor());
+	const Vector deskew2 = V::set(static_cast<Float>(2) * SimplexNoiseHelper<Float, 3>::deskewFactor());
+	const Vector deskew3 = V::set(static_cast<Float>(3) * SimplexNoiseHelper<Float, 3>::deskewFactor());
+	const Vector zero = V::set(0.0);
+	const Vector one = V::set(1.0);
+	const Vector derivativeFactor = V::set(-6.0);
+	const Vector maximum = V::set(SimplexNoiseHelper<Float, 3>::unnormalizedMaximum());
+	const IntVector mask = V::seti(0xFF);
+	const IntVector ione = V::seti(1);
+
+	Vector x, y, z, skew;
+	Vector rx0, ry0, rz0;
+	Vector xy, xz, yz;
+	Vector order1i, order1j, order1k, order2i, order2j, order2k;
+	Vector c0;
+	Vector derivative[3];
+	Vector derivative2[3];
+	IntVector si, sj, sk;
+	Float results[4][V::width];
+	int a;
+
+	for (SimplexNoiseSimd::CountInt n = 0; n < count; n += V::width) {
+		x = V::load(xs + n);
+		y = V::load(ys + n);
+		z = V::load(zs + n);
+
+		// Skew point and find origin
+		skew = V::mul(V::add(V::add(x, y), z), skewFactor);
+		si = V::floor(V::add(x, skew));
+		sj = V::floor(V::add(y, skew));
+		sk = V::floor(V::add(z, skew));
+
+		// The x,y,z relative distances from the deskewed origin
+		skew = V::mul(V::toFloat(V::addi(V::addi(si, sj), sk)), deskewFactor);
+		rx0 = V::add(V::sub(x, V::toFloat(si)), skew);
+		ry0 = V::add(V::sub(y, V::toFloat(sj)), skew);
+		rz0 = V::add(V::sub(z, V::toFloat(sk)), skew);
+
+		// Truncate the integer indices to [0,255]
+		si = V::andi(si, mask);
+		sj = V::andi(sj, mask);
+		sk = V::andi(sk, mask);
+
+		// Simplex point order; equivalent to SimplexNoiseHelper<Float, 3>::simplexOrders[key]
+		xy = V::compareGreaterEqual(rx0, ry0);
+		xz = V::compareGreaterEqual(rx0, rz0);
+		yz = V::compareGreaterEqual(ry0, rz0);
+		order1i = V::bitAnd(xy, xz);
+		order1j = V::bitAndNot(xy, yz);
+		order1k = V::bitAndNot(V::bitOr(xz, yz), V::allBits());
+		order2i = V::bitOr(xy, xz);
+		order2j = V::bitAndNot(V::bitAndNot(yz, xy), V::allBits());
+		order2k = V::bitAndNot(V::bitAnd(xz, yz), V::allBits());
+
+		// Contributions
+		c0 = zero;
+		for (a = 0; a < 3; ++a) {
+			derivative[a] = zero;
+			derivative2[a] = zero;
+		}
+
+		noise3GradientContribution<V>(permutationArray, si, sj, sk, rx0, ry0, rz0, c0, derivative, derivative2);
+
+		noise3GradientContribution<V>(
+			permutationArray,
+			V::addi(si, V::maskToInt(order1i)),
+			V::addi(sj, V::maskToInt(order1j)),
+			V::addi(sk, V::maskToInt(order1k)),
+			V::add(V::sub(rx0, V::bitAnd(order1i, one)), deskew1),
+			V::add(V::sub(ry0, V::bitAnd(order1j, one)), deskew1),
+			V::add(V::sub(rz0, V::bitAnd(order1k, one)), deskew1),
+			c0,
+			derivative,
+			derivative2
+		);
+
+		noise3GradientContribution<V>(
+			permutationArray,
+			V::addi(si, V::maskToInt(order2i)),
+			V::addi(sj, V::maskToInt(order2j)),
+			V::addi(sk, V::maskToInt(order2k)),
+			V::add(V::sub(rx0, V::bitAnd(order2i, one)), deskew2),
+			V::add(V::sub(ry0, V::bitAnd(order2j, one)), deskew2),
+			V::add(V::sub(rz0, V::bitAnd(order2k, one)), deskew2),
+			c0,
+			derivative,
+			derivative2
+		);
+
+		noise3GradientContribution<V>(
+			permutationArray,
+			V::addi(si, ione),
+			V::addi(sj, ione),
+			V::addi(sk, ione),
+			V::add(V::sub(rx0, one), deskew3),
+			V::add(V::sub(ry0, one), deskew3),
+			V::add(V::sub(rz0, one), deskew3),
+			c0,
+			derivative,
+			derivative2
+		);
+
+		// Complete derivative
+		for (a = 0; a < 3; ++a) {
+			derivative[a] = V::div(V::add(V::mul(derivative[a], derivativeFactor), derivative2[a]), maximum);
+		}
+		c0 = V::div(c0, maximum);
+
+		// Done
+		if (stride == 1) {
+			V::store(out + n, c0);
+			for (a = 0; a < 3; ++a) V::store(out + n + componentStride * (a + 1), derivative[a]);
+		}
+		else {
+			V::store(results[0], c0);
+			for (a = 0; a < 3; ++a) V::store(results[a + 1], derivative[a]);
+			storeGradient<Float, V::width, 4>(results, out + n * stride, stride, componentStride);
+		}
+	}
+}
+
+
+
+/**
+	Contribution of a single simplex corner to the derivatives of the three curl potential components.
+	The bases are the per-component lattice origins, and (i, j, k) is the corner's offset from them.
+*/
+template <typename V>
+static TARGET_AVX2 inline void
+curl3Contribution(
+	const unsigned char* permutationArray,
+	const typename V::IntVector (*bases)[3],
+	typename V::IntVector i,
+	typename V::IntVector j,
+	typename V::IntVector k,
+	typename V::Vector x,
+	typename V::Vector y,
+	typename V::Vector z,
+	typename V::Vector* positive,
+	typename V::Vector* positive2,
+	typename V::Vector* negative,
+	typename V::Vector* negative2
+) {
+	typedef typename V::Vector Vector;
+	typedef typename V::IntVector IntVector;
+
+	Vector c = V::sub(V::sub(V::sub(V::set(0.5), V::mul(x, x)), V::mul(y, y)), V::mul(z, z));
+	c = V::max(c, V::set(0.0));
+	Vector c2 = V::mul(c, c);
+	c = V::mul(c, c2);
+
+	const Vector position[3] = { x, y, z };
+	Vector signBit = V::set(-0.0);
+	Vector one = V::set(1.0);
+	Vector gradient[3][3];
+	Vector dot[3];
+	Vector high, bit2, bit1;
+	IntVector hash;
+	int a, b, n0, n1;
+
+	// Same gradient decoding as noise3Contribution, for each potential component
+	for (b = 0; b < 3; ++b) {
+		hash = V::permute(permutationArray, V::addi(V::addi(bases[b][0], i), V::permute(permutationArray, V::addi(V::addi(bases[b][1], j), V::permute(permutationArray, V::addi(bases[b][2], k))))));
+		high = V::bitMask(hash, 0x8);
+		bit2 = V::bitAndNot(V::bitMask(hash, 0x2), signBit);
+		bit1 = V::bitAndNot(V::bitMask(hash, 0x1), signBit);
+		gradient[b][0] = V::bitAnd(high, V::bitXor(one, bit2));
+		gradient[b][1] = V::select(high, V::bitXor(one, bit1), V::bitXor(one, bit2));
+		gradient[b][2] = V::bitAndNot(high, V::bitXor(one, bit1));
+		dot[b] = V::add(V::bitXor(V::select(high, x, y), bit2), V::bitXor(V::select(high, y, z), bit1));
+	}
+
+	for (a = 0; a < 3; ++a) {
+		n0 = (a + 1) % 3;
+		n1 = (a + 2) % 3;
+		positive[a] = V::add(positive[a], V::mul(V::mul(position[n0], dot[n1]), c2));
+		positive2[a] = V::add(positive2[a], V::mul(c, gradient[n1][n0]));
+		negative[a] = V::add(negative[a], V::mul(V::mul(position[n1], dot[n0]), c2));
+		negative2[a] = V::add(negative2[a], V::mul(c, gradient[n0][n1]));
+	}
+}
+
+/**
+	3d curl noise; this performs the same operations in the same order as SimplexNoise<Float>::curl3_batch,
+	so the results are identical.
+*/
+template <typename V>
+static TARGET_AVX2 void
+curl3Avx2(
+	const unsigned char* permutationArray,
+	SimplexNoiseSimd::CountInt count,
+	const typename V::Float* xs,
+	const typename V::Float* ys,
+	const typename V::Float* zs,
+	typename V::Float* out,
+	SimplexNoiseSimd::CountInt stride,
+	SimplexNoiseSimd::CountInt componentStride
+) {
+	typedef typename V::Float Float;
+	typedef typename V::Vector Vector;
+	typedef typename V::IntVector IntVector;
+
+	const Vector skewFactor = V::set(SimplexNoiseHelper<Float, 3>::skewFactor());
+	const Vector deskewFactor = V::set(SimplexNoiseHelper<Float, 3>::deskewFactor());
+	const Vector deskew1 = V::set(static_cast<Float>(1) * SimplexNoiseHelper<Float, 3>::deskewFactor());
+	const Vector deskew2 = V::set(static_cast<Float>(2) * SimplexNoiseHelper<Float, 3>::deskewFactor());
+	const Vector deskew3 = V::set(static_cast<Float>(3) * SimplexNoiseHelper<Float, 3>::deskewFactor());
+	const Vector zero = V::set(0.0);
+	const Vector one = V::set(1.0);
+	const Vector derivativeFactor = V::set(-6.0);
+	const Vector maximum = V::set(SimplexNoiseHelper<Float, 3>::unnormalizedMaximum());
+	const IntVector mask = V::seti(0xFF);
+	const IntVector izero = V::seti(0);
+	const IntVector ione = V::seti(1);
+
+	Vector x, y, z, skew;
+	Vector rx0, ry0, rz0;
+	Vector xy, xz, yz;
+	Vector order1i, order1j, order1k, order2i, order2j, order2k;
+	Vector positive[3];
+	Vector positive2[3];
+	Vector negative[3];
+	Vector negative2[3];
+	IntVector si, sj, sk;
+	IntVector bases[3][3];
+	Float results[3][V::width];
+	int a, b;
+
+	for (SimplexNoiseSimd::CountInt n = 0; n < count; n += V::width) {
+		x = V::load(xs + n);
+		y = V::load(ys + n);
+		z = V::load(zs + n);
+
+		// Skew point and find origin
+		skew = V::mul(V::add(V::add(x, y), z), skewFactor);
+		si = V::floor(V::add(x, skew));
+		sj = V::floor(V::add(y, skew));
+		sk = V::floor(V::add(z, skew));
+
+		// The x,y,z relative distances from the deskewed origin
+		skew = V::mul(V::toFloat(V::addi(V::addi(si, sj), sk)), deskewFactor);
+		rx0 = V::add(V::sub(x, V::toFloat(si)), skew);
+		ry0 = V::add(V::sub(y, V::toFloat(sj)), skew);
+		rz0 = V::add(V::sub(z, V::toFloat(sk)), skew);
+
+		// Truncate the integer indices to [0,255], and offset them for each potential component
+		si = V::andi(si, mask);
+		sj = V::andi(sj, mask);
+		sk = V::andi(sk, mask);
+		for (b = 0; b < 3; ++b) {
+			bases[b][0] = V::andi(V::addi(si, V::seti(SimplexNoiseHelper<Float, 3>::curlOffsets[b][0])), mask);
+			bases[b][1] = V::andi(V::addi(sj, V::seti(SimplexNoiseHelper<Float, 3>::curlOffsets[b][1])), mask);
+			bases[b][2] = V::andi(V::addi(sk, V::seti(SimplexNoiseHelper<Float, 3>::curlOffsets[b][2])), mask);
+		}
+
+		// Simplex point order; equivalent to SimplexNoiseHelper<Float, 3>::simplexOrders[key]
+		xy = V::compareGreaterEqual(rx0, ry0);
+		xz = V::compareGreaterEqual(rx0, rz0);
+		yz = V::compareGreaterEqual(ry0, rz0);
+		order1i = V::bitAnd(xy, xz);
+		order1j = V::bitAndNot(xy, yz);
+		order1k = V::bitAndNot(V::bitOr(xz, yz), V::allBits());
+		order2i = V::bitOr(xy, xz);
+		order2j = V::bitAndNot(V::bitAndNot(yz, xy), V::allBits());
+		order2k = V::bitAndNot(V::bitAnd(xz, yz), V::allBits());
+
+		// Contributions
+		for (a = 0; a < 3; ++a) {
+			positive[a] = zero;
+			positive2[a] = zero;
+			negative[a] = zero;
+			negative2[a] = zero;
+		}
+
+		curl3Contribution<V>(permutationArray, bases, izero, izero, izero, rx0, ry0, rz0, positive, positive2, negative, negative2);
+
+		curl3Contribution<V>(
+			permutationArray,
+			bases,
+			V::maskToInt(order1i),
+			V::maskToInt(order1j),
+			V::maskToInt(order1k),
+			V::add(V::sub(rx0, V::bitAnd(order1i, one)), deskew1),
+			V::add(V::sub(ry0, V::bitAnd(order1j, one)), deskew1),
+			V::add(V::sub(rz0, V::bitAnd(order1k, one)), deskew1),
+			positive,
+			positive2,
+			negative,
+			negative2
+		);
+
+		curl3Contribution<V>(
+			permutationArray,
+			bases,
+			V::maskToInt(order2i),
+			V::maskToInt(order2j),
+			V::maskToInt(order2k),
+			V::add(V::sub(rx0, V::bitAnd(order2i, one)), deskew2),
+			V::add(V::sub(ry0, V::bitAnd(order2j, one)), deskew2),
+			V::add(V::sub(rz0, V::bitAnd(order2k, one)), deskew2),
+			positive,
+			positive2,
+			negative,
+			negative2
+		);
+
+		curl3Contribution<V>(
+			permutationArray,
+			bases,
+			ione,
+			ione,
+			ione,
+			V::add(V::sub(rx0, one), deskew3),
+			V::add(V::sub(ry0, one), deskew3),
+			V::add(V::sub(rz0, one), deskew3),
+			positive,
+			positive2,
+			negative,
+			negative2
+		);
+
+		// Complete derivatives
+		for (a = 0; a < 3; ++a) {
+			positive[a] = V::div(V::sub(V::add(V::mul(positive[a], derivativeFactor), positive2[a]), V::add(V::mul(negative[a], derivativeFactor), negative2[a])), maximum);
+		}
+
+		// Done
+		if (stride == 1) {
+			for (a = 0; a < 3; ++a) V::store(out + n + componentStride * a, positive[a]);
+		}
+		else {
+			for (a = 0; a < 3; ++a) V::store(results[a], positive[a]);
+			storeGradient<Float, V::width, 3>(results, out + n * stride, stride, componentStride);
+		}
+	}
+}
+
+
+
+/**
+	Periodic 3d noise; this performs the same operations in the same order as SimplexNoise<Float>::noise3_periodic,
+	so the results are identical. The corners are hashed with noise3Contribution, using the lattice coordinates
+	recovered from the wrapped doubled vertex coordinates.
+*/
+template <typename V>
+static TARGET_AVX2 void
+noise3PeriodicAvx2(
+	const unsigned char* permutationArray,
+	SimplexNoiseSimd::CountInt count,
+	const typename V::Float* xs,
+	const typename V::Float* ys,
+	const typename V::Float* zs,
+	int32_t periodX,
+	int32_t periodY,
+	int32_t periodZ,
+	typename V::Float* out
+) {
+	typedef typename V::Float Float;
+	typedef typename V::Vector Vector;
+	typedef typename V::IntVector IntVector;
+
+	const Vector half = V::set(0.5);
+	const Vector maximum = V::set(SimplexNoiseHelper<Float, 3>::periodicUnnormalizedMaximum());
+	const Vector positionPeriodX = V::set(static_cast<Float>(periodX));
+	const Vector positionPeriodY = V::set(static_cast<Float>(periodY));
+	const Vector positionPeriodZ = V::set(static_cast<Float>(periodZ));
+	const IntVector vertexPeriodX = V::seti(2 * periodX);
+	const IntVector vertexPeriodY = V::seti(2 * periodY);
+	const IntVector vertexPeriodZ = V::seti(2 * periodZ);
+	const IntVector mask = V::seti(0xFF);
+	const IntVector ione = V::seti(1);
+
+	Vector x, y, z, su, sv, sw;
+	Vector fu, fv, fw;
+	Vector rx0, ry0, rz0;
+	Vector uv, uw, vw;
+	Vector c0;
+	IntVector si, sj, sk, vx, vy, vz;
+	IntVector order1i, order1j, order1k, order2i, order2j, order2k;
+	IntVector ox, oy, oz, cx, cy, cz;
+
+	for (SimplexNoiseSimd::CountInt n = 0; n < count; n += V::width) {
+		x = V::load(xs + n);
+		y = V::load(ys + n);
+		z = V::load(zs + n);
+
+		// Move point into the first period
+		if (periodX != 0) x = V::sub(x, V::mul(V::toFloat(V::floor(V::div(x, positionPeriodX))), positionPeriodX));
+		if (periodY != 0) y = V::sub(y, V::mul(V::toFloat(V::floor(V::div(y, positionPeriodY))), positionPeriodY));
+		if (periodZ != 0) z = V::sub(z, V::mul(V::toFloat(V::floor(V::div(z, positionPeriodZ))), positionPeriodZ));
+
+		// Transform point into lattice space and find origin
+		su = V::add(y, z);
+		sv = V::add(x, z);
+		sw = V::add(x, y);
+		si = V::floor(su);
+		sj = V::floor(sv);
+		sk = V::floor(sw);
+		fu = V::sub(su, V::toFloat(si));
+		fv = V::sub(sv, V::toFloat(sj));
+		fw = V::sub(sw, V::toFloat(sk));
+
+		// The x,y,z relative distances from the origin vertex
+		rx0 = V::mul(V::sub(V::add(fv, fw), fu), half);
+		ry0 = V::mul(V::sub(V::add(fu, fw), fv), half);
+		rz0 = V::mul(V::sub(V::add(fu, fv), fw), half);
+
+		// The doubled coordinates of the origin vertex, wrapped to the periods
+		vx = V::subi(V::addi(sj, sk), si);
+		vy = V::subi(V::addi(si, sk), sj);
+		vz = V::subi(V::addi(si, sj), sk);
+		if (periodX != 0) vx = V::wrapi(vx, vertexPeriodX);
+		if (periodY != 0) vy = V::wrapi(vy, vertexPeriodY);
+		if (periodZ != 0) vz = V::wrapi(vz, vertexPeriodZ);
+
+		// Simplex point order; equivalent to SimplexNoiseHelper<Float, 3>::simplexOrders[key]
+		uv = V::compareGreaterEqual(fu, fv);
+		uw = V::compareGreaterEqual(fu, fw);
+		vw = V::compareGreaterEqual(fv, fw);
+		order1i = V::maskToInt(V::bitAnd(uv, uw));
+		order1j = V::maskToInt(V::bitAndNot(uv, vw));
+		order1k = V::maskToInt(V::bitAndNot(V::bitOr(uw, vw), V::allBits()));
+		order2i = V::maskToInt(V::bitOr(uv, uw));
+		order2j = V::maskToInt(V::bitAndNot(V::bitAndNot(vw, uv), V::allBits()));
+		order2k = V::maskToInt(V::bitAndNot(V::bitAnd(uw, vw), V::allBits()));
+
+		// Contributions; lattice vertex (i, j, k) has the doubled coordinates (-i + j + k, i - j + k, i + j - k)
+		c0 = noise3Contribution<V>(
+			permutationArray,
+			V::andi(V::halfi(V::addi(vy, vz)), mask),
+			V::andi(V::halfi(V::addi(vx, vz)), mask),
+			V::andi(V::halfi(V::addi(vx, vy)), mask),
+			rx0,
+			ry0,
+			rz0
+		);
+
+		ox = V::subi(V::addi(order1j, order1k), order1i);
+		oy = V::subi(V::addi(order1i, order1k), order1j);
+		oz = V::subi(V::addi(order1i, order1j), order1k);
+		cx = V::addi(vx, ox);
+		cy = V::addi(vy, oy);
+		cz = V::addi(vz, oz);
+		if (periodX != 0) cx = V::wrapi(cx, vertexPeriodX);
+		if (periodY != 0) cy = V::wrapi(cy, vertexPeriodY);
+		if (periodZ != 0) cz = V::wrapi(cz, vertexPeriodZ);
+		c0 = V::add(c0, noise3Contribution<V>(
+			permutationArray,
+			V::andi(V::halfi(V::addi(cy, cz)), mask),
+			V::andi(V::halfi(V::addi(cx, cz)), mask),
+			V::andi(V::halfi(V::addi(cx, cy)), mask),
+			V::sub(rx0, V::mul(V::toFloat(ox), half)),
+			V::sub(ry0, V::mul(V::toFloat(oy), half)),
+			V::sub(rz0, V::mul(V::toFloat(oz), half))
+		));
+
+		ox = V::subi(V::addi(order2j, order2k), order2i);
+		oy = V::subi(V::addi(order2i, order2k), order2j);
+		oz = V::subi(V::addi(order2i, order2j), order2k);
+		cx = V::addi(vx, ox);
+		cy = V::addi(vy, oy);
+		cz = V::addi(vz, oz);
+		if (periodX != 0) cx = V::wrapi(cx, vertexPeriodX);
+		if (periodY != 0) cy = V::wrapi(cy, vertexPeriodY);
+		if (periodZ != 0) cz = V::wrapi(cz, vertexPeriodZ);
+		c0 = V::add(c0, noise3Contribution<V>(
+			permutationArray,
+			V::andi(V::halfi(V::addi(cy, cz)), mask),
+			V::andi(V::halfi(V::addi(cx, cz)), mask),
+			V::andi(V::halfi(V::addi(cx, cy)), mask),
+			V::sub(rx0, V::mul(V::toFloat(ox), half)),
+			V::sub(ry0, V::mul(V::toFloat(oy), half)),
+			V::sub(rz0, V::mul(V::toFloat(oz), half))
+		));
+
+		cx = V::addi(vx, ione);
+		cy = V::addi(vy, ione);
+		cz = V::addi(vz, ione);
+		if (periodX != 0) cx = V::wrapi(cx, vertexPeriodX);
+		if (periodY != 0) cy = V::wrapi(cy, vertexPeriodY);
+		if (periodZ != 0) cz = V::wrapi(cz, vertexPeriodZ);
+		c0 = V::add(c0, noise3Contribution<V>(
+			permutationArray,
+			V::andi(V::halfi(V::addi(cy, cz)), mask),
+			V::andi(V::halfi(V::addi(cx, cz)), mask),
+			V::andi(V::halfi(V::addi(cx, cy)), mask),
+			V::sub(rx0, half),
+			V::sub(ry0, half),
+			V::sub(rz0, half)
+		));
+
+		// Done
+		V::store(out + n, V::div(c0, maximum));
+	}
+}
+
+
+
+/**
+	A gradient table stored by component, padded with zeros so that it fills whole vector registers.
+*/
+template <typename Float, int Dimensions, int Size>
+class SimplexNoiseGradientTable final {
+public:
+	static constexpr int capacity = (Size < 16) ? 16 : Size;
+
+	Float values[Dimensions][capacity];
+
+	SimplexNoiseGradientTable(
+		const signed char (*table)[Dimensions]
+	) {
+		for (int i = 0; i < Dimensions; ++i) {
+			for (int j = 0; j < capacity; ++j) {
+				this->values[i][j] = (j < Size) ? table[j][i] : 0;
+			}
+		}
+	}
+
+};
+
+
+
+/**
+	Vector operations for the AVX-512 kernels.
+	Comparisons produce mask registers, which are used directly for blending and masked arithmetic;
+	the float version processes 16 values at a time and the double version processes 8.
+*/
+class SimplexNoiseAvx512Float final {
+public:
+	typedef float Float;
+	typedef __m512 Vector;
+	typedef __m512i IntVector;
+	typedef __mmask16 Mask;
+
+	static constexpr int width = 16;
+
+	static TARGET_AVX512F inline Vector load(const Float* p) { return _mm512_loadu_ps(p); }
+	static TARGET_AVX512F inline void store(Float* p, Vector a) { _mm512_storeu_ps(p, a); }
+	static TARGET_AVX512F inline Vector set(Float v) { return _mm512_set1_ps(v); }
+	static TARGET_AVX512F inline IntVector seti(int32_t v) { return _mm512_set1_epi32(v); }
+
+	static TARGET_AVX512F inline Vector add(Vector a, Vector b) { return _mm512_add_ps(a, b); }
+	static TARGET_AVX512F inline Vector sub(Vector a, Vector b) { return _mm512_sub_ps(a, b); }
+	static TARGET_AVX512F inline Vector mul(Vector a, Vector b) { return _mm512_mul_ps(a, b); }
+	static TARGET_AVX512F inline Vector div(Vector a, Vector b) { return _mm512_div_ps(a, b); }
+	static TARGET_AVX512F inline Vector max(Vector a, Vector b) { return _mm512_max_ps(a, b); }
+	static TARGET_AVX512F inline Vector subMasked(Vector a, Mask m, Vector b) { return _mm512_mask_sub_ps(a, m, a, b); } // (m ? a - b : a)
+	static TARGET_AVX512F inline Vector addMasked(Vector a, Mask m, Vector b) { return _mm512_mask_add_ps(a, m, a, b); } // (m ? a + b : a)
+
+	static TARGET_AVX512F inline Mask compareGreaterEqual(Vector a, Vector b) { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+	static TARGET_AVX512F inline Mask compareGreater(Vector a, Vector b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+	static TARGET_AVX512F inline Mask maskNot(Mask m) { return static_cast<Mask>(~m); }
+
+	static TARGET_AVX512F inline IntVector addi(IntVector a, IntVector b) { return _mm512_add_epi32(a, b); }
+	static TARGET_AVX512F inline IntVector andi(IntVector a, IntVector b) { return _mm512_and_si512(a, b); }
+	static TARGET_AVX512F inline IntVector addiMasked(IntVector a, Mask m, IntVector b) { return _mm512_mask_add_epi32(a, m, a, b); } // (m ? a + b : a)
+	static TARGET_AVX512F inline Mask compareLessEquali(IntVector a, IntVector b) { return _mm512_cmple_epi32_mask(a, b); }
+	static TARGET_AVX512F inline IntVector subi(IntVector a, IntVector b) { return _mm512_sub_epi32(a, b); }
+	static TARGET_AVX512F inline IntVector halfi(IntVector a) { return _mm512_srai_epi32(a, 1); } // (a / 2) for even a
+
+	// Same result as SimplexNoise<Float>::wrap_period for values at most a period out of [0,period)
+	static TARGET_AVX512F inline IntVector wrapi(IntVector a, IntVector period) {
+		a = _mm512_mask_add_epi32(a, _mm512_cmplt_epi32_mask(a, _mm512_setzero_si512()), a, period);
+		return _mm512_mask_sub_epi32(a, _mm512_cmpge_epi32_mask(a, period), a, period);
+	}
+
+	// Same result as SimplexNoise<float>::fast_floor
+	static TARGET_AVX512F inline IntVector floor(Vector a) { return _mm512_cvttps_epi32(_mm512_roundscale_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC)); }
+	static TARGET_AVX512F inline Vector toFloat(IntVector a) { return _mm512_cvtepi32_ps(a); }
+
+	// permutationArray[index] for indices in [0, 511]
+	static TARGET_AVX512F inline IntVector permute(const unsigned char* permutationArray, IntVector index) {
+		IntVector start = _mm512_max_epi32(_mm512_sub_epi32(index, _mm512_set1_epi32(3)), _mm512_setzero_si512());
+		IntVector shift = _mm512_slli_epi32(_mm512_sub_epi32(index, start), 3);
+		IntVector v = _mm512_i32gather_epi32(start, reinterpret_cast<const int*>(permutationArray), 1);
+		return _mm512_and_si512(_mm512_srlv_epi32(v, shift), _mm512_set1_epi32(0xFF));
+	}
+
+	// table[index] for tables loaded from a SimplexNoiseGradientTable
+	static TARGET_AVX512F inline Vector lookup8(const Vector* table, IntVector index) { return _mm512_permutexvar_ps(index, table[0]); }
+	static TARGET_AVX512F inline Vector lookup32(const Vector* table, IntVector index) { return _mm512_permutex2var_ps(table[0], index, table[1]); }
+
+};
+
+class SimplexNoiseAvx512Double final {
+public:
+	typedef double Float;
+	typedef __m512d Vector;
+	typedef __m256i IntVector;
+	typedef __mmask8 Mask;
+
+	static constexpr int width = 8;
+
+	static TARGET_AVX512F inline Vector load(const Float* p) { return _mm512_loadu_pd(p); }
+	static TARGET_AVX512F inline void store(Float* p, Vector a) { _mm512_storeu_pd(p, a); }
+	static TARGET_AVX512F inline Vector set(Float v) { return _mm512_set1_pd(v); }
+	static TARGET_AVX512F inline IntVector seti(int32_t v) { return _mm256_set1_epi32(v); }
+
+	static TARGET_AVX512F inline Vector add(Vector a, Vector b) { return _mm512_add_pd(a, b); }
+	static TARGET_AVX512F inline Vector sub(Vector a, Vector b) { return _mm512_sub_pd(a, b); }
+	static TARGET_AVX512F inline Vector mul(Vector a, Vector b) { return _mm512_mul_pd(a, b); }
+	static TARGET_AVX512F inline Vector div(Vector a, Vector b) { return _mm512_div_pd(a, b); }
+	static TARGET_AVX512F inline Vector max(Vector a, Vector b) { return _mm512_max_pd(a, b); }
+	static TARGET_AVX512F inline Vector subMasked(Vector a, Mask m, Vector b) { return _mm512_mask_sub_pd(a, m, a, b); } // (m ? a - b : a)
+	static TARGET_AVX512F inline Vector addMasked(Vector a, Mask m, Vector b) { return _mm512_mask_add_pd(a, m, a, b); } // (m ? a + b : a)
+
+	static TARGET_AVX512F inline Mask compareGreaterEqual(Vector a, Vector b) { return _mm512_cmp_pd_mask(a, b, _CMP_GE_OQ); }
+	static TARGET_AVX512F inline Mask compareGreater(Vector a, Vector b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+	static TARGET_AVX512F inline Mask maskNot(Mask m) { return static_cast<Mask>(~m); }
+
+	// The 8 indices fit in a 256-bit register; masked operations on it would need AVX-512VL, so masks are widened instead
+	static TARGET_AVX512F inline IntVector addi(IntVector a, IntVector b) { return _mm256_add_epi32(a, b); }
+	static TARGET_AVX512F inline IntVector andi(IntVector a, IntVector b) { return _mm256_and_si256(a, b); }
+	static TARGET_AVX512F inline IntVector addiMasked(IntVector a, Mask m, IntVector b) { return _mm256_add_epi32(a, _mm256_and_si256(_mm512_cvtepi64_epi32(_mm512_maskz_set1_epi64(m, -1)), b)); } // (m ? a + b : a)
+	static TARGET_AVX512F inline Mask compareLessEquali(IntVector a, IntVector b) { return _mm512_cmple_epi64_mask(_mm512_cvtepi32_epi64(a), _mm512_cvtepi32_epi64(b)); }
+	static TARGET_AVX512F inline IntVector subi(IntVector a, IntVector b) { return _mm256_sub_epi32(a, b); }
+	static TARGET_AVX512F inline IntVector halfi(IntVector a) { return _mm256_srai_epi32(a, 1); } // (a / 2) for even a
+
+	// Same result as SimplexNoise<Float>::wrap_period for values at most a period out of [0,period)
+	static TARGET_AVX512F inline IntVector wrapi(IntVector a, IntVector period) {
+		a = _mm256_add_epi32(a, _mm256_and_si256(_mm256_cmpgt_epi32(_mm256_setzero_si256(), a), period));
+		return _mm256_sub_epi32(a, _mm256_andnot_si256(_mm256_cmpgt_epi32(period, a), period));
+	}
+
+	// Same result as SimplexNoise<double>::fast_floor, including its rounding of values just below an integer
+	static TARGET_AVX512F inline IntVector floor(Vector a) {
+		Vector offset = _mm512_set1_pd(2147483648.0);
+		return _mm512_cvttpd_epi32(_mm512_sub_pd(_mm512_roundscale_pd(_mm512_add_pd(a, offset), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC), offset));
+	}
+	static TARGET_AVX512F inline Vector toFloat(IntVector a) { return _mm512_cvtepi32_pd(a); }
+
+	// permutationArray[index] for indices in [0, 511]
+	static TARGET_AVX512F inline IntVector permute(const unsigned char* permutationArray, IntVector index) {
+		IntVector start = _mm256_max_epi32(_mm256_sub_epi32(index, _mm256_set1_epi32(3)), _mm256_setzero_si256());
+		IntVector shift = _mm256_slli_epi32(_mm256_sub_epi32(index, start), 3);
+		IntVector v = _mm256_i32gather_epi32(reinterpret_cast<const int*>(permutationArray), start, 1);
+		return _mm256_and_si256(_mm256_srlv_epi32(v, shift), _mm256_set1_epi32(0xFF));
+	}
+
+	// table[index] for tables loaded from a SimplexNoiseGradientTable
+	static TARGET_AVX512F inline Vector lookup8(const Vector* table, IntVector index) { return _mm512_permutexvar_pd(_mm512_cvtepu32_epi64(index), table[0]); }
+	static TARGET_AVX512F inline Vector lookup32(const Vector* table, IntVector index) {
+		__m512i index64 = _mm512_cvtepu32_epi64(index);
+		Vector low = _mm512_permutex2var_pd(table[0], index64, table[1]);
+		Vector high = _mm512_permutex2var_pd(table[2], index64, table[3]);
+		return _mm512_mask_blend_pd(_mm512_test_epi64_mask(index64, _mm512_set1_epi64(16)), low, high);
+	}
+
+};
+
+
+
+/**
+	Contribution of a single simplex corner to a 2d noise value.
+	Corners which are out of range are zeroed instead of skipped.
+	radiusSquared is 0.5 for noise2's lattice, and 0.8 for noise2_periodic's.
+*/
+template <typename V>
+static TARGET_AVX512F inline typename V::Vector
+noise2Contribution(
+	const unsigned char* permutationArray,
+	const typename V::Vector* gradientsX,
+	const typename V::Vector* gradientsY,
+	typename V::Vector radiusSquared,
+	typename V::IntVector i,
+	typename V::IntVector j,
+	typename V::Vector x,
+	typename V::Vector y
+) {
+	typedef typename V::Vector Vector;
+	typedef typename V::IntVector IntVector;
+
+	Vector c = V::sub(V::sub(radiusSquared, V::mul(x, x)), V::mul(y, y));
+	c = V::max(c, V::set(0.0));
+	c = V::mul(c, c);
+	c = V::mul(c, c);
+
+	IntVector hash = V::andi(V::permute(permutationArray, V::addi(i, V::permute(permutationArray, j))), V::seti(0x7));
+	Vector dot = V::add(V::mul(V::lookup8(gradientsX, hash), x), V::mul(V::lookup8(gradientsY, hash), y));
+
+	return V::mul(c, dot);
+}
+
+/**
+	2d noise; this performs the same operations in the same order as SimplexNoise<Float>::noise2,
+	so the results are identical.
+*/
+template <typename V>
+static TARGET_AVX512F void
+noise2Avx512(
+	const unsigned char* permutationArray,
+	SimplexNoiseSimd::CountInt count,
+	const typename V::Float* xs,
+	const typename V::Float* ys,
+	const int32_t* latticeOffset,
+	typename V::Float* out,
+	const SimplexNoiseGradientTable<typename V::Float, 2, 8>& gradients
+) {
+	typedef typename V::Float Float;
+	typedef typename V::Vector Vector;
+	typedef typename V::IntVector IntVector;
+	typedef typename V::Mask Mask;
+
+	const Vector skewFactor = V::set(SimplexNoiseHelper<Float, 2>::skewFactor());
+	const Vector deskewFactor = V::set(SimplexNoiseHelper<Float, 2>::deskewFactor());
+	const Vector deskew1 = V::set(static_cast<Float>(1) * SimplexNoiseHelper<Float, 2>::deskewFactor());
+	const Vector deskew2 = V::set(static_cast<Float>(2) * SimplexNoiseHelper<Float, 2>::deskewFactor());
+	const Vector one = V::set(1.0);
+	const Vector radiusSquared = V::set(0.5);
+	const Vector maximum = V::set(SimplexNoiseHelper<Float, 2>::unnormalizedMaximum());
+	const IntVector mask = V::seti(0xFF);
+	const IntVector ione = V::seti(1);
+	const IntVector offsetI = V::seti(latticeOffset != nullptr ? latticeOffset[0] : 0);
+	const IntVector offsetJ = V::seti(latticeOffset != nullptr ? latticeOffset[1] : 0);
+	const Vector gradientsX[1] = { V::load(gradients.values[0]) };
+	const Vector gradientsY[1] = { V::load(gradients.values[1]) };
+
+	Vector x, y, skew;
+	Vector rx0, ry0;
+	Vector c0;
+	IntVector si, sj;
+	Mask simplex0, simplex1;
+
+	for (SimplexNoiseSimd::CountInt n = 0; n < count; n += V::width) {
+		x = V::load(xs + n);
+		y = V::load(ys + n);
+
+		// Skew point and find origin
+		skew = V::mul(V::add(x, y), skewFactor);
+		si = V::floor(V::add(x, skew));
+		sj = V::floor(V::add(y, skew));
+
+		// The x,y relative distances from the deskewed origin
+		skew = V::mul(V::toFloat(V::addi(si, sj)), deskewFactor);
+		rx0 = V::add(V::sub(x, V::toFloat(si)), skew);
+		ry0 = V::add(V::sub(y, V::toFloat(sj)), skew);
+
+		// Offset and truncate the integer indices to [0,255]
+		si = V::andi(V::addi(si, offsetI), mask);
+		sj = V::andi(V::addi(sj, offsetJ), mask);
+
+		// Simplex second point order
+		simplex0 = V::compareGreaterEqual(rx0, ry0);
+		simplex1 = V::maskNot(simplex0);
+
+		// Contributions
+		c0 = noise2Contribution<V>(permutationArray, gradientsX, gradientsY, radiusSquared, si, sj, rx0, ry0);
+
+		c0 = V::add(c0, noise2Contribution<V>(
+			permutationArray,
+			gradientsX,
+			gradientsY,
+			radiusSquared,
+			V::addiMasked(si, simplex0, ione),
+			V::addiMasked(sj, simplex1, ione),
+			V::add(V::subMasked(rx0, simplex0, one), deskew1),
+			V::add(V::subMasked(ry0, simplex1, one), deskew1)
+		));
+
+		c0 = V::add(c0, noise2Contribution<V>(
+			permutationArray,
+			gradientsX,
+			gradientsY,
+			radiusSquared,
+			V::addi(si, ione),
+			V::addi(sj, ione),
+			V::add(V::sub(rx0, one), deskew2),
+			V::add(V::sub(ry0, one), deskew2)
+		));
+
+		// Done
+		V::store(out + n, V::div(c0, maximum));
+	}
+}
+
+
+
+/**
+	Contribution of a single simplex corner to a 2d noise value and its derivative.
+	The derivative is accumulated in two parts, the same way as SimplexNoise<Float>::noise2(x, y, dx, dy):
+		derivative = -8 * sum(position * dot * c^3) + sum(c^4 * gradient)
+*/
+template <typename V>
+static TARGET_AVX512F inline void
+noise2GradientContribution(
+	const unsigned char* permutationArray,
+	const typename V::Vector* gradientsX,
+	const typename V::Vector* gradientsY,
+	typename V::IntVector i,
+	typename V::IntVector j,
+	typename V::Vector x,
+	typename V::Vector y,
+	typename V::Vector& value,
+	typename V::Vector* derivative,
+	typename V::Vector* derivative2
+) {
+	typedef typename V::Vector Vector;
+	typedef typename V::IntVector IntVector;
+
+	Vector c = V::sub(V::sub(V::set(0.5), V::mul(x, x)), V::mul(y, y));
+	c = V::max(c, V::set(0.0));
+
+	IntVector hash = V::andi(V::permute(permutationArray, V::addi(i, V::permute(permutationArray, j))), V::seti(0x7));
+	Vector gx = V::lookup8(gradientsX, hash);
+	Vector gy = V::lookup8(gradientsY, hash);
+	Vector dot = V::add(V::mul(gx, x), V::mul(gy, y));
+
+	Vector c2 = V::mul(c, c);
+	derivative[0] = V::add(derivative[0], V::mul(V::mul(V::mul(x, dot), c2), c));
+	derivative[1] = V::add(derivative[1], V::mul(V::mul(V::mul(y, dot), c2), c));
+
+	c2 = V::mul(c2, c2);
+	derivative2[0] = V::add(derivative2[0], V::mul(gx, c2));
+	derivative2[1] = V::add(derivative2[1], V::mul(gy, c2));
+	value = V::add(value, V::mul(c2, dot));
+}
+
+/**
+	2d noise and its derivative; this performs the same operations in the same order as
+	SimplexNoise<Float>::noise2(x, y, dx, dy), so the results are identical.
+*/
+template <typename V>
+static TARGET_AVX512F void
+noise2GradientAvx512(
+	const unsigned char* permutationArray,
+	SimplexNoiseSimd::CountInt count,
+	const typename V::Float* xs,
+	const typename V::Float* ys,
+	typename V::Float* out,
+	SimplexNoiseSimd::CountInt stride,
+	SimplexNoiseSimd::CountInt componentStride,
+	const SimplexNoiseGradientTable<typename V::Float, 2, 8>& gradients
+) {
+	typedef typename V::Float Float;
+	typedef typename V::Vector Vector;
+	typedef typename V::IntVector IntVector;
+	typedef typename V::Mask Mask;
+
+	const Vector skewFactor = V::set(SimplexNoiseHelper<Float, 2>::skewFactor());
+	const Vector deskewFactor = V::set(SimplexNoiseHelper<Float, 2>::deskewFactor());
+	const Vector deskew1 = V::set(static_cast<Float>(1) * SimplexNoiseHelper<Float, 2>::deskewFactor());
+	const Vector deskew2 = V::set(static_cast<Float>(2) * SimplexNoiseHelper<Float, 2>::deskewFactor());
+	const Vector zero = V::set(0.0);
+	const Vector one = V::set(1.0);
+	const Vector derivativeFactor = V::set(-8.0);
+	const Vector maximum = V::set(SimplexNoiseHelper<Float, 2>::unnormalizedMaximum());
+	const IntVector mask = V::seti(0xFF);
+	const IntVector ione = V::seti(1);
+	const Vector gradientsX[1] = { V::load(gradients.values[0]) };
+	const Vector gradientsY[1] = { V::load(gradients.values[1]) };
+
+	Vector x, y, skew;
+	Vector rx0, ry0;
+	Vector c0;
+	Vector derivative[2];
+	Vector derivative2[2];
+	IntVector si, sj;
+	Mask simplex0, simplex1;
+	Float results[3][V::width];
+	int a;
+
+	for (SimplexNoiseSimd::CountInt n = 0; n < count; n += V::width) {
+		x = V::load(xs + n);
+		y = V::load(ys + n);
+
+		// Skew point and find origin
+		skew = V::mul(V::add(x, y), skewFactor);
+		si = V::floor(V::add(x, skew));
+		sj = V::floor(V::add(y, skew));
+
+		// The x,y relative distances from the deskewed origin
+		skew = V::mul(V::toFloat(V::addi(si, sj)), deskewFactor);
+		rx0 = V::add(V::sub(x, V::toFloat(si)), skew);
+		ry0 = V::add(V::sub(y, V::toFloat(sj)), skew);
+
+		// Truncate the integer indices to [0,255]
+		si = V::andi(si, mask);
+		sj = V::andi(sj, mask);
+
+		// Simplex second point order
+		simplex0 = V::compareGreaterEqual(rx0, ry0);
+		simplex1 = V::maskNot(simplex0);
+
+		// Contributions
+		c0 = zero;
+		for (a = 0; a < 2; ++a) {
+			derivative[a] = zero;
+			derivative2[a] = zero;
+		}
+
+		noise2GradientContribution<V>(permutationArray, gradientsX, gradientsY, si, sj, rx0, ry0, c0, derivative, derivative2);
+
+		noise2GradientContribution<V>(
+			permutationArray,
+			gradientsX,
+			gradientsY,
+			V::addiMasked(si, simplex0, ione),
+			V::addiMasked(sj, simplex1, ione),
+			V::add(V::subMasked(rx0, simplex0, one), deskew1),
+			V::add(V::subMasked(ry0, simplex1, one), deskew1),
+			c0,
+			derivative,
+			derivative2
+		);
+
+		noise2GradientContribution<V>(
+			permutationArray,
+			gradientsX,
+			gradientsY,
+			V::addi(si, ione),
+			V::addi(sj, ione),
+			V::add(V::sub(rx0, one), deskew2),
+			V::add(V::sub(ry0, one), deskew2),
+			c0,
+			derivative,
+			derivative2
+		);
+
+		// Complete derivative
+		for (a = 0; a < 2; ++a) {
+			derivative[a] = V::div(V::add(V::mul(derivative[a], derivativeFactor), derivative2[a]), maximum);
+		}
+		c0 = V::div(c0, maximum);
+
+		// Done
+		if (stride == 1) {
+			V::store(out + n, c0);
+			for (a = 0; a < 2; ++a) V::store(out + n + componentStride * (a + 1), derivative[a]);
+		}
+		else {
+			V::store(results[0], c0);
+			for (a = 0; a < 2; ++a) V::store(results[a + 1], derivative[a]);
+			storeGradient<Float, V::width, 3>(results, out + n * stride, stride, componentStride);
+		}
+	}
+}
+
+
+
+/**
+	Periodic 2d noise; this performs the same operations in the same order as SimplexNoise<Float>::noise2_periodic,
+	so the results are identical.
+*/
+template <typename V>
+static TARGET_AVX512F void
+noise2PeriodicAvx512(
+	const unsigned char* permutationArray,
+	SimplexNoiseSimd::CountInt count,
+	const typename V::Float* xs,
+	const typename V::Float* ys,
+	int32_t periodX,
+	int32_t periodY,
+	typename V::Float* out,
+	const SimplexNoiseGradientTable<typename V::Float, 2, 8>& gradients
+) {
+	typedef typename V::Float Float;
+	typedef typename V::Vector Vector;
+	typedef typename V::IntVector IntVector;
+	typedef typename V::Mask Mask;
+
+	const Vector half = V::set(0.5);
+	const Vector one = V::set(1.0);
+	const Vector radiusSquared = V::set(static_cast<Float>(0.8));
+	const Vector maximum = V::set(SimplexNoiseHelper<Float, 2>::periodicUnnormalizedMaximum());
+	const Vector positionPeriodX = V::set(static_cast<Float>(periodX));
+	const Vector positionPeriodY = V::set(static_cast<Float>(periodY));
+	const IntVector vertexPeriodX = V::seti(2 * periodX);
+	const IntVector vertexPeriodY = V::seti(periodY);
+	const IntVector mask = V::seti(0xFF);
+	const IntVector ione = V::seti(1);
+	const IntVector itwo = V::seti(2);
+	const IntVector iminusOne = V::seti(-1);
+	const Vector gradientsX[1] = { V::load(gradients.values[0]) };
+	const Vector gradientsY[1] = { V::load(gradients.values[1]) };
+
+	Vector x, y, su;
+	Vector fu, fv, rx0, ry0;
+	Vector c0;
+	IntVector si, sj, vx, vy, cx, cy;
+	Mask simplex0, simplex1;
+
+	for (SimplexNoiseSimd::CountInt n = 0; n < count; n += V::width) {
+		x = V::load(xs + n);
+		y = V::load(ys + n);
+
+		// Move point into the first period
+		if (periodX != 0) x = V::sub(x, V::mul(V::toFloat(V::floor(V::div(x, positionPeriodX))), positionPeriodX));
+		if (periodY != 0) y = V::sub(y, V::mul(V::toFloat(V::floor(V::div(y, positionPeriodY))), positionPeriodY));
+
+		// Shear point and find origin
+		su = V::add(x, V::mul(y, half));
+		si = V::floor(su);
+		sj = V::floor(y);
+		fu = V::sub(su, V::toFloat(si));
+		fv = V::sub(y, V::toFloat(sj));
+
+		// The x,y relative distances from the origin vertex
+		rx0 = V::sub(fu, V::mul(fv, half));
+		ry0 = fv;
+
+		// The doubled x and the y coordinates of the origin vertex, wrapped to the periods
+		vx = V::subi(V::addi(si, si), sj);
+		vy = sj;
+		if (periodX != 0) vx = V::wrapi(vx, vertexPeriodX);
+		if (periodY != 0) vy = V::wrapi(vy, vertexPeriodY);
+
+		// Simplex second point order
+		simplex0 = V::compareGreaterEqual(fu, fv);
+		simplex1 = V::maskNot(simplex0);
+
+		// Contributions; lattice vertex (i, j) has the doubled x coordinate 2 * i - j
+		c0 = noise2Contribution<V>(permutationArray, gradientsX, gradientsY, radiusSquared, V::andi(V::halfi(V::addi(vx, vy)), mask), V::andi(vy, mask), rx0, ry0);
+
+		cx = V::addiMasked(V::addiMasked(vx, simplex0, itwo), simplex1, iminusOne);
+		cy = V::addiMasked(vy, simplex1, ione);
+		if (periodX != 0) cx = V::wrapi(cx, vertexPeriodX);
+		if (periodY != 0) cy = V::wrapi(cy, vertexPeriodY);
+		c0 = V::add(c0, noise2Contribution<V>(
+			permutationArray,
+			gradientsX,
+			gradientsY,
+			radiusSquared,
+			V::andi(V::halfi(V::addi(cx, cy)), mask),
+			V::andi(cy, mask),
+			V::addMasked(V::subMasked(rx0, simplex0, one), simplex1, half),
+			V::subMasked(ry0, simplex1, one)
+		));
+
+		cx = V::addi(vx, ione);
+		cy = V::addi(vy, ione);
+		if (periodX != 0) cx = V::wrapi(cx, vertexPeriodX);
+		if (periodY != 0) cy = V::wrapi(cy, vertexPeriodY);
+		c0 = V::add(c0, noise2Contribution<V>(
+			permutationArray,
+			gradientsX,
+			gradientsY,
+			radiusSquared,
+			V::andi(V::halfi(V::addi(cx, cy)), mask),
+			V::andi(cy, mask),
+			V::sub(rx0, half),
+			V::sub(ry0, one)
+		));
+
+		// Done
+		V::store(out + n, V::div(c0, maximum));
+	}
+}
+
+
+
+/**
+	Contribution of a single simplex corner to a 4d noise value.
+	Corners which are out of range are zeroed instead of skipped.
+*/
+template <typename V>
+static TARGET_AVX512F inline typename V::Vector
+noise4Contribution(
+	const unsigned char* permutationArray,
+	const typename V::Vector (*gradientTable)[32 / V::width],
+	const typename V::IntVector* index,
+	const typename V::Vector* point
+) {
+	typedef typename V::Vector Vector;
+	typedef typename V::IntVector IntVector;
+
+	Vector dot = V::mul(point[0], point[0]);
+	dot = V::add(dot, V::mul(point[1], point[1]));
+	dot = V::add(dot, V::mul(point[2], point[2]));
+	dot = V::add(dot, V::mul(point[3], point[3]));
+	Vector c = V::max(V::sub(V::set(0.5), dot), V::set(0.0));
+
+	IntVector hash =
+		V::permute(permutationArray, V::addi(index[0],
+		V::permute(permutationArray, V::addi(index[1],
+		V::permute(permutationArray, V::addi(index[2],
+		V::permute(permutationArray, index[3]
+		)))))));
+	hash = V::andi(hash, V::seti(0x1F));
+
+	dot = V::mul(V::lookup32(gradientTable[0], hash), point[0]);
+	dot = V::add(dot, V::mul(V::lookup32(gradientTable[1], hash), point[1]));
+	dot = V::add(dot, V::mul(V::lookup32(gradientTable[2], hash), point[2]));
+	dot = V::add(dot, V::mul(V::lookup32(gradientTable[3], hash), point[3]));
+
+	return V::mul(V::mul(V::mul(c, c), c), dot);
+}
+
+/**
+	4d noise; this performs the same operations in the same order as SimplexNoise<Float>::noise4,
+	so the results are identical.
+	The simplex order is found by ranking each component by comparison against the others,
+	instead of an insertion sort; ties are broken the same way.
+*/
+template <typename V>
+static TARGET_AVX512F void
+noise4Avx512(
+	const unsigned char* permutationArray,
+	SimplexNoiseSimd::CountInt count,
+	const typename V::Float* xs,
+	const typename V::Float* ys,
+	const typename V::Float* zs,
+	const typename V::Float* ws,
+	const int32_t* latticeOffset,
+	typename V::Float* out,
+	const SimplexNoiseGradientTable<typename V::Float, 4, 32>& gradients
+) {
+	typedef typename V::Float Float;
+	typedef typename V::Vector Vector;
+	typedef typename V::IntVector IntVector;
+
+	const Vector skewFactor = V::set(SimplexNoiseHelper<Float, 4>::skewFactor());
+	const Vector deskewFactor = V::set(SimplexNoiseHelper<Float, 4>::deskewFactor());
+	const Vector one = V::set(1.0);
+	const Vector maximum = V::set(SimplexNoiseHelper<Float, 4>::unnormalizedMaximum());
+	const IntVector mask = V::seti(0xFF);
+	const IntVector ione = V::seti(1);
+	Vector deskew[5];
+	Vector gradientTable[4][32 / V::width];
+	IntVector offset[4];
+	int i, j, k;
+
+	for (i = 1; i <= 4; ++i) {
+		deskew[i] = V::set(static_cast<Float>(i) * SimplexNoiseHelper<Float, 4>::deskewFactor());
+	}
+	for (i = 0; i < 4; ++i) {
+		for (j = 0; j < 32 / V::width; ++j) {
+			gradientTable[i][j] = V::load(&gradients.values[i][j * V::width]);
+		}
+	}
+	for (k = 0; k < 4; ++k) {
+		offset[k] = V::seti(latticeOffset != nullptr ? latticeOffset[k] : 0);
+	}
+
+	Vector position[4];
+	Vector point0[4];
+	Vector point1[4];
+	IntVector pointFloor[4];
+	IntVector pointRank[4];
+	IntVector index[4];
+	Vector skew;
+	Vector c0;
+
+	for (SimplexNoiseSimd::CountInt n = 0; n < count; n += V::width) {
+		position[0] = V::load(xs + n);
+		position[1] = V::load(ys + n);
+		position[2] = V::load(zs + n);
+		position[3] = V::load(ws + n);
+
+		// Skew point and find origin
+		skew = V::mul(V::add(V::add(V::add(position[0], position[1]), position[2]), position[3]), skewFactor);
+		for (k = 0; k < 4; ++k) {
+			pointFloor[k] = V::floor(V::add(position[k], skew));
+		}
+
+		// The x,y,z,w relative distances from the deskewed origin
+		skew = V::mul(V::toFloat(V::addi(V::addi(V::addi(pointFloor[0], pointFloor[1]), pointFloor[2]), pointFloor[3])), deskewFactor);
+		for (k = 0; k < 4; ++k) {
+			point0[k] = V::add(V::sub(position[k], V::toFloat(pointFloor[k])), skew);
+			pointFloor[k] = V::andi(V::addi(pointFloor[k], offset[k]), mask);
+		}
+
+		// Rank each component; the largest has rank 1, and earlier components win ties
+		for (k = 0; k < 4; ++k) {
+			pointRank[k] = ione;
+			for (j = 0; j < k; ++j) pointRank[k] = V::addiMasked(pointRank[k], V::compareGreaterEqual(point0[j], point0[k]), ione);
+			for (j = k + 1; j < 4; ++j) pointRank[k] = V::addiMasked(pointRank[k], V::compareGreater(point0[j], point0[k]), ione);
+		}
+
+		// First case
+		c0 = noise4Contribution<V>(permutationArray, gradientTable, pointFloor, point0);
+
+		// Remaining points; the components with rank <= i are offset
+		for (i = 1; i <= 4; ++i) {
+			for (k = 0; k < 4; ++k) {
+				typename V::Mask order = V::compareLessEquali(pointRank[k], V::seti(i));
+				index[k] = V::addiMasked(pointFloor[k], order, ione);
+				point1[k] = V::add(V::subMasked(point0[k], order, one), deskew[i]);
+			}
+
+			c0 = V::add(c0, noise4Contribution<V>(permutationArray, gradientTable, index, point1));
+		}
+
+		// Done
+		V::store(out + n, V::div(c0, maximum));
+	}
+}
+
+#endif // SIMPLEX_NOISE_SIMD_X86
+
+
+
+// 2d noise
+SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise2(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const float* xs,
+	const float* ys,
+	const int32_t* latticeOffset,
+	float* out
+) {
+#ifdef SIMPLEX_NOISE_SIMD_X86
+	if (SimplexNoiseSimd::hasAvx512f()) {
+		static const SimplexNoiseGradientTable<float, 2, 8> gradients(SimplexNoiseHelper<float, 2>::gradientTable);
+		count -= count % SimplexNoiseAvx512Float::width;
+		noise2Avx512<SimplexNoiseAvx512Float>(permutationArray, count, xs, ys, latticeOffset, out, gradients);
+		return count;
+	}
+#endif
+
+	return 0;
+}
+
+SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise2(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const double* xs,
+	const double* ys,
+	const int32_t* latticeOffset,
+	double* out
+) {
+#ifdef SIMPLEX_NOISE_SIMD_X86
+	if (SimplexNoiseSimd::hasAvx512f()) {
+		static const SimplexNoiseGradientTable<double, 2, 8> gradients(SimplexNoiseHelper<double, 2>::gradientTable);
+		count -= count % SimplexNoiseAvx512Double::width;
+		noise2Avx512<SimplexNoiseAvx512Double>(permutationArray, count, xs, ys, latticeOffset, out, gradients);
+		return count;
+	}
+#endif
+
+	return 0;
+}
+
+
+
+// 3d noise
+SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise3(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const float* xs,
+	const float* ys,
+	const float* zs,
+	const int32_t* latticeOffset,
+	float* out
+) {
+#ifdef SIMPLEX_NOISE_SIMD_X86
+	if (SimplexNoiseSimd::hasAvx2()) {
+		count -= count % SimplexNoiseAvx2Float::width;
+		noise3Avx2<SimplexNoiseAvx2Float>(permutationArray, count, xs, ys, zs, latticeOffset, out);
+		return count;
+	}
+#endif
+
+	return 0;
+}
+
+SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise3(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const double* xs,
+	const double* ys,
+	const double* zs,
+	const int32_t* latticeOffset,
+	double* out
+) {
+#ifdef SIMPLEX_NOISE_SIMD_X86
+	if (SimplexNoiseSimd::hasAvx2()) {
+		count -= count % SimplexNoiseAvx2Double::width;
+		noise3Avx2<SimplexNoiseAvx2Double>(permutationArray, count, xs, ys, zs, latticeOffset, out);
+		return count;
+	}
+#endif
+
+	return 0;
+}
+
+
+// 4d noise
+SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise4(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const float* xs,
+	const float* ys,
+	const float* zs,
+	const float* ws,
+	const int32_t* latticeOffset,
+	float* out
+) {
+#ifdef SIMPLEX_NOISE_SIMD_X86
+	if (SimplexNoiseSimd::hasAvx512f()) {
+		static const SimplexNoiseGradientTable<float, 4, 32> gradients(SimplexNoiseHelper<float, 4>::gradientTable);
+		count -= count % SimplexNoiseAvx512Float::width;
+		noise4Avx512<SimplexNoiseAvx512Float>(permutationArray, count, xs, ys, zs, ws, latticeOffset, out, gradients);
+		return count;
+	}
+#endif
+
+	return 0;
+}
+
+SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise4(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const double* xs,
+	const double* ys,
+	const double* zs,
+	const double* ws,
+	const int32_t* latticeOffset,
+	double* out
+) {
+#ifdef SIMPLEX_NOISE_SIMD_X86
+	if (SimplexNoiseSimd::hasAvx512f()) {
+		static const SimplexNoiseGradientTable<double, 4, 32> gradients(SimplexNoiseHelper<double, 4>::gradientTable);
+		count -= count % SimplexNoiseAvx512Double::width;
+		noise4Avx512<SimplexNoiseAvx512Double>(permutationArray, count, xs, ys, zs, ws, latticeOffset, out, gradients);
+		return count;
+	}
+#endif
+
+	return 0;
+}
+
+
+
+// 2d gradients
+SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise2_gradient(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const float* xs,
+	const float* ys,
+	float* out,
+	CountInt stride,
+	CountInt componentStride
+) {
+#ifdef SIMPLEX_NOISE_SIMD_X86
+	if (SimplexNoiseSimd::hasAvx512f()) {
+		static const SimplexNoiseGradientTable<float, 2, 8> gradients(SimplexNoiseHelper<float, 2>::gradientTable);
+		count -= count % SimplexNoiseAvx512Float::width;
+		noise2GradientAvx512<SimplexNoiseAvx512Float>(permutationArray, count, xs, ys, out, stride, componentStride, gradients);
+		return count;
+	}
+#endif
+
+	return 0;
+}
+
+SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise2_gradient(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const double* xs,
+	const double* ys,
+	double* out,
+	CountInt stride,
+	CountInt componentStride
+) {
+#ifdef SIMPLEX_NOISE_SIMD_X86
+	if (SimplexNoiseSimd::hasAvx512f()) {
+		static const SimplexNoiseGradientTable<double, 2, 8> gradients(SimplexNoiseHelper<double, 2>::gradientTable);
+		count -= count % SimplexNoiseAvx512Double::width;
+		noise2GradientAvx512<SimplexNoiseAvx512Double>(permutationArray, count, xs, ys, out, stride, componentStride, gradients);
+		return count;
+	}
+#endif
+
+	return 0;
+}
+
+
+
+// 3d gradients
+SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise3_gradient(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const float* xs,
+	const float* ys,
+	const float* zs,
+	float* out,
+	CountInt stride,
+	CountInt componentStride
+) {
+#ifdef SIMPLEX_NOISE_SIMD_X86
+	if (SimplexNoiseSimd::hasAvx2()) {
+		count -= count % SimplexNoiseAvx2Float::width;
+		noise3GradientAvx2<SimplexNoiseAvx2Float>(permutationArray, count, xs, ys, zs, out, stride, componentStride);
+		return count;
+	}
+#endif
+
+	return 0;
+}
+
+SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise3_gradient(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const double* xs,
+	const double* ys,
+	const double* zs,
+	double* out,
+	CountInt stride,
+	CountInt componentStride
+) {
+#ifdef SIMPLEX_NOISE_SIMD_X86
+	if (SimplexNoiseSimd::hasAvx2()) {
+		count -= count % SimplexNoiseAvx2Double::width;
+		noise3GradientAvx2<SimplexNoiseAvx2Double>(permutationArray, count, xs, ys, zs, out, stride, componentStride);
+		return count;
+	}
+#endif
+
+	return 0;
+}
+
+
+
+// 3d curl
+SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: curl3(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const float* xs,
+	const float* ys,
+	const float* zs,
+	float* out,
+	CountInt stride,
+	CountInt componentStride
+) {
+#ifdef SIMPLEX_NOISE_SIMD_X86
+	if (SimplexNoiseSimd::hasAvx2()) {
+		count -= count % SimplexNoiseAvx2Float::width;
+		curl3Avx2<SimplexNoiseAvx2Float>(permutationArray, count, xs, ys, zs, out, stride, componentStride);
+		return count;
+	}
+#endif
+
+	return 0;
+}
+
+SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: curl3(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const double* xs,
+	const double* ys,
+	const double* zs,
+	double* out,
+	CountInt stride,
+	CountInt componentStride
+) {
+#ifdef SIMPLEX_NOISE_SIMD_X86
+	if (SimplexNoiseSimd::hasAvx2()) {
+		count -= count % SimplexNoiseAvx2Double::width;
+		curl3Avx2<SimplexNoiseAvx2Double>(permutationArray, count, xs, ys, zs, out, stride, componentStride);
+		return count;
+	}
+#endif
+
+	return 0;
+}
+
+
+
+// 2d periodic noise
+SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise2_periodic(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const float* xs,
+	const float* ys,
+	int32_t periodX,
+	int32_t periodY,
+	float* out
+) {
+#ifdef SIMPLEX_NOISE_SIMD_X86
+	if (SimplexNoiseSimd::hasAvx512f()) {
+		static const SimplexNoiseGradientTable<float, 2, 8> gradients(SimplexNoiseHelper<float, 2>::gradientTable);
+		count -= count % SimplexNoiseAvx512Float::width;
+		noise2PeriodicAvx512<SimplexNoiseAvx512Float>(permutationArray, count, xs, ys, periodX, periodY, out, gradients);
+		return count;
+	}
+#endif
+
+	return 0;
+}
+
+SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise2_periodic(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const double* xs,
+	const double* ys,
+	int32_t periodX,
+	int32_t periodY,
+	double* out
+) {
+#ifdef SIMPLEX_NOISE_SIMD_X86
+	if (SimplexNoiseSimd::hasAvx512f()) {
+		static const SimplexNoiseGradientTable<double, 2, 8> gradients(SimplexNoiseHelper<double, 2>::gradientTable);
+		count -= count % SimplexNoiseAvx512Double::width;
+		noise2PeriodicAvx512<SimplexNoiseAvx512Double>(permutationArray, count, xs, ys, periodX, periodY, out, gradients);
+		return count;
+	}
+#endif
+
+	return 0;
+}
+
+
+
+// 3d periodic noise
+SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise3_periodic(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const float* xs,
+	const float* ys,
+	const float* zs,
+	int32_t periodX,
+	int32_t periodY,
+	int32_t periodZ,
+	float* out
+) {
+#ifdef SIMPLEX_NOISE_SIMD_X86
+	if (SimplexNoiseSimd::hasAvx2()) {
+		count -= count % SimplexNoiseAvx2Float::width;
+		noise3PeriodicAvx2<SimplexNoiseAvx2Float>(permutationArray, count, xs, ys, zs, periodX, periodY, periodZ, out);
+		return count;
+	}
+#endif
+
+	return 0;
+}
+
+SimplexNoiseSimd::CountInt
+SimplexNoiseSimd :: noise3_periodic(
+	const unsigned char* permutationArray,
+	CountInt count,
+	const double* xs,
+	const double* ys,
+	const double* zs,
+	int32_t periodX,
+	int32_t periodY,
+	int32_t periodZ,
+	double* out
+) {
+#ifdef SIMPLEX_NOISE_SIMD_X86
+	if (SimplexNoiseSimd::hasAvx2()) {
+		count -= count % SimplexNoiseAvx2Double::width;
+		noise3PeriodicAvx2<SimplexNoiseAvx2Double>(permutationArray, count, xs, ys, zs, periodX, periodY, periodZ, out);
+		return count;
+	}
+#endif
+
+	return 0;
+}
+
+
+
+#undef TARGET_AVX2
+#undef TARGET_AVX512F
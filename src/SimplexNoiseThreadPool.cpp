@@ -0,0 +1,186 @@
+/*
+	Templated SimplexNoise; thread pool
+*/
+#include "SimplexNoiseThreadPool.hpp"
+#include <cassert>
+
+
+
+// SimplexNoiseThreadPool
+SimplexNoiseThreadPool :: SimplexNoiseThreadPool(
+	unsigned int threadCount
+) :
+	threadCount(threadCount),
+	queues(nullptr),
+	threads(),
+	mutex(),
+	wakeCondition(),
+	doneCondition(),
+	function(nullptr),
+	generation(0),
+	running(0),
+	stopping(false)
+{
+	if (this->threadCount == 0) {
+		this->threadCount = std::thread::hardware_concurrency();
+		if (this->threadCount == 0) this->threadCount = 1;
+	}
+
+	this->queues = new Queue[this->threadCount];
+	for (unsigned int i = 0; i < this->threadCount; ++i) {
+		this->queues[i].begin = 0;
+		this->queues[i].end = 0;
+	}
+
+	// Thread 0 is the thread calling run
+	this->threads.reserve(this->threadCount - 1);
+	for (unsigned int i = 1; i < this->threadCount; ++i) {
+		this->threads.emplace_back(&SimplexNoiseThreadPool::workerLoop, this, i);
+	}
+}
+
+SimplexNoiseThreadPool :: ~SimplexNoiseThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+	}
+	this->wakeCondition.notify_all();
+
+	for (std::thread& t : this->threads) {
+		t.join();
+	}
+
+	delete [] this->queues;
+}
+
+unsigned int
+SimplexNoiseThreadPool :: getThreadCount() const {
+	return this->threadCount;
+}
+
+void
+SimplexNoiseThreadPool :: run(
+	CountInt itemCount,
+	const ItemFunction& function
+) {
+	if (itemCount == 0) return;
+
+	// Split the items evenly
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		assert(this->running == 0);
+
+		for (unsigned int i = 0; i < this->threadCount; ++i) {
+			std::lock_guard<std::mutex> queueLock(this->queues[i].mutex);
+			this->queues[i].begin = itemCount * i / this->threadCount;
+			this->queues[i].end = itemCount * (i + 1) / this->threadCount;
+		}
+
+		this->function = &function;
+		this->running = this->threadCount - 1;
+		++this->generation;
+	}
+	this->wakeCondition.notify_all();
+
+	// Work on this thread too
+	this->work(0);
+
+	// Wait for the other threads
+	std::unique_lock<std::mutex> lock(this->mutex);
+	while (this->running > 0) {
+		this->doneCondition.wait(lock);
+	}
+	this->function = nullptr;
+}
+
+void
+SimplexNoiseThreadPool :: workerLoop(
+	unsigned int thread
+) {
+	unsigned long generationCompleted = 0;
+
+	while (true) {
+		// Wait for work
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			while (!this->stopping && this->generation == generationCompleted) {
+				this->wakeCondition.wait(lock);
+			}
+			if (this->stopping) break;
+			generationCompleted = this->generation;
+		}
+
+		this->work(thread);
+
+		// Done
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			if (--this->running == 0) {
+				this->doneCondition.notify_one();
+			}
+		}
+	}
+}
+
+void
+SimplexNoiseThreadPool :: work(
+	unsigned int thread
+) {
+	Queue& queue = this->queues[thread];
+	CountInt item = 0;
+	bool found;
+
+	while (true) {
+		// Take from the front of this thread's queue
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			found = (queue.begin < queue.end);
+			if (found) {
+				item = queue.begin;
+				++queue.begin;
+			}
+		}
+
+		if (found) {
+			(*this->function)(item, thread);
+		}
+		else if (!this->steal(thread)) {
+			// No work left anywhere
+			break;
+		}
+	}
+}
+
+bool
+SimplexNoiseThreadPool :: steal(
+	unsigned int thread
+) {
+	CountInt begin, end;
+
+	for (unsigned int i = 1; i < this->threadCount; ++i) {
+		Queue& victim = this->queues[(thread + i) % this->threadCount];
+
+		// Take the back half
+		{
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (victim.begin >= victim.end) continue;
+
+			end = victim.end;
+			begin = end - (end - victim.begin + 1) / 2;
+			victim.end = begin;
+		}
+
+		// Only this thread adds items to its own queue, so it's still empty here
+		Queue& queue = this->queues[thread];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.begin = begin;
+			queue.end = end;
+		}
+		return true;
+	}
+
+	return false;
+}
+
+
@@ -0,0 +1,108 @@
+/*
+	Templated SimplexNoise; thread pool
+*/
+#ifndef ___H_SIMPLEX_NOISE_THREAD_POOL
+#define ___H_SIMPLEX_NOISE_THREAD_POOL
+
+
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+
+
+// Class definitions
+class SimplexNoiseThreadPool final {
+public: // Public types
+	typedef std::size_t CountInt;
+
+	/**
+		@param item
+			The index of the item to process, in [0, itemCount)
+		@param thread
+			The index of the thread processing the item, in [0, getThreadCount())
+	*/
+	typedef std::function<void(CountInt item, unsigned int thread)> ItemFunction;
+
+private: // Private types
+	// A range of items owned by one thread; the owner takes items from the front, other threads steal from the back
+	struct Queue {
+		std::mutex mutex;
+		CountInt begin;
+		CountInt end;
+	};
+
+private: // Private instance members
+	unsigned int threadCount;
+	Queue* queues;
+	std::vector<std::thread> threads;
+
+	std::mutex mutex;
+	std::condition_variable wakeCondition;
+	std::condition_variable doneCondition;
+	const ItemFunction* function;
+	unsigned long generation;
+	unsigned int running;
+	bool stopping;
+
+public: // Public instance methods
+	/**
+		@param threadCount
+			The number of threads to use, including the thread calling run.
+			If 0, std::thread::hardware_concurrency() is used
+	*/
+	explicit SimplexNoiseThreadPool(
+		unsigned int threadCount = 0
+	);
+	SimplexNoiseThreadPool(const SimplexNoiseThreadPool&) = delete;
+	~SimplexNoiseThreadPool();
+
+	SimplexNoiseThreadPool& operator = (const SimplexNoiseThreadPool&) = delete;
+
+	unsigned int
+	getThreadCount() const;
+
+	/**
+		Calls function once for every item in [0, itemCount), and returns once all items are done.
+		Items are split evenly between the threads; threads that run out of work steal
+		half of the remaining items of another thread.
+		Must not be called from more than one thread at a time.
+
+		@param itemCount
+			The number of items to process
+		@param function
+			The function to call for each item
+	*/
+	void
+	run(
+		CountInt itemCount,
+		const ItemFunction& function
+	);
+
+private: // Private instance methods
+	void
+	workerLoop(
+		unsigned int thread
+	);
+
+	void
+	work(
+		unsigned int thread
+	);
+
+	bool
+	steal(
+		unsigned int thread
+	);
+
+};
+
+
+
+#endif // ___H_SIMPLEX_NOISE_THREAD_POOL
+
+
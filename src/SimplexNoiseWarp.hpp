@@ -0,0 +1,134 @@
+/*
+	Templated SimplexNoise; domain warping
+*/
+#ifndef ___H_SIMPLEX_NOISE_WARP
+#define ___H_SIMPLEX_NOISE_WARP
+
+
+
+#include "SimplexNoiseFbm.hpp"
+
+
+
+// Class definitions
+/**
+	Domain warped noise; the field is sampled at a position displaced by the warp field, repeated depth times:
+		p[0] = p
+		p[d + 1] = p + amplitude * (warp(p[d] + offset[0]), ..., warp(p[d] + offset[Dimensions - 1]))
+		result = field(p[depth])
+	Each component of the displacement samples the same warp evaluator at a different fixed offset.
+
+	@param Float
+		The floating point type to use
+	@param Dimensions
+		The number of dimensions of the noise; 1 to 4
+*/
+template <typename Float, int Dimensions>
+class SimplexNoiseWarp final {
+public: // Public types
+	typedef typename SimplexNoiseFbm<Float, Dimensions>::OctavesInt OctavesInt;
+	typedef typename SimplexNoiseFbm<Float, Dimensions>::CountInt CountInt;
+
+private: // Private static members
+	static constexpr unsigned int batchSize = 64;
+	static const Float componentOffsets[4][4];
+
+private: // Private instance members
+	SimplexNoiseFbm<Float, Dimensions> field;
+	SimplexNoiseFbm<Float, Dimensions> warp;
+	Float amplitude;
+	unsigned int depth;
+
+public: // Public instance methods
+	/**
+		@param field
+			The evaluator of the final field; it's copied
+		@param warp
+			The evaluator of the warp field; it's copied
+		@param amplitude
+			The displacement multiplier
+		@param depth
+			The number of times the warp is applied; 0 evaluates the field without warping
+	*/
+	SimplexNoiseWarp(
+		const SimplexNoiseFbm<Float, Dimensions>& field,
+		const SimplexNoiseFbm<Float, Dimensions>& warp,
+		Float amplitude,
+		unsigned int depth = 1
+	);
+
+	/**
+		Uses the same generator for both fields, with the default lacunarity and gain.
+
+		@param generator
+			The noise generator to use; it's copied
+		@param octaves
+			The number of octaves of the final field
+		@param warpOctaves
+			The number of octaves of the warp field
+		@param amplitude
+			The displacement multiplier
+		@param depth
+			The number of times the warp is applied
+	*/
+	SimplexNoiseWarp(
+		const SimplexNoise<Float>& generator,
+		OctavesInt octaves,
+		OctavesInt warpOctaves,
+		Float amplitude,
+		unsigned int depth = 1
+	);
+
+	/**
+		@param position
+			The position to evaluate at; must contain Dimensions values
+		@return
+			The value of the field at the warped position
+	*/
+	Float
+	noise(
+		const Float* position
+	);
+
+	/**
+		@param position
+			The position to evaluate at; must contain Dimensions values
+		@param derivative
+			The analytic gradient of the result with respect to position, including the warp; must have room for Dimensions values
+	*/
+	Float
+	noise(
+		const Float* position,
+		Float* derivative
+	);
+
+	/**
+		Evaluates the warp and the field block by block; the warped coordinates of a block stay in local scratch
+		between passes, and every pass runs through SimplexNoiseFbm<Float, Dimensions>::noise_batch.
+
+		@param count
+			The number of positions
+		@param coordinates
+			Dimensions arrays of count values each; coordinates[k][i] is the k-th coordinate of position i
+		@param out
+			The results; must have room for count values
+	*/
+	void
+	noise_batch(
+		CountInt count,
+		const Float* const* coordinates,
+		Float* out
+	);
+
+};
+
+
+
+// Template implementations
+#include "SimplexNoiseWarp.t.hpp"
+
+
+
+#endif // ___H_SIMPLEX_NOISE_WARP
+
+
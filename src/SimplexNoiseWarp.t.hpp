@@ -0,0 +1,185 @@
+/*
+	Templated SimplexNoise; domain warping
+*/
+#include <cassert>
+
+
+
+// SimplexNoiseWarp<Float, Dimensions>
+template <typename Float, int Dimensions>
+constexpr unsigned int SimplexNoiseWarp<Float, Dimensions> :: batchSize;
+
+template <typename Float, int Dimensions>
+const Float
+SimplexNoiseWarp<Float, Dimensions> :: componentOffsets[4][4] = {
+	{ static_cast<Float>(0.0), static_cast<Float>(0.0), static_cast<Float>(0.0), static_cast<Float>(0.0) },
+	{ static_cast<Float>(5.2), static_cast<Float>(1.3), static_cast<Float>(2.9), static_cast<Float>(7.1) },
+	{ static_cast<Float>(1.7), static_cast<Float>(9.2), static_cast<Float>(6.4), static_cast<Float>(3.3) },
+	{ static_cast<Float>(8.3), static_cast<Float>(2.8), static_cast<Float>(4.6), static_cast<Float>(0.9) },
+};
+
+template <typename Float, int Dimensions>
+SimplexNoiseWarp<Float, Dimensions> :: SimplexNoiseWarp(
+	const SimplexNoiseFbm<Float, Dimensions>& field,
+	const SimplexNoiseFbm<Float, Dimensions>& warp,
+	Float amplitude,
+	unsigned int depth
+) :
+	field(field),
+	warp(warp),
+	amplitude(amplitude),
+	depth(depth)
+{
+}
+
+template <typename Float, int Dimensions>
+SimplexNoiseWarp<Float, Dimensions> :: SimplexNoiseWarp(
+	const SimplexNoise<Float>& generator,
+	OctavesInt octaves,
+	OctavesInt warpOctaves,
+	Float amplitude,
+	unsigned int depth
+) :
+	field(generator, octaves),
+	warp(generator, warpOctaves),
+	amplitude(amplitude),
+	depth(depth)
+{
+}
+
+template <typename Float, int Dimensions>
+Float
+SimplexNoiseWarp<Float, Dimensions> :: noise(
+	const Float* position
+) {
+	assert(position != nullptr);
+
+	Float warped[Dimensions];
+	Float shifted[Dimensions];
+	Float displacement[Dimensions];
+	unsigned int d;
+	int j, k;
+
+	for (k = 0; k < Dimensions; ++k) warped[k] = position[k];
+
+	for (d = 0; d < this->depth; ++d) {
+		for (j = 0; j < Dimensions; ++j) {
+			for (k = 0; k < Dimensions; ++k) shifted[k] = warped[k] + componentOffsets[j][k];
+			displacement[j] = this->warp.noise(shifted);
+		}
+
+		for (k = 0; k < Dimensions; ++k) warped[k] = position[k] + this->amplitude * displacement[k];
+	}
+
+	return this->field.noise(warped);
+}
+
+template <typename Float, int Dimensions>
+Float
+SimplexNoiseWarp<Float, Dimensions> :: noise(
+	const Float* position,
+	Float* derivative
+) {
+	assert(position != nullptr);
+	assert(derivative != nullptr);
+
+	// jacobian[j][k] = d(warped[j]) / d(position[k])
+	Float warped[Dimensions];
+	Float shifted[Dimensions];
+	Float displacement[Dimensions];
+	Float jacobian[Dimensions][Dimensions];
+	Float nextJacobian[Dimensions][Dimensions];
+	Float gradient[Dimensions][Dimensions];
+	Float fieldGradient[Dimensions];
+	Float n;
+	unsigned int d;
+	int i, j, k;
+
+	for (j = 0; j < Dimensions; ++j) {
+		warped[j] = position[j];
+		for (k = 0; k < Dimensions; ++k) jacobian[j][k] = static_cast<Float>(j == k);
+	}
+
+	for (d = 0; d < this->depth; ++d) {
+		for (j = 0; j < Dimensions; ++j) {
+			for (k = 0; k < Dimensions; ++k) shifted[k] = warped[k] + componentOffsets[j][k];
+			displacement[j] = this->warp.noise(shifted, gradient[j]);
+		}
+
+		// warped' = position + amplitude * displacement(warped), so J' = I + amplitude * gradient * J
+		for (j = 0; j < Dimensions; ++j) {
+			for (k = 0; k < Dimensions; ++k) {
+				n = 0;
+				for (i = 0; i < Dimensions; ++i) n += gradient[j][i] * jacobian[i][k];
+				nextJacobian[j][k] = static_cast<Float>(j == k) + this->amplitude * n;
+			}
+		}
+
+		for (j = 0; j < Dimensions; ++j) {
+			warped[j] = position[j] + this->amplitude * displacement[j];
+			for (k = 0; k < Dimensions; ++k) jacobian[j][k] = nextJacobian[j][k];
+		}
+	}
+
+	n = this->field.noise(warped, fieldGradient);
+
+	// Chain rule through the warp
+	for (k = 0; k < Dimensions; ++k) {
+		derivative[k] = 0;
+		for (j = 0; j < Dimensions; ++j) derivative[k] += fieldGradient[j] * jacobian[j][k];
+	}
+
+	return n;
+}
+
+template <typename Float, int Dimensions>
+void
+SimplexNoiseWarp<Float, Dimensions> :: noise_batch(
+	CountInt count,
+	const Float* const* coordinates,
+	Float* out
+) {
+	assert(count == 0 || coordinates != nullptr);
+	assert(count == 0 || out != nullptr);
+
+	// Per-block scratch
+	Float warped[Dimensions][batchSize];
+	Float shifted[Dimensions][batchSize];
+	Float displacement[Dimensions][batchSize];
+	const Float* warpedPointers[Dimensions];
+	const Float* shiftedPointers[Dimensions];
+	CountInt offset, i, n;
+	unsigned int d;
+	int j, k;
+
+	for (k = 0; k < Dimensions; ++k) {
+		warpedPointers[k] = warped[k];
+		shiftedPointers[k] = shifted[k];
+	}
+
+	for (offset = 0; offset < count; offset += n) {
+		n = (count - offset < batchSize) ? count - offset : batchSize;
+
+		for (k = 0; k < Dimensions; ++k) {
+			for (i = 0; i < n; ++i) warped[k][i] = coordinates[k][offset + i];
+		}
+
+		for (d = 0; d < this->depth; ++d) {
+			for (j = 0; j < Dimensions; ++j) {
+				for (k = 0; k < Dimensions; ++k) {
+					for (i = 0; i < n; ++i) shifted[k][i] = warped[k][i] + componentOffsets[j][k];
+				}
+				this->warp.noise_batch(n, shiftedPointers, displacement[j]);
+			}
+
+			for (k = 0; k < Dimensions; ++k) {
+				for (i = 0; i < n; ++i) warped[k][i] = coordinates[k][offset + i] + this->amplitude * displacement[k][i];
+			}
+		}
+
+		this->field.noise_batch(n, warpedPointers, out + offset);
+	}
+}
+
+
+
@@ -1,5 +1,6 @@
 #include <cassert>
 #include <limits>
+#include <cstdint>
 
 
 
@@ -4,9 +4,10 @@
 ::   mode = "r" | ...
 ::     "r" = release
 ::     ... = debug
-::   test = "test" | ...
-::     "test" = perform the default test
-::     ...    = do nothing
+::   test = "test" | "check" | ...
+::     "test"  = perform the default test
+::     "check" = compare small images against the reference images
+::     ...     = do nothing
 
 
 :: Include paths
@@ -58,6 +59,15 @@ if a"%2"==a"test" (
 	call :test 4 0 5
 	call :test 4 3 5
 )
+if a"%2"==a"check" (
+	echo Checking
+	call :check 3 3 0
+	call :check 2 0 5
+	call :check 3 0 5
+	call :check 3 1 5
+	call :check 3 2 5
+	call :check 4 3 5
+)
 
 
 goto :eof
@@ -66,7 +76,7 @@ goto :eof
 :: Debug building
 :build_debug
 set EXE=%1
-g++ -Wall -O0 -g -std=c++11 -I"%INCLUDE_PATH%" -o %EXE% test.cpp "%INCLUDE_PATH%\SimplexNoise.cpp" || exit /b 1
+g++ -Wall -O0 -g -std=c++11 -I"%INCLUDE_PATH%" -o %EXE% test.cpp "%INCLUDE_PATH%\SimplexNoise.cpp" "%INCLUDE_PATH%\SimplexNoiseSimd.cpp" "%INCLUDE_PATH%\SimplexNoiseThreadPool.cpp" "%INCLUDE_PATH%\SimplexNoiseImageWriter.cpp" || exit /b 1
 
 goto :eof
 
@@ -74,13 +84,24 @@ goto :eof
 :: Release building
 :build_release
 set EXE=%1
-g++ -Wall -O3 -DNDEBUG=1 -DSIMPLEX_NOISE_FAST_MATH=1 -std=c++11 -I"%INCLUDE_PATH%" -o %EXE% test.cpp "%INCLUDE_PATH%\SimplexNoise.cpp" || exit /b 1
+g++ -Wall -O3 -DNDEBUG=1 -DSIMPLEX_NOISE_FAST_MATH=1 -std=c++11 -I"%INCLUDE_PATH%" -o %EXE% test.cpp "%INCLUDE_PATH%\SimplexNoise.cpp" "%INCLUDE_PATH%\SimplexNoiseSimd.cpp" "%INCLUDE_PATH%\SimplexNoiseThreadPool.cpp" "%INCLUDE_PATH%\SimplexNoiseImageWriter.cpp" || exit /b 1
 
 goto :eof
 
 
 :: Test image
 :test
+call :filename %1 %2 %3
+
+echo %DIM%D image, %OCT% octaves%DER_NAME_FULL%
+
+%EXE% "images\%FILENAME%" 512 512 0.02 %DIM% %OCT% %DER%
+
+goto :eof
+
+
+:: Image filename
+:filename
 set DIM=%1
 set DER=%2
 set OCT=%3
@@ -98,9 +119,20 @@ if %OCT%==0 (
 )
 set FILENAME=test%DIM%d%OCT_NAME%%DER_NAME%.pgm
 
-echo %DIM%D image, %OCT% octaves%DER_NAME_FULL%
+goto :eof
 
-%EXE% "images\%FILENAME%" 512 512 0.02 %DIM% %OCT% %DER%
+
+:: Reference image comparison; the images in reference\ were generated by the original per-pixel writer
+:check
+call :filename %1 %2 %3
+
+%EXE% "%TEMP%\%FILENAME%" 128 128 0.08 %DIM% %OCT% %DER% > NUL
+fc /b "%TEMP%\%FILENAME%" "reference\%FILENAME%" > NUL && (
+	echo %FILENAME%: identical
+) || (
+	echo %FILENAME%: DIFFERENT
+)
+del "%TEMP%\%FILENAME%" > NUL 2> NUL
 
 goto :eof
 
@@ -1,8 +1,10 @@
 #include <iostream>
-#include <fstream>
 #include <cstdlib>
+#include <cstring>
 
 #include "SimplexNoise.hpp"
+#include "SimplexNoiseImage.hpp"
+#include "SimplexNoiseImageWriter.hpp"
 
 using namespace std;
 
@@ -12,7 +14,7 @@ int main(int argc, char** argv) {
 	// Usage
 	if (argc <= 7) {
 		cout << "Usage:" << endl;
-		cout << "  " << argv[0] << " filename width height scale dimensions octaves derivative" << endl;
+		cout << "  " << argv[0] << " filename width height scale dimensions octaves derivative [threads]" << endl;
 		return -1;
 	}
 
@@ -25,6 +27,7 @@ int main(int argc, char** argv) {
 	int dimensions = atoi(argv[5]);
 	int octaves = atoi(argv[6]);
 	int derivative = atoi(argv[7]);
+	int threads = (argc > 8) ? atoi(argv[8]) : 0;
 
 	if (dimensions < 1) dimensions = 1;
 	else if (dimensions > 4) dimensions = 4;
@@ -33,75 +36,76 @@ int main(int argc, char** argv) {
 	if (derivative < 0) derivative = 0;
 	else if (derivative > dimensions) derivative = dimensions;
 	if (octaves < 0) octaves = 0;
+	if (threads < 0) threads = 0;
 
-	fstream out(filename, fstream::out | fstream::binary);
-	if (!out.is_open()) {
+	// Output format; .pfm files get the raw values
+	size_t filenameLength = strlen(filename);
+	SimplexNoiseImageWriter::Format format = SimplexNoiseImageWriter::Format::Gray8;
+	if (filenameLength >= 4 && strcmp(filename + filenameLength - 4, ".pfm") == 0) {
+		format = SimplexNoiseImageWriter::Format::Float32;
+	}
+
+	SimplexNoiseImageWriter out;
+	if (!out.open(filename, format, width, height)) {
 		cerr << "Failed to open output file" << endl;
 		return -2;
 	}
 
-	double* values = new double[width * height];
-	double* v = values;
-	double noise[5];
-
 
 	// Create noise
-	bool first = true;
-	double n;
-	double min = 0.0, max = 0.0;
 	SimplexNoise<double> generator;
-
-	for (int y = 0; y < height; ++y) {
-		for (int x = 0; x < width; ++x) {
-			switch (dimensions) {
-				case 1:
-					if (octaves == 0) {
-						noise[0] = generator.noise1(x * scale, &noise[1]);
-					}
-					else {
-						noise[0] = generator.noise1_octaves(octaves, x * scale, &noise[1]);
-					}
-				break;
-				case 2:
-					if (octaves == 0) {
-						noise[0] = generator.noise2(x * scale, y * scale, &noise[1], &noise[2]);
-					}
-					else {
-						noise[0] = generator.noise2_octaves(octaves, x * scale, y * scale, &noise[1], &noise[2]);
-					}
-				break;
-				case 3:
-					if (octaves == 0) {
-						noise[0] = generator.noise3(x * scale, y * scale, 0.0, &noise[1], &noise[2], &noise[3]);
-					}
-					else {
-						noise[0] = generator.noise3_octaves(octaves, x * scale, y * scale, 0.0, &noise[1], &noise[2], &noise[3]);
-					}
-				break;
-				case 4:
-					if (octaves == 0) {
-						noise[0] = generator.noise4(x * scale, y * scale, 0.0, 0.0, &noise[1], &noise[2], &noise[3], &noise[4]);
-					}
-					else {
-						noise[0] = generator.noise4_octaves(octaves, x * scale, y * scale, 0.0, 0.0, &noise[1], &noise[2], &noise[3], &noise[4]);
-					}
-				break;
-			}
-
-			n = noise[derivative];
-			*(v++) = n;
-
-			if (first) {
-				min = n;
-				max = n;
-				first = false;
-			}
-			else {
-				if (n < min) min = n;
-				if (n > max) max = n;
+	SimplexNoiseImage<double> image(width, height);
+	SimplexNoiseThreadPool pool(threads);
+
+	image.generate(pool, [&] (size_t x0, size_t y0, size_t w, size_t h, double* v, size_t stride, unsigned int) {
+		double noise[5];
+
+		for (size_t j = 0; j < h; ++j) {
+			int y = static_cast<int>(y0 + j);
+			for (size_t i = 0; i < w; ++i) {
+				int x = static_cast<int>(x0 + i);
+				switch (dimensions) {
+					case 1:
+						if (octaves == 0) {
+							noise[0] = generator.noise1(x * scale, &noise[1]);
+						}
+						else {
+							noise[0] = generator.noise1_octaves(octaves, x * scale, &noise[1]);
+						}
+					break;
+					case 2:
+						if (octaves == 0) {
+							noise[0] = generator.noise2(x * scale, y * scale, &noise[1], &noise[2]);
+						}
+						else {
+							noise[0] = generator.noise2_octaves(octaves, x * scale, y * scale, &noise[1], &noise[2]);
+						}
+					break;
+					case 3:
+						if (octaves == 0) {
+							noise[0] = generator.noise3(x * scale, y * scale, 0.0, &noise[1], &noise[2], &noise[3]);
+						}
+						else {
+							noise[0] = generator.noise3_octaves(octaves, x * scale, y * scale, 0.0, &noise[1], &noise[2], &noise[3]);
+						}
+					break;
+					case 4:
+						if (octaves == 0) {
+							noise[0] = generator.noise4(x * scale, y * scale, 0.0, 0.0, &noise[1], &noise[2], &noise[3], &noise[4]);
+						}
+						else {
+							noise[0] = generator.noise4_octaves(octaves, x * scale, y * scale, 0.0, 0.0, &noise[1], &noise[2], &noise[3], &noise[4]);
+						}
+					break;
+				}
+
+				v[j * stride + i] = noise[derivative];
 			}
 		}
-	}
+	});
+
+	double min = image.getMinimum();
+	double max = image.getMaximum();
 
 
 	// Range output
@@ -109,21 +113,13 @@ int main(int argc, char** argv) {
 	cout << "Min = " << min << endl;
 	cout << "Max = " << max << endl;
 	if (-min > max) max = -min;
-	max *= 2.0;
-
 
-	// Header
-	out << "P5" << "\n";
-	out << width << " " << height << "\n";
-	out << "255" << "\n";
 
 	// Body
-	v = values;
-	int px;
-	for (int i = 0, j = width * height; i < j; ++i) {
-		n = 0.5 + *(v++) / max;
-		px = static_cast<int>(n * 255 + 0.5);
-		out << static_cast<char>(px);
+	out.setSymmetricRange(max);
+	if (!out.writeImage(image.getValues(), width) || !out.close()) {
+		cerr << "Failed to write output file" << endl;
+		return -3;
 	}
 
 
@@ -0,0 +1,58 @@
+@echo off
+:: Usage:
+:: build [mode] [test]
+::   mode = "r" | ...
+::     "r" = release
+::     ... = debug
+::   test = "test" | ...
+::     "test" = perform the default test
+::     ...    = do nothing
+
+
+:: Include paths
+pushd "..\src"
+set INCLUDE_PATH=%CD%
+popd
+
+
+:: Build mode
+if a"%1"==a"r" (
+	echo Building release
+	call :build_release validate || goto :eof
+) else (
+	echo Building debug
+	call :build_debug validate-debug || goto :eof
+)
+
+
+:: Test
+if a"%2"==a"test" (
+	echo Testing
+	call :test
+)
+
+
+goto :eof
+
+
+:: Debug building
+:build_debug
+set EXE=%1
+g++ -Wall -O0 -g -std=c++11 -I"%INCLUDE_PATH%" -o %EXE% validate.cpp "%INCLUDE_PATH%\SimplexNoise.cpp" "%INCLUDE_PATH%\SimplexNoiseSimd.cpp" || exit /b 1
+
+goto :eof
+
+
+:: Release building
+:build_release
+set EXE=%1
+g++ -Wall -O3 -DNDEBUG=1 -DSIMPLEX_NOISE_FAST_MATH=1 -std=c++11 -I"%INCLUDE_PATH%" -o %EXE% validate.cpp "%INCLUDE_PATH%\SimplexNoise.cpp" "%INCLUDE_PATH%\SimplexNoiseSimd.cpp" || exit /b 1
+
+goto :eof
+
+
+:: Float against double
+:test
+%EXE% 1048576 > validate.txt
+
+goto :eof
@@ -0,0 +1,351 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cmath>
+#include <cfloat>
+#include <vector>
+#include <random>
+
+#include "SimplexNoise.hpp"
+
+using namespace std;
+
+
+
+// Validates SimplexNoise<float> against SimplexNoise<double>; both are evaluated at the same float coordinates,
+// so the differences are only caused by float arithmetic.
+// The error of a check is reported relative to (1 + range) * FLT_EPSILON, where range is the largest coordinate
+// magnitude of its sample set: the relative distances from the lattice are computed from the absolute coordinates,
+// so their rounding error grows with them.
+enum class Check {
+	Noise1,
+	Noise2,
+	Noise3,
+	Noise4,
+	Noise2Derivative,
+	Noise3Derivative,
+	Noise4Derivative,
+	Noise2Octaves,
+	Noise3Octaves,
+	Noise4Octaves,
+	Noise2Batch,
+	Noise3Batch,
+	Noise4Batch,
+	Noise2GradientBatch,
+	Noise3GradientBatch,
+	Noise4GradientBatch,
+	Curl3Batch,
+	FillGrid2,
+	FillGrid3,
+	FillGrid4,
+	Noise2PeriodicBatch,
+	Noise3PeriodicBatch,
+	Noise2ChunkBatch,
+	Noise3ChunkBatch,
+	Noise4ChunkBatch,
+	Count,
+};
+
+struct CheckInfo {
+	const char* name;
+	int dimensions;
+	int values; // Per point; all values after the first one are derivatives
+};
+
+static const CheckInfo checkInfos[] = {
+	{ "noise1", 1, 1 },
+	{ "noise2", 2, 1 },
+	{ "noise3", 3, 1 },
+	{ "noise4", 4, 1 },
+	{ "noise2 derivative", 2, 3 },
+	{ "noise3 derivative", 3, 4 },
+	{ "noise4 derivative", 4, 5 },
+	{ "noise2_octaves", 2, 1 },
+	{ "noise3_octaves", 3, 1 },
+	{ "noise4_octaves", 4, 1 },
+	{ "noise2_batch", 2, 1 },
+	{ "noise3_batch", 3, 1 },
+	{ "noise4_batch", 4, 1 },
+	{ "noise2_gradient_batch", 2, 3 },
+	{ "noise3_gradient_batch", 3, 4 },
+	{ "noise4_gradient_batch", 4, 5 },
+	{ "curl3_batch", 3, 3 },
+	{ "fill_grid2", 2, 1 },
+	{ "fill_grid3", 3, 1 },
+	{ "fill_grid4", 4, 1 },
+	{ "noise2_periodic_batch", 2, 1 },
+	{ "noise3_periodic_batch", 3, 1 },
+	{ "noise2_chunk_batch", 2, 1 },
+	{ "noise3_chunk_batch", 3, 1 },
+	{ "noise4_chunk_batch", 4, 1 },
+};
+
+struct SampleSet {
+	const char* name;
+	double range;
+	bool grid;
+};
+
+static const SampleSet sampleSets[] = {
+	{ "random 1", 1.0, false },
+	{ "random 16", 16.0, false },
+	{ "random 256", 256.0, false },
+	{ "random 4096", 4096.0, false },
+	{ "grid 64", 64.0, true },
+};
+
+// Tolerances, in units of (1 + range) * FLT_EPSILON
+static const double valueTolerance = 16.0;
+static const double derivativeTolerance = 64.0;
+
+static const unsigned int octaves = 4;
+static const int32_t periods[3] = { 16, 32, 8 };
+static const double maxPeriod = 32.0;
+static const int64_t chunkOrigin[4] = { (INT64_C(1) << 40) + 12345, -(INT64_C(1) << 37) - 678, INT64_C(987654321987), -INT64_C(55555555555) };
+static const double chunkSize = 64.0;
+
+
+
+// Fills out[i * values + v] with the value v of point i
+template <typename Float>
+static void
+evaluate(
+	SimplexNoise<Float>& generator,
+	Check check,
+	size_t count,
+	const Float* const* coordinates,
+	size_t gridWidth,
+	Float gridStep,
+	Float* out
+) {
+	const Float* x = coordinates[0];
+	const Float* y = coordinates[1];
+	const Float* z = coordinates[2];
+	const Float* w = coordinates[3];
+	size_t i, j;
+
+	switch (check) {
+		case Check::Noise1:
+			for (i = 0; i < count; ++i) out[i] = generator.noise1(x[i]);
+		break;
+		case Check::Noise2:
+			for (i = 0; i < count; ++i) out[i] = generator.noise2(x[i], y[i]);
+		break;
+		case Check::Noise3:
+			for (i = 0; i < count; ++i) out[i] = generator.noise3(x[i], y[i], z[i]);
+		break;
+		case Check::Noise4:
+			for (i = 0; i < count; ++i) out[i] = generator.noise4(x[i], y[i], z[i], w[i]);
+		break;
+		case Check::Noise2Derivative:
+			for (i = 0; i < count; ++i) {
+				out[i * 3] = generator.noise2(x[i], y[i], &out[i * 3 + 1], &out[i * 3 + 2]);
+			}
+		break;
+		case Check::Noise3Derivative:
+			for (i = 0; i < count; ++i) {
+				out[i * 4] = generator.noise3(x[i], y[i], z[i], &out[i * 4 + 1], &out[i * 4 + 2], &out[i * 4 + 3]);
+			}
+		break;
+		case Check::Noise4Derivative:
+			for (i = 0; i < count; ++i) {
+				out[i * 5] = generator.noise4(x[i], y[i], z[i], w[i], &out[i * 5 + 1], &out[i * 5 + 2], &out[i * 5 + 3], &out[i * 5 + 4]);
+			}
+		break;
+		case Check::Noise2Octaves:
+			for (i = 0; i < count; ++i) out[i] = generator.noise2_octaves(octaves, x[i], y[i]);
+		break;
+		case Check::Noise3Octaves:
+			for (i = 0; i < count; ++i) out[i] = generator.noise3_octaves(octaves, x[i], y[i], z[i]);
+		break;
+		case Check::Noise4Octaves:
+			for (i = 0; i < count; ++i) out[i] = generator.noise4_octaves(octaves, x[i], y[i], z[i], w[i]);
+		break;
+		case Check::Noise2Batch:
+			generator.noise2_batch(count, x, y, out);
+		break;
+		case Check::Noise3Batch:
+			generator.noise3_batch(count, x, y, z, out);
+		break;
+		case Check::Noise4Batch:
+			generator.noise4_batch(count, x, y, z, w, out);
+		break;
+		case Check::Noise2GradientBatch:
+			generator.noise2_gradient_batch(count, x, y, out, 3, 1);
+		break;
+		case Check::Noise3GradientBatch:
+			generator.noise3_gradient_batch(count, x, y, z, out, 4, 1);
+		break;
+		case Check::Noise4GradientBatch:
+			generator.noise4_gradient_batch(count, x, y, z, w, out, 5, 1);
+		break;
+		case Check::Curl3Batch:
+			generator.curl3_batch(count, x, y, z, out, 3, 1);
+		break;
+		case Check::FillGrid2:
+		case Check::FillGrid3:
+		case Check::FillGrid4:
+			// Rows of gridWidth points starting at each point's x,y; the remaining coordinates are per row
+			for (j = 0; j < count; j += gridWidth) {
+				if (check == Check::FillGrid2) generator.fill_grid2(x[j], y[j], gridStep, gridStep, gridWidth, 1, out + j, gridWidth);
+				else if (check == Check::FillGrid3) generator.fill_grid3(x[j], y[j], z[j], gridStep, gridStep, gridWidth, 1, out + j, gridWidth);
+				else generator.fill_grid4(x[j], y[j], z[j], w[j], gridStep, gridStep, gridWidth, 1, out + j, gridWidth);
+			}
+		break;
+		case Check::Noise2PeriodicBatch:
+			generator.noise2_periodic_batch(count, x, y, periods[0], periods[1], out);
+		break;
+		case Check::Noise3PeriodicBatch:
+			generator.noise3_periodic_batch(count, x, y, z, periods[0], periods[1], periods[2], out);
+		break;
+		case Check::Noise2ChunkBatch:
+			generator.noise2_chunk_batch(chunkOrigin[0], chunkOrigin[1], count, x, y, out);
+		break;
+		case Check::Noise3ChunkBatch:
+			generator.noise3_chunk_batch(chunkOrigin[0], chunkOrigin[1], chunkOrigin[2], count, x, y, z, out);
+		break;
+		case Check::Noise4ChunkBatch:
+			generator.noise4_chunk_batch(chunkOrigin[0], chunkOrigin[1], chunkOrigin[2], chunkOrigin[3], count, x, y, z, w, out);
+		break;
+		default:
+		break;
+	}
+}
+
+static bool
+isChunk(
+	Check check
+) {
+	return check == Check::Noise2ChunkBatch || check == Check::Noise3ChunkBatch || check == Check::Noise4ChunkBatch;
+}
+
+static bool
+isPeriodic(
+	Check check
+) {
+	return check == Check::Noise2PeriodicBatch || check == Check::Noise3PeriodicBatch;
+}
+
+static bool
+isFillGrid(
+	Check check
+) {
+	return check == Check::FillGrid2 || check == Check::FillGrid3 || check == Check::FillGrid4;
+}
+
+
+
+int main(int argc, char** argv) {
+	// Usage
+	if (argc > 1 && (argv[1][0] < '0' || argv[1][0] > '9')) {
+		cout << "Usage:" << endl;
+		cout << "  " << argv[0] << " [samples] [seed]" << endl;
+		return -1;
+	}
+
+
+	// Arguments
+	const size_t gridWidth = 64;
+	size_t samples = (argc > 1) ? static_cast<size_t>(atol(argv[1])) : (1 << 18);
+	uint64_t seed = (argc > 2) ? static_cast<uint64_t>(atoll(argv[2])) : 0;
+	samples = (samples + gridWidth - 1) / gridWidth * gridWidth;
+	if (samples == 0) samples = gridWidth;
+
+
+	// Buffers
+	vector<float> coordinates[4];
+	vector<double> coordinatesDouble[4];
+	vector<float> out(samples * 5);
+	vector<double> outDouble(samples * 5);
+	const float* coordinatePointers[4];
+	const double* coordinatePointersDouble[4];
+	for (int k = 0; k < 4; ++k) {
+		coordinates[k].resize(samples);
+		coordinatesDouble[k].resize(samples);
+		coordinatePointers[k] = coordinates[k].data();
+		coordinatePointersDouble[k] = coordinatesDouble[k].data();
+	}
+
+	SimplexNoise<float> generator;
+	SimplexNoise<double> generatorDouble;
+	bool passed = true;
+
+
+	// Checks
+	printf("%-22s %-12s %12s %12s %10s %10s\n", "check", "samples", "max error", "mean error", "value", "derivative");
+
+	for (int c = 0; c < static_cast<int>(Check::Count); ++c) {
+		Check check = static_cast<Check>(c);
+		const CheckInfo& info = checkInfos[c];
+
+		for (const SampleSet& set : sampleSets) {
+			// The chunk checks use local coordinates within a chunk, and fill_grid only needs row starts
+			double range = isChunk(check) ? chunkSize : set.range;
+			float gridStep = static_cast<float>(set.grid ? 0.0625 : range / 512.0);
+			mt19937_64 random(seed + c);
+			uniform_real_distribution<double> distribution(isChunk(check) ? 0.0 : -range, range);
+			size_t side = static_cast<size_t>(::ceil(::pow(static_cast<double>(samples), 1.0 / info.dimensions)));
+			size_t i, index;
+
+			for (i = 0; i < samples; ++i) {
+				index = i;
+				for (int k = 0; k < 4; ++k) {
+					float v;
+					if (set.grid) {
+						// Regular lattice with a power of two step, so that it's exact in float
+						v = static_cast<float>((index % side) * 0.0625 - (isChunk(check) ? 0.0 : range / 2));
+						index /= side;
+					}
+					else {
+						v = static_cast<float>(distribution(random));
+					}
+					coordinates[k][i] = v;
+					coordinatesDouble[k][i] = v;
+				}
+			}
+			// The magnitude of the evaluated coordinates: fill_grid steps away from the row starts,
+			// and the periodic variants wrap the coordinates into the first period
+			if (isFillGrid(check)) range += gridStep * gridWidth;
+			if (isPeriodic(check)) range = maxPeriod;
+
+			evaluate<float>(generator, check, samples, coordinatePointers, gridWidth, gridStep, out.data());
+			evaluate<double>(generatorDouble, check, samples, coordinatePointersDouble, gridWidth, gridStep, outDouble.data());
+
+			// Compare
+			double maxError[2] = { 0.0, 0.0 };
+			double sumError = 0.0;
+			double error;
+			size_t n = samples * info.values;
+			for (i = 0; i < n; ++i) {
+				error = ::fabs(static_cast<double>(out[i]) - outDouble[i]);
+				if (!(error <= maxError[(i % info.values) != 0])) maxError[(i % info.values) != 0] = error; // NaN is always the maximum
+				sumError += error;
+			}
+
+			// The curl's components are all derivatives
+			bool curl = (check == Check::Curl3Batch);
+			double scale = (1.0 + range) * FLT_EPSILON;
+			double valueRatio = (curl ? 0.0 : maxError[0] / scale);
+			double derivativeRatio = (curl ? maxError[0] : maxError[1]) / scale;
+			bool ok = (valueRatio <= valueTolerance && derivativeRatio <= derivativeTolerance);
+			passed = passed && ok;
+
+			printf(
+				"%-22s %-12s %12.4g %12.4g %10.2f %10.2f%s\n",
+				info.name,
+				set.name,
+				curl ? maxError[0] : ::fmax(maxError[0], maxError[1]),
+				sumError / n,
+				valueRatio,
+				derivativeRatio,
+				ok ? "" : "  FAILED"
+			);
+		}
+	}
+
+
+	// Done
+	printf("%s\n", passed ? "All checks passed" : "Some checks FAILED");
+	return passed ? 0 : 1;
+}